@@ -7,12 +7,15 @@ function(set_models_src src_list)
     ${THERMCORE_SOURCE_DIR}/gas_parameters/gas_description_dynamic.cpp
     ${THERMCORE_SOURCE_DIR}/gas_parameters/gas_description_static.cpp
     ${THERMCORE_SOURCE_DIR}/gas_parameters/gas_ng_gost30319.cpp
+    ${THERMCORE_SOURCE_DIR}/gas_parameters/gas_ng_gost30319_table.cpp
     ${THERMCORE_SOURCE_DIR}/gas_parameters/gas_ng_gost56851.cpp
     ${THERMCORE_SOURCE_DIR}/gas_parameters/gas_ng_gost_defines.cpp
     ${THERMCORE_SOURCE_DIR}/gas_parameters/gas_description_mix.cpp
     # phase_diagram sources
+    ${THERMCORE_SOURCE_DIR}/phase_diagram/binodal_table.cpp
     ${THERMCORE_SOURCE_DIR}/phase_diagram/phase_diagram.cpp
     ${THERMCORE_SOURCE_DIR}/phase_diagram/phase_diagram_models.cpp
+    ${THERMCORE_SOURCE_DIR}/phase_diagram/phase_equilibrium.cpp
     # subroutins sources
     ${THERMCORE_SOURCE_DIR}/subroutins/file_structs.cpp
     # service sources
@@ -0,0 +1,130 @@
+/**
+ * asp_therm - implementation of real gas equations of state
+ *
+ *
+ * Copyright (c) 2020-2021 Mishutinski Yurii
+ *
+ * This library is distributed under the MIT License.
+ * See LICENSE file in the project root for full license information.
+ */
+#ifndef _CORE__COMMON__DUAL_NUMBER_H_
+#define _CORE__COMMON__DUAL_NUMBER_H_
+
+#include <array>
+#include <cmath>
+
+#include <stddef.h>
+
+/**
+ * \brief Дуальное число прямого режима автоматического
+ *   дифференцирования: значение и производные по N независимым
+ *   переменным
+ *
+ * Шаблонное ядро расчёта, вызванное с dual<N> вместо double, за один
+ *   проход даёт значение и точный градиент. В шаблонном коде
+ *   элементарные функции вызываются без квалификатора std::
+ *   (`using std::sqrt; sqrt(x)`), чтобы перегрузки для dual находились
+ *   по ADL
+ * */
+template <size_t N>
+struct dual {
+  /// значение
+  double v;
+  /// производные по независимым переменным
+  std::array<double, N> d;
+
+  dual() : v(0.0), d() {}
+  /* неявное преобразование из double: константа */
+  dual(double value) : v(value), d() {}
+
+  /**
+   * \brief Независимая переменная с номером i < N
+   * */
+  static dual Variable(double value, size_t i) {
+    dual x(value);
+    x.d[i] = 1.0;
+    return x;
+  }
+
+  dual& operator+=(const dual& r) {
+    v += r.v;
+    for (size_t i = 0; i < N; ++i)
+      d[i] += r.d[i];
+    return *this;
+  }
+  dual& operator-=(const dual& r) {
+    v -= r.v;
+    for (size_t i = 0; i < N; ++i)
+      d[i] -= r.d[i];
+    return *this;
+  }
+  dual& operator*=(const dual& r) {
+    for (size_t i = 0; i < N; ++i)
+      d[i] = d[i] * r.v + v * r.d[i];
+    v *= r.v;
+    return *this;
+  }
+  dual& operator/=(const dual& r) {
+    const double inv = 1.0 / r.v;
+    v *= inv;
+    for (size_t i = 0; i < N; ++i)
+      d[i] = (d[i] - v * r.d[i]) * inv;
+    return *this;
+  }
+
+  friend dual operator-(dual x) {
+    x.v = -x.v;
+    for (size_t i = 0; i < N; ++i)
+      x.d[i] = -x.d[i];
+    return x;
+  }
+  friend dual operator+(dual l, const dual& r) { return l += r; }
+  friend dual operator-(dual l, const dual& r) { return l -= r; }
+  friend dual operator*(dual l, const dual& r) { return l *= r; }
+  friend dual operator/(dual l, const dual& r) { return l /= r; }
+
+  friend bool operator<(const dual& l, const dual& r) { return l.v < r.v; }
+  friend bool operator>(const dual& l, const dual& r) { return l.v > r.v; }
+  friend bool operator<=(const dual& l, const dual& r) { return l.v <= r.v; }
+  friend bool operator>=(const dual& l, const dual& r) { return l.v >= r.v; }
+  friend bool operator==(const dual& l, const dual& r) { return l.v == r.v; }
+  friend bool operator!=(const dual& l, const dual& r) { return l.v != r.v; }
+
+  /* элементарные функции, f(x) + f'(x) * dx */
+  friend dual sqrt(const dual& x) {
+    const double s = std::sqrt(x.v);
+    return chain(x, s, 0.5 / s);
+  }
+  friend dual exp(const dual& x) {
+    const double e = std::exp(x.v);
+    return chain(x, e, e);
+  }
+  friend dual log(const dual& x) { return chain(x, std::log(x.v), 1.0 / x.v); }
+  friend dual pow(const dual& x, double n) {
+    const double p = std::pow(x.v, n - 1.0);
+    return chain(x, p * x.v, n * p);
+  }
+  friend dual abs(const dual& x) { return (x.v < 0.0) ? -x : x; }
+  friend bool isfinite(const dual& x) { return std::isfinite(x.v); }
+
+ private:
+  static dual chain(const dual& x, double f, double df) {
+    dual r(f);
+    for (size_t i = 0; i < N; ++i)
+      r.d[i] = df * x.d[i];
+    return r;
+  }
+};
+
+/**
+ * \brief Значение скалярной величины без производных
+ * */
+inline double value_of(double x) {
+  return x;
+}
+template <size_t N>
+double value_of(const dual<N>& x) {
+  return x.v;
+}
+
+#endif  // !_CORE__COMMON__DUAL_NUMBER_H_
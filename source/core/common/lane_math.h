@@ -0,0 +1,252 @@
+/**
+ * asp_therm - implementation of real gas equations of state
+ *
+ *
+ * Copyright (c) 2020-2021 Mishutinski Yurii
+ *
+ * This library is distributed under the MIT License.
+ * See LICENSE file in the project root for full license information.
+ */
+#ifndef _CORE__COMMON__LANE_MATH_H_
+#define _CORE__COMMON__LANE_MATH_H_
+
+#include <stdint.h>
+#include <string.h>
+
+/*
+ * Функции для расчёта одних и тех же формул сразу для нескольких
+ *   точек("дорожек", lanes). Расчёт для блока точек записывается
+ *   циклом `for (size_t l = 0; l < ATHERM_LANES; ++l)` без ветвлений
+ *   и вызовов libm, такой цикл компилятор векторизует: ветвление
+ *   заменяется выбором `cond ? a : b` между уже рассчитанными
+ *   значениями, а функции ниже - многочлены и операции с битами
+ *   double.
+ *
+ * Функции, содержащие такие циклы, отмечаются ATHERM_LANES_TARGETS:
+ *   для x86-64 GCC/Clang собирают версии для AVX-512, AVX2 и
+ *   базового SSE2 и выбирают подходящую процессору при загрузке
+ *   программы. Версия AVX-512 использует FMA, поэтому результаты
+ *   версий совпадают с точностью до округления.
+ *
+ * Точность функций - несколько ulp во всём диапазоне аргументов,
+ *   см. описание каждой функции
+ */
+
+/** \brief Число точек в блоке, 8 double - один регистр AVX-512 */
+#define ATHERM_LANES 8
+
+#if defined(__GNUC__) && defined(__x86_64__) && defined(__linux__) \
+    && !defined(__INTEL_COMPILER)
+#define ATHERM_LANES_TARGETS \
+  __attribute__((target_clones("avx512f", "avx2", "default")))
+#else
+#define ATHERM_LANES_TARGETS
+#endif
+
+/**
+ * \brief Экспонента, относительная погрешность < 3e-16
+ * \note Аргумент должен лежать в интервале [-708, 709], в котором
+ *   результат - нормализованное число. Ограничение аргумента внутри
+ *   функции мешает векторизации(компилятор разделяет расчёт на ветви
+ *   для граничных значений), поэтому при необходимости аргумент
+ *   ограничивается вызывающим кодом отдельным циклом
+ * */
+inline double LaneExp(double x) {
+  // n = round(x / ln2): после прибавления 1.5 * 2^52 младшие биты
+  //   мантиссы содержат n в дополнительном коде
+  const double shift = 6755399441055744.0;
+  double n = x * 1.4426950408889634 + shift;
+  uint64_t bits;
+  memcpy(&bits, &n, sizeof(bits));
+  n -= shift;
+  // ln2 = ln2_hi + ln2_lo, n * ln2_hi точно, |r| <= ln2 / 2
+  const double r =
+      (x - n * 6.93147180369123816490e-01) - n * 1.90821492927058770002e-10;
+  // ряд Тейлора до r^13, остаток < 5e-18
+  double p = 1.0 / 6227020800.0;
+  p = p * r + 1.0 / 479001600.0;
+  p = p * r + 1.0 / 39916800.0;
+  p = p * r + 1.0 / 3628800.0;
+  p = p * r + 1.0 / 362880.0;
+  p = p * r + 1.0 / 40320.0;
+  p = p * r + 1.0 / 5040.0;
+  p = p * r + 1.0 / 720.0;
+  p = p * r + 1.0 / 120.0;
+  p = p * r + 1.0 / 24.0;
+  p = p * r + 1.0 / 6.0;
+  p = p * r + 0.5;
+  p = p * r + 1.0;
+  p = p * r + 1.0;
+  // 2^n: смещённый порядок n + 1023
+  bits = (bits << 52) + 0x3ff0000000000000ULL;
+  double scale;
+  memcpy(&scale, &bits, sizeof(scale));
+  return p * scale;
+}
+
+/**
+ * \brief Натуральный логарифм нормализованного положительного
+ *   числа, абсолютная погрешность < 4e-16 * max(1, |ln(x)|)
+ * */
+inline double LaneLog(double x) {
+  /* x = m * 2^e, m в [sqrt(1/2), sqrt(2)): мантисса больше мантиссы
+   *   sqrt(2) переносится в [1/2, 1) с увеличением порядка на 1.
+   *   Выбор делается целочисленно, без ветвлений */
+  uint64_t bits;
+  memcpy(&bits, &x, sizeof(bits));
+  const uint64_t mant = bits & 0x000fffffffffffffULL;
+  const uint64_t big = (0x0006a09e667f3bcdULL - mant) >> 63;
+  const uint64_t m_bits = mant | (0x3ff0000000000000ULL - (big << 52)),
+                 e_bits = 0x4330000000000000ULL | ((bits >> 52) + big);
+  double m, e;
+  memcpy(&m, &m_bits, sizeof(m));
+  memcpy(&e, &e_bits, sizeof(e));
+  // e - несмещённый порядок
+  e = e - 4503599627370496.0 - 1023.0;
+  // ln(m) = 2 * atanh(s) = 2 * (s + s^3 / 3 + ...), |s| < 0.172
+  const double s = (m - 1.0) / (m + 1.0), s2 = s * s;
+  double q = 1.0 / 21.0;
+  q = q * s2 + 1.0 / 19.0;
+  q = q * s2 + 1.0 / 17.0;
+  q = q * s2 + 1.0 / 15.0;
+  q = q * s2 + 1.0 / 13.0;
+  q = q * s2 + 1.0 / 11.0;
+  q = q * s2 + 1.0 / 9.0;
+  q = q * s2 + 1.0 / 7.0;
+  q = q * s2 + 1.0 / 5.0;
+  q = q * s2 + 1.0 / 3.0;
+  q = q * s2;
+  return e * 6.93147180369123816490e-01
+         + (e * 1.90821492927058770002e-10 + (2.0 * s + 2.0 * s * q));
+}
+
+/**
+ * \brief Квадратный корень неотрицательного числа, относительная
+ *   погрешность < 3e-16
+ * \note std::sqrt при errno-семантике libm(-fmath-errno, по
+ *   умолчанию) не векторизуется: для x < 0 компилятор оставляет
+ *   вызов функции. x должен быть нулём или нормализованным числом
+ * */
+inline double LaneSqrt(double x) {
+  // y ~ 1 / sqrt(x) с погрешностью ~3.5%: половина порядка и мантиссы
+  uint64_t bits;
+  memcpy(&bits, &x, sizeof(bits));
+  bits = 0x5fe6eb50c7b537a9ULL - (bits >> 1);
+  double y;
+  memcpy(&y, &bits, sizeof(y));
+  // итерации Ньютона для 1 / sqrt(x), погрешность 3.5e-2 -> 1e-21
+  const double hx = 0.5 * x;
+  y = y * (1.5 - hx * y * y);
+  y = y * (1.5 - hx * y * y);
+  y = y * (1.5 - hx * y * y);
+  y = y * (1.5 - hx * y * y);
+  // sqrt(x) = x * y, поправка по остатку x - s^2; для x = 0 - 0
+  const double s = x * y;
+  return s + 0.5 * y * (x - s * s);
+}
+
+/**
+ * \brief Кубический корень, относительная погрешность < 7e-16
+ * \note Аргумент должен лежать в интервале [1e-300, 1e300]: куб
+ *   промежуточного приближения не должен выходить за диапазон double.
+ *   Для x = 0 результат не 0, а ~3e-104
+ * */
+inline double LaneCbrt(double x) {
+  /* начальное приближение с погрешностью ~3%: старшие 32 бита
+   *   (порядок и начало мантиссы) делятся на 3 в арифметике double
+   *   (целочисленного деления векторных регистров нет) */
+  uint64_t bits;
+  memcpy(&bits, &x, sizeof(bits));
+  const uint64_t hi_bits = 0x4330000000000000ULL | (bits >> 32);
+  double hi;
+  memcpy(&hi, &hi_bits, sizeof(hi));
+  hi = (hi - 4503599627370496.0) * (1.0 / 3.0) + 715094163.0;
+  hi += 4503599627370496.0;
+  memcpy(&bits, &hi, sizeof(bits));
+  bits = (bits & 0xffffffffULL) << 32;
+  double y;
+  memcpy(&y, &bits, sizeof(y));
+  /* итерации Галлея, погрешность 3e-2 -> 3e-6 -> 3e-18. Поправка
+   *   записана отношением величин порядка x, без произведений вида
+   *   x * y, которые переполняются(обнуляются) у границ диапазона */
+  double y3 = y * y * y;
+  y += y * ((x - y3) / (2.0 * y3 + x));
+  y3 = y * y * y;
+  y += y * ((x - y3) / (2.0 * y3 + x));
+  y3 = y * y * y;
+  y += y * ((x - y3) / (2.0 * y3 + x));
+  return y;
+}
+
+/**
+ * \brief Косинус, абсолютная погрешность < 3e-16
+ * \note Аргумент должен лежать в интервале [-pi/2, pi/2], приведение
+ *   аргумента не выполняется
+ * */
+inline double LaneCos(double x) {
+  // ряд Тейлора до x^20, остаток < (pi/2)^22 / 22! ~ 2e-17
+  const double x2 = x * x;
+  double c = 1.0 / 2432902008176640000.0;
+  c = c * x2 - 1.0 / 6402373705728000.0;
+  c = c * x2 + 1.0 / 20922789888000.0;
+  c = c * x2 - 1.0 / 87178291200.0;
+  c = c * x2 + 1.0 / 479001600.0;
+  c = c * x2 - 1.0 / 3628800.0;
+  c = c * x2 + 1.0 / 40320.0;
+  c = c * x2 - 1.0 / 720.0;
+  c = c * x2 + 1.0 / 24.0;
+  c = c * x2 - 0.5;
+  return c * x2 + 1.0;
+}
+
+/**
+ * \brief Арккосинус, абсолютная погрешность < 5e-16
+ * \note Аргумент должен лежать в интервале [-1, 1]
+ * */
+inline double LaneAcos(double x) {
+  /* acos(x) = pi - acos(-x),
+   *   acos(x) = pi/2 - asin(x) для 0 <= x <= 1/2,
+   *   acos(x) = 2 * asin(sqrt((1 - x) / 2)) для x > 1/2,
+   *   asin(s) = s + s * R(s^2) - рациональное приближение fdlibm.
+   *   Ветви смешиваются умножением на 0 или 1(точно): при выборе
+   *   `cond ? f : g` компилятор переносит расчёт f и g в ветви, и без
+   *   масок AVX-512 цикл не векторизуется */
+  /* признаки x < 0 и |x| > 1/2 как 1.0 или 0.0 - целочисленно, через
+   *   биты x: сравнение x с константой, если x перед вызовом ограничен
+   *   константами, компилятор разделяет на ветви */
+  uint64_t bits;
+  memcpy(&bits, &x, sizeof(bits));
+  const uint64_t abits = bits & 0x7fffffffffffffffULL,
+                 fn_bits = 0x4330000000000000ULL | (bits >> 63),
+                 fb_bits = 0x4330000000000000ULL
+                           | (1 - ((abits - 0x3fe0000000000001ULL) >> 63));
+  double ax, fn, fb;
+  memcpy(&ax, &abits, sizeof(ax));
+  memcpy(&fn, &fn_bits, sizeof(fn));
+  memcpy(&fb, &fb_bits, sizeof(fb));
+  fn -= 4503599627370496.0;
+  fb -= 4503599627370496.0;
+  const double z = fb * (0.5 - 0.5 * ax) + (1.0 - fb) * (ax * ax);
+  const double s = fb * LaneSqrt(z) + (1.0 - fb) * ax;
+  const double p =
+      z * (1.66666666666666657415e-01
+           + z * (-3.25565818622400915405e-01
+                  + z * (2.01212532134862925881e-01
+                         + z * (-4.00555345006794114027e-02
+                                + z * (7.91534994289814532176e-04
+                                       + z * 3.47933107596021167570e-05)))));
+  const double q =
+      1.0
+      + z * (-2.40339491173441421878e+00
+             + z * (2.02094576023350569471e+00
+                    + z * (-6.88283971605453293030e-01
+                           + z * 7.70381505559019352791e-02)));
+  // asin(s)
+  const double as = s + s * (p / q);
+  const double pi = 3.14159265358979311600e+00;
+  // acos(|x|)
+  const double r = fb * (2.0 * as) + (1.0 - fb) * (0.5 * pi - as);
+  return fn * pi + (1.0 - 2.0 * fn) * r;
+}
+
+#endif  // !_CORE__COMMON__LANE_MATH_H_
@@ -12,9 +12,11 @@
 
 #include "asp_utils/Common.h"
 #include "asp_utils/ErrorWrap.h"
+#include "lane_math.h"
 
 #include <cmath>
 #include <complex>
+#include <utility>
 #include <string>
 #include <vector>
 
@@ -120,8 +122,8 @@ template <
 merror_t CardanoMethod_roots_count(const T* coef,
                                    T* results,
                                    int* roots_count) {
-  std::vector<std::complex<T>> vec(3);
-  auto error = CardanoMethod(coef, &vec[0]);
+  std::complex<T> vec[3];
+  auto error = CardanoMethod(coef, vec);
   if (!error) {
     results[0] = std::real(vec[0]);
     if (std::abs(std::imag(vec[1])) < FLOAT_ACCURACY) {
@@ -137,4 +139,193 @@ merror_t CardanoMethod_roots_count(const T* coef,
   return error;
 }
 
+/**
+ * \brief Действительные корни кубического уравнения
+ *   a*x^3 + b*x^2 + c*x + d = 0
+ *
+ * В отличие от CardanoMethod расчёт ведётся в действительной
+ *   арифметике без выделения памяти, а знак дискриминанта
+ *   определяется сравнением Q^3 и R^2, то есть не зависит от
+ *   масштаба коэффициентов. Каждый корень уточняется шагами метода
+ *   Ньютона, что важно для почти кратных корней
+ *
+ * \param roots[out] Массив на 3 элемента, корни по убыванию.
+ *   Если действительный корень один, все элементы равны ему
+ * \param roots_count[out] Количество действительных корней(1 или 3)
+ * */
+template <
+    class T,
+    class = typename std::enable_if<std::is_floating_point<T>::value>::type>
+merror_t CubicRealRoots(const T* coef, T* roots, int* roots_count) {
+  if ((coef == nullptr) || (roots == nullptr) || (roots_count == nullptr))
+    return ERROR_INIT_NULLP_ST;
+  if (coef[0] == 0.0)
+    return ERROR_INIT_ZERO_ST;
+  const T b = coef[1] / coef[0], c = coef[2] / coef[0], d = coef[3] / coef[0],
+          b3 = b / T(3.0), Q = (b * b - T(3.0) * c) / T(9.0),
+          R = (T(2.0) * b * b * b - T(9.0) * b * c + T(27.0) * d) / T(54.0),
+          Q3 = Q * Q * Q, R2 = R * R;
+  if (R2 < Q3) {
+    // 2*PI/3
+    const T pi23 = T(2.0943951023931957);
+    const T sq = std::sqrt(Q);
+    T ct = R / (Q * sq);
+    ct = (ct > T(1.0)) ? T(1.0) : (ct < T(-1.0)) ? T(-1.0) : ct;
+    const T theta = std::acos(ct) / T(3.0);
+    roots[0] = T(-2.0) * sq * std::cos(theta + pi23) - b3;
+    roots[1] = T(-2.0) * sq * std::cos(theta - pi23) - b3;
+    roots[2] = T(-2.0) * sq * std::cos(theta) - b3;
+    *roots_count = 3;
+  } else {
+    T A = std::cbrt(std::abs(R) + std::sqrt(R2 - Q3));
+    A = std::signbit(R) ? A : -A;
+    roots[0] = A + ((A == 0.0) ? T(0.0) : Q / A) - b3;
+    *roots_count = 1;
+  }
+  // уточнение корней, шаг принимается только если уменьшает невязку
+  auto f = [b, c, d](T x) { return ((x + b) * x + c) * x + d; };
+  for (int i = 0; i < *roots_count; ++i) {
+    T x = roots[i], fx = f(x);
+    for (int loop = 0; loop < 3 && fx != 0.0; ++loop) {
+      const T df = (T(3.0) * x + T(2.0) * b) * x + c;
+      if (df == 0.0)
+        break;
+      const T xn = x - fx / df, fxn = f(xn);
+      if (!(std::abs(fxn) < std::abs(fx)))
+        break;
+      x = xn, fx = fxn;
+    }
+    roots[i] = x;
+  }
+  if (*roots_count == 3) {
+    if (roots[0] < roots[1])
+      std::swap(roots[0], roots[1]);
+    if (roots[1] < roots[2])
+      std::swap(roots[1], roots[2]);
+    if (roots[0] < roots[1])
+      std::swap(roots[0], roots[1]);
+  } else {
+    roots[2] = roots[1] = roots[0];
+  }
+  return ERROR_SUCCESS_T;
+}
+
+/**
+ * \brief Шаг Ньютона для корня x уравнения x^3 + b*x^2 + c*x + d = 0
+ *   с невязкой fx, шаг принимается только если уменьшает невязку
+ * \note Без ветвлений, для циклов по точкам блока(lane_math.h)
+ * */
+inline void cubic_newton_lane(double b,
+                              double c,
+                              double d,
+                              double* x,
+                              double* fx) {
+  const double df = (3.0 * *x + 2.0 * b) * *x + c, xn = *x - *fx / df,
+               fxn = ((xn + b) * xn + c) * xn + d;
+  const bool better = std::abs(fxn) < std::abs(*fx);
+  *x = better ? xn : *x;
+  *fx = better ? fxn : *fx;
+}
+
+/**
+ * \brief Наибольшие и наименьшие действительные корни ATHERM_LANES
+ *   кубических уравнений x^3 + b[l]*x^2 + c[l]*x + d[l] = 0,
+ *   l < ATHERM_LANES
+ *
+ * Те же формулы, что в CubicRealRoots, но без ветвлений: для каждого
+ *   уравнения рассчитываются обе ветви - тригонометрическая(три корня,
+ *   из них нужны только наибольший и наименьший) и формула Кардано
+ *   (один корень), и выбирается одна из них. Элементарные функции - из
+ *   lane_math.h, поэтому цикл по уравнениям векторизуется. Корни
+ *   уточняются тремя шагами Ньютона, шаг принимается только если
+ *   уменьшает невязку
+ *
+ * \param root_max[out] Массив на ATHERM_LANES элементов
+ * \param root_min[out] Массив на ATHERM_LANES элементов, для уравнений
+ *   с одним действительным корнем совпадает с root_max
+ * \note Коэффициенты уравнений должны быть конечны, а |R|(см.
+ *   CubicRealRoots) лежать в интервале [1e-300, 1e300] или быть нулём,
+ *   см. LaneCbrt
+ * */
+ATHERM_LANES_TARGETS
+inline void CubicOuterRootsLanes(const double* b,
+                                 const double* c,
+                                 const double* d,
+                                 double* root_max,
+                                 double* root_min) {
+  // PI/3
+  const double pi3 = 1.0471975511965979;
+  double Q[ATHERM_LANES], R[ATHERM_LANES], sq[ATHERM_LANES],
+      ct[ATHERM_LANES], x3[ATHERM_LANES], x3_min[ATHERM_LANES],
+      x1[ATHERM_LANES];
+  for (size_t l = 0; l < ATHERM_LANES; ++l) {
+    const double bl = b[l], cl = c[l], dl = d[l];
+    Q[l] = (bl * bl - 3.0 * cl) * (1.0 / 9.0);
+    R[l] = (2.0 * bl * bl * bl - 9.0 * bl * cl + 27.0 * dl) * (1.0 / 54.0);
+    sq[l] = LaneSqrt((Q[l] < 0.0) ? -Q[l] : Q[l]);
+    ct[l] = R[l] / (Q[l] * sq[l]);
+  }
+  /* Обе ветви считаются для всех уравнений отдельными циклами, значения
+   *   неподходящей ветви(в том числе NaN) отбрасываются выбором. В одном
+   *   цикле компилятор перенёс бы расчёт ветвей под условие, а
+   *   ограничение R / Q^1.5 константами разделил бы на ветви для
+   *   значений 1 и -1 - такие циклы не векторизуются */
+  for (size_t l = 0; l < ATHERM_LANES; ++l) {
+    ct[l] = (ct[l] > 1.0) ? 1.0 : ct[l];
+    ct[l] = (ct[l] < -1.0) ? -1.0 : ct[l];
+  }
+  /* три корня(R^2 < Q^3, Q > 0): наибольший
+   *   -2*sqrt(Q)*cos(theta + 2*PI/3) - b/3, где
+   *   theta = acos(R / Q^1.5) / 3 из [0, PI/3], то же самое
+   *   2*sqrt(Q)*cos(PI/3 - theta) - b/3 с аргументом из [0, PI/3],
+   *   наименьший -2*sqrt(Q)*cos(theta) - b/3 */
+  for (size_t l = 0; l < ATHERM_LANES; ++l) {
+    const double theta = LaneAcos(ct[l]) * (1.0 / 3.0);
+    x3[l] = 2.0 * sq[l] * LaneCos(pi3 - theta) - b[l] * (1.0 / 3.0);
+    x3_min[l] = -2.0 * sq[l] * LaneCos(theta) - b[l] * (1.0 / 3.0);
+  }
+  /* один корень, для R = Q = 0(тройной корень) A ~ 3e-104 вместо 0,
+   *   отличие убирают шаги Ньютона */
+  for (size_t l = 0; l < ATHERM_LANES; ++l) {
+    const double Ql = Q[l], Rl = R[l], D = Rl * Rl - Ql * Ql * Ql,
+                 S = ((Rl < 0.0) ? -Rl : Rl) + LaneSqrt((D < 0.0) ? -D : D);
+    double A = LaneCbrt(S);
+    A = (Rl < 0.0) ? A : -A;
+    x1[l] = A + Ql / A - b[l] * (1.0 / 3.0);
+  }
+  double x[ATHERM_LANES], fx[ATHERM_LANES], y[ATHERM_LANES],
+      fy[ATHERM_LANES];
+  for (size_t l = 0; l < ATHERM_LANES; ++l) {
+    const bool three = R[l] * R[l] < Q[l] * Q[l] * Q[l];
+    x[l] = three ? x3[l] : x1[l];
+    y[l] = three ? x3_min[l] : x1[l];
+    fx[l] = ((x[l] + b[l]) * x[l] + c[l]) * x[l] + d[l];
+    fy[l] = ((y[l] + b[l]) * y[l] + c[l]) * y[l] + d[l];
+  }
+  // шаги Ньютона - тоже отдельными циклами, см. выше
+  for (int loop = 0; loop < 3; ++loop) {
+    for (size_t l = 0; l < ATHERM_LANES; ++l)
+      cubic_newton_lane(b[l], c[l], d[l], &x[l], &fx[l]);
+    for (size_t l = 0; l < ATHERM_LANES; ++l)
+      cubic_newton_lane(b[l], c[l], d[l], &y[l], &fy[l]);
+  }
+  for (size_t l = 0; l < ATHERM_LANES; ++l) {
+    root_max[l] = x[l];
+    root_min[l] = y[l];
+  }
+}
+
+/**
+ * \brief Наибольшие действительные корни ATHERM_LANES кубических
+ *   уравнений, см. CubicOuterRootsLanes
+ * \param root[out] Массив на ATHERM_LANES элементов
+ * */
+inline void CubicMaxRootLanes(const double* b,
+                              const double* c,
+                              const double* d,
+                              double* root) {
+  double root_min[ATHERM_LANES];
+  CubicOuterRootsLanes(b, c, d, root, root_min);
+}
+
 #endif  // !_CORE__COMMON__MODELS_MATH_H_
@@ -10,12 +10,17 @@
 #include "gas_ng_gost30319.h"
 
 #include "asp_utils/Logging.h"
+#include "asp_utils/ThreadWrap.h"
 #include "atherm_common.h"
 #include "gas_ng_gost_defines.h"
+#include "lane_math.h"
 
+#include <algorithm>
 #include <array>
+#include <cmath>
 #include <functional>
 #include <numeric>
+#include <unordered_map>
 #include <utility>
 
 #include <assert.h>
@@ -29,7 +34,10 @@
 // ErrorWrap GasParameters_NG_Gost_dyn::init_error;
 
 namespace {
-const double Lt = 1.0;
+/** \brief Максимальное число итераций поиска приведённой плотности */
+const int sigma_loop_max = 3000;
+/** \brief Относительная точность расчёта приведённого давления */
+const double sigma_accuracy = 0.000001;
 // typedef std::pair<double, double> mix_valid_limits_t;
 struct max_valid_limits_t {
   double min, max;
@@ -145,6 +153,539 @@ bool is_valid_limits(const ng_gost_mix& components, bool use_iso20675) {
   is_valid &= is_valid_limits(mix_valid_molar, others);
   return is_valid;
 }
+
+/**
+ * \brief Общий для процесса кэш коэффициентов ГОСТ модели.
+ *   Ключ - хэш отсортированного по компонентам состава смеси,
+ *   при совпадении хэшей составы сравниваются полностью
+ * */
+class gost_coefs_cache {
+ public:
+  /**
+   * \brief Коэффициенты смеси и не зависящие от долей величины
+   *   компонентов в порядке ключа
+   * */
+  struct value {
+    std::shared_ptr<const ng_gost30319_coefs> coefs;
+    std::shared_ptr<const ng_gost30319_mix_terms> terms;
+  };
+
+ public:
+  value Get(const ng_gost_mix& mix) {
+    std::lock_guard<Mutex> lock(mutex_);
+    return find(mix_hash(mix), mix);
+  }
+  /**
+   * \brief Добавить блок коэффициентов для смеси mix
+   * \return Блок из кэша, если его успел добавить другой поток,
+   *   иначе v
+   * */
+  value Insert(const ng_gost_mix& mix, const value& v) {
+    std::lock_guard<Mutex> lock(mutex_);
+    const size_t hash = mix_hash(mix);
+    value cached = find(hash, mix);
+    if (cached.coefs)
+      return cached;
+    if (cache_.size() >= max_size) {
+      // удалить блоки, которые не используются ни одним объектом
+      for (auto it = cache_.begin(); it != cache_.end();)
+        it = (it->second.v.coefs.use_count() == 1) ? cache_.erase(it)
+                                                   : std::next(it);
+    }
+    cache_.emplace(hash, entry{mix, v});
+    return v;
+  }
+
+ private:
+  struct entry {
+    ng_gost_mix mix;
+    value v;
+  };
+
+  value find(size_t hash, const ng_gost_mix& mix) {
+    auto range = cache_.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+      if (it->second.mix == mix)
+        return it->second.v;
+    }
+    return value();
+  }
+
+  static size_t mix_hash(const ng_gost_mix& mix) {
+    size_t seed = mix.size();
+    auto combine = [&seed](size_t h) {
+      seed ^= h + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    };
+    for (const auto& component : mix) {
+      combine(std::hash<gas_t>()(component.first));
+      combine(std::hash<double>()(component.second));
+    }
+    return seed;
+  }
+
+ private:
+  /** \brief Размер кэша, после которого удаляются неиспользуемые блоки */
+  static const size_t max_size = 256;
+  Mutex mutex_;
+  std::unordered_multimap<size_t, entry> cache_;
+};
+gost_coefs_cache coefs_cache;
+
+/**
+ * \brief Каноничная форма состава смеси для ключа кэша
+ * */
+ng_gost_mix sorted_mix(ng_gost_mix mix) {
+  std::sort(mix.begin(), mix.end(),
+            [](const ng_gost_component& l, const ng_gost_component& r) {
+              return l.first < r.first;
+            });
+  return mix;
+}
+
+/**
+ * \brief Рассчитать множители a[n] * pow(Lt / t, u[n]) членов
+ *   ряда `A0_3_coefs` для температуры t
+ * */
+void set_a_tu(double t, ng_gost30319_tau_terms& terms) {
+  terms.t = t;
+  const double tau = Lt / t;
+  for (size_t n = 0; n < A0_3_coefs_count; ++n)
+    terms.a_tu[n] = A0_3_coefs[n].a * std::pow(tau, A0_3_coefs[n].u);
+}
+
+/**
+ * \brief Степени приведённой плотности sigma^b и экспоненты
+ *   exp(-sigma^k), общие для всех членов ряда `A0_3_coefs`
+ * */
+struct sigma_powers {
+  explicit sigma_powers(double sigma) {
+    pw[0] = 1.0;
+    for (size_t i = 1; i <= A0_3_b_max; ++i)
+      pw[i] = pw[i - 1] * sigma;
+    for (size_t i = 0; i <= A0_3_k_max; ++i)
+      ex[i] = std::exp(-pw[i]);
+  }
+  /** \brief sigma^b для члена ряда A3c */
+  double Pow(const A0_3_coef& A3c) const {
+    return pw[static_cast<size_t>(A3c.b)];
+  }
+  /** \brief c * sigma^k для члена ряда A3c */
+  double Csk(const A0_3_coef& A3c) const {
+    return A3c.c * pw[static_cast<size_t>(A3c.k)];
+  }
+  /** \brief exp(-c * sigma^k) для члена ряда A3c */
+  double Exp(const A0_3_coef& A3c) const {
+    if (A3c.c == 0.0)
+      return 1.0;
+    return (A3c.c == 1.0) ? ex[static_cast<size_t>(A3c.k)]
+                          : std::exp(-Csk(A3c));
+  }
+
+  double pw[A0_3_b_max + 1];
+  double ex[A0_3_k_max + 1];
+};
+
+/**
+ * \brief Записать в лог ошибку расчёта состояния смеси в точке (p, t)
+ * */
+void log_state_error(merror_t error, double p, double t) {
+  if (error == ERROR_CALCULATE_T) {
+    Logging::Append(ERROR_CALCULATE_T, "check ng_gost limits");
+  } else if (error == ERROR_CALC_MODEL_ST) {
+    Logging::Append(ERROR_CALC_MODEL_ST,
+                    "ГОСТ модель: итерационная процедура расчёта "
+                    "приведённой плотности не сошлась для p="
+                        + std::to_string(p) + " t=" + std::to_string(t));
+  } else {
+    Logging::Append(error, "ГОСТ модель: ошибка расчёта параметров смеси");
+  }
+}
+
+/* Расчёт блока из ATHERM_LANES точек, см. lane_math.h и
+ *   `Gost30319Kernel::EvaluateBatch`. Формулы повторяют расчёт одной
+ *   точки(set_a_tu, CalculateSigma, calculate_A0_3, set_cp0r, set_fi0r,
+ *   set_coefB, set_coefC, set_fi), массивы вида x[ATHERM_LANES] хранят
+ *   значение для каждой точки блока */
+
+/** \brief Максимальное число итераций Ньютона для блока точек,
+ *   не сошедшиеся точки рассчитываются по одной */
+const int sigma_lanes_loop_max = 24;
+
+/** \brief Компонент смеси для расчёта теплоёмкости и энергии
+ *   Гельмгольца идеального газа */
+struct lane_component {
+  /// коэффициенты теплоёмкости
+  const A4_coef* cpc;
+  /// молярная доля
+  double x;
+  /// ln(x)
+  double ln_x;
+  /// множитель M / (1000 * R), для благородных газов 1
+  double cp_mult;
+  /// благородный газ, для теплоёмкости используется только B
+  bool is_noble;
+};
+
+/** \brief Не зависящие от точки коэффициенты смеси */
+struct lane_coefs {
+  /// Kx^-3
+  double kx3;
+  /// Dn членов ряда, см. `calculate_A0_3`
+  double Dn[A0_3_coefs_count];
+  /// Cn членов ряда
+  double Cn[A0_3_coefs_count];
+  /// Bn членов ряда, n < Bn_count
+  double Bn[Bn_count];
+  /// R смеси
+  double Rm;
+  /// приведённая плотность при стандартных условиях(ISO 20765)
+  double sigma_ref;
+  /// расчёт по ISO 20765
+  bool use_iso;
+  std::vector<lane_component> components;
+};
+
+/** \brief Данные блока точек */
+struct lane_block {
+  /// температура
+  double t[ATHERM_LANES];
+  /// Lt / t
+  double tau[ATHERM_LANES];
+  /// приведённое давление
+  double pi[ATHERM_LANES];
+  /// вход - начальное приближение, выход - приведённая плотность или 0,
+  ///   если итерации не сошлись
+  double sigma[ATHERM_LANES];
+  /// a_tu[n], см. `ng_gost30319_tau_terms`
+  double a_tu[A0_3_coefs_count][ATHERM_LANES];
+  /// изобарная теплоёмкость в идеальном состоянии
+  double cp0r[ATHERM_LANES];
+  /// функции A0-A3 модели ГОСТ 30319
+  double A0[ATHERM_LANES], A1[ATHERM_LANES], A2[ATHERM_LANES],
+      A3[ATHERM_LANES];
+#if defined(ISO_20765)
+  /// слагаемые ISO 20765, см. `ng_gost30319_tau_terms`
+  double B[ATHERM_LANES], B_t[ATHERM_LANES], B_tt[ATHERM_LANES];
+  double C[ATHERM_LANES], C_t[ATHERM_LANES], C_tt[ATHERM_LANES];
+  double fi0r[ATHERM_LANES], fi0r_t[ATHERM_LANES], fi0r_tt[ATHERM_LANES];
+  /// энергия Гельмгольца и её производные, см. `ng_gost30319_params`
+  double fi[ATHERM_LANES], fi_t[ATHERM_LANES], fi_tt[ATHERM_LANES],
+      fi_d[ATHERM_LANES], fi_1[ATHERM_LANES], fi_2[ATHERM_LANES];
+#endif  // ISO_20765
+};
+
+/** \brief Степени sigma^b и exp(-sigma^k) для блока точек,
+ *   см. `sigma_powers` */
+struct lane_sigma_powers {
+  double pw[A0_3_b_max + 1][ATHERM_LANES];
+  double ex[A0_3_k_max + 1][ATHERM_LANES];
+};
+
+ATHERM_LANES_TARGETS
+void set_lane_powers(const double* sigma, lane_sigma_powers& sp) {
+  for (size_t l = 0; l < ATHERM_LANES; ++l)
+    sp.pw[0][l] = 1.0;
+  for (size_t i = 1; i <= A0_3_b_max; ++i)
+    for (size_t l = 0; l < ATHERM_LANES; ++l)
+      sp.pw[i][l] = sp.pw[i - 1][l] * sigma[l];
+  // аргумент экспоненты ограничен, см. `LaneExp`
+  for (size_t i = 0; i <= A0_3_k_max; ++i) {
+    for (size_t l = 0; l < ATHERM_LANES; ++l)
+      sp.ex[i][l] = (sp.pw[i][l] < 708.0) ? -sp.pw[i][l] : -708.0;
+    for (size_t l = 0; l < ATHERM_LANES; ++l)
+      sp.ex[i][l] = LaneExp(sp.ex[i][l]);
+  }
+}
+
+/**
+ * \brief Рассчитать a_tu и теплоёмкость идеального газа, для
+ *   ISO 20765 также суммы B, C и энергию Гельмгольца идеального газа
+ * */
+ATHERM_LANES_TARGETS
+void set_lane_tau_terms(const lane_coefs& lc, lane_block& b) {
+  double ln_tau[ATHERM_LANES];
+  for (size_t l = 0; l < ATHERM_LANES; ++l)
+    ln_tau[l] = LaneLog(b.tau[l]);
+  for (size_t n = 0; n < A0_3_coefs_count; ++n) {
+    const double a = A0_3_coefs[n].a, u = A0_3_coefs[n].u;
+    for (size_t l = 0; l < ATHERM_LANES; ++l)
+      b.a_tu[n][l] = a * LaneExp(u * ln_tau[l]);
+  }
+  double cp0r[ATHERM_LANES] = {0.0};
+#if defined(ISO_20765)
+  double fi0r[ATHERM_LANES] = {0.0}, fi0r_t[ATHERM_LANES] = {0.0},
+         fi0r_tt[ATHERM_LANES] = {0.0};
+#endif  // ISO_20765
+  for (const lane_component& c : lc.components) {
+    const A4_coef& cpc = *c.cpc;
+    /* пары (C, D), (G, H) входят в виде C * (D / sinh(D * tau))^2,
+     *   пары (E, F), (I, J) - в виде E * (F / cosh(F * tau))^2, так же
+     *   и слагаемые fi0r, fi0r_t. При нулевом D слагаемое с sinh
+     *   равно 0 */
+    const double pairs[4][2] = {
+        {cpc.C, cpc.D}, {cpc.E, cpc.F}, {cpc.G, cpc.H}, {cpc.I, cpc.J}};
+    double cp[ATHERM_LANES] = {0.0};
+#if defined(ISO_20765)
+    double f[ATHERM_LANES] = {0.0}, f_t[ATHERM_LANES] = {0.0};
+#endif  // ISO_20765
+    for (size_t j = 0; j < 4; ++j) {
+      const double C = pairs[j][0], D = pairs[j][1];
+      const bool is_sinh = (j % 2) == 0;
+      if (is_sinh && is_equal(D, 0.0))
+        continue;
+      // sinh, cosh(D * tau): den в знаменателе слагаемых, num - другая
+      double den[ATHERM_LANES], num[ATHERM_LANES];
+      for (size_t l = 0; l < ATHERM_LANES; ++l) {
+        const double e = LaneExp(D * b.tau[l]);
+        const double sh = 0.5 * (e - 1.0 / e), ch = 0.5 * (e + 1.0 / e);
+        den[l] = (is_sinh) ? sh : ch;
+        num[l] = (is_sinh) ? ch : sh;
+      }
+      (void)num;
+      for (size_t l = 0; l < ATHERM_LANES; ++l) {
+        const double r = D / den[l];
+        cp[l] += C * r * r;
+      }
+#if defined(ISO_20765)
+      if (!lc.use_iso)
+        continue;
+      const double sign = (is_sinh) ? 1.0 : -1.0;
+      for (size_t l = 0; l < ATHERM_LANES; ++l) {
+        f[l] += sign * C * LaneLog(den[l]);
+        f_t[l] += sign * C * D * num[l] / den[l];
+      }
+#endif  // ISO_20765
+    }
+    if (c.is_noble) {
+      for (size_t l = 0; l < ATHERM_LANES; ++l)
+        cp0r[l] += c.x * cpc.B;
+    } else {
+      for (size_t l = 0; l < ATHERM_LANES; ++l)
+        cp0r[l] += c.x * (cpc.B + b.tau[l] * b.tau[l] * cp[l]) * c.cp_mult;
+    }
+#if defined(ISO_20765)
+    if (!lc.use_iso)
+      continue;
+    for (size_t l = 0; l < ATHERM_LANES; ++l) {
+      const double tau = b.tau[l];
+      fi0r[l] += c.x * (cpc.A1 + cpc.A2 * tau + cpc.B * ln_tau[l] + f[l]
+                        + c.ln_x);
+      fi0r_t[l] += c.x * (cpc.A2 + (cpc.B - 1.0) / tau + f_t[l]);
+      fi0r_tt[l] += c.x * (-(cpc.B - 1.0) / tau / tau - cp[l]);
+    }
+#endif  // ISO_20765
+  }
+  for (size_t l = 0; l < ATHERM_LANES; ++l)
+    b.cp0r[l] = cp0r[l] * lc.Rm;
+#if defined(ISO_20765)
+  if (!lc.use_iso)
+    return;
+  for (size_t l = 0; l < ATHERM_LANES; ++l) {
+    b.fi0r[l] = fi0r[l];
+    b.fi0r_t[l] = fi0r_t[l];
+    b.fi0r_tt[l] = fi0r_tt[l];
+    b.B[l] = b.B_t[l] = b.B_tt[l] = 0.0;
+    b.C[l] = b.C_t[l] = b.C_tt[l] = 0.0;
+  }
+  for (size_t n = 0; n < Bn_count; ++n) {
+    const double u = A0_3_coefs[n].u, Bn = lc.Bn[n], Cn = lc.Cn[n];
+    for (size_t l = 0; l < ATHERM_LANES; ++l) {
+      const double d1 = b.a_tu[n][l] * Bn;
+      b.B[l] += d1;
+      b.B_t[l] += u * d1;
+      b.B_tt[l] += u * (u - 1.0) * d1;
+    }
+    if (n < 12)
+      continue;
+    for (size_t l = 0; l < ATHERM_LANES; ++l) {
+      const double d1 = b.a_tu[n][l] * Cn;
+      b.C[l] += d1;
+      b.C_t[l] += u * d1;
+      b.C_tt[l] += u * (u - 1.0) * d1;
+    }
+  }
+#endif  // ISO_20765
+}
+
+/**
+ * \brief Рассчитать функции A0-A3 для приведённых плотностей sigma
+ * \note Члены ряда перебираются во внешнем цикле, точки блока - во
+ *   внутреннем, см. `Gost30319Kernel::calculate_A0_3`. Для членов
+ *   с c = 0 exp(-c * sigma^k) = 1
+ * */
+ATHERM_LANES_TARGETS
+void set_lane_A0_3(const lane_coefs& lc,
+                   const lane_block& b,
+                   const double* sigma,
+                   double* A0,
+                   double* A1,
+                   double* A2,
+                   double* A3) {
+  lane_sigma_powers sp;
+  set_lane_powers(sigma, sp);
+  // суммы в локальных массивах: выходные массивы могут пересекаться
+  //   с данными блока, что мешает векторизации
+  double a0[ATHERM_LANES] = {0.0}, a1[ATHERM_LANES] = {0.0},
+         a2[ATHERM_LANES] = {0.0}, a3[ATHERM_LANES] = {0.0};
+  for (size_t n = 0; n < A0_3_coefs_count; ++n) {
+    const A0_3_coef& A3c = A0_3_coefs[n];
+    const size_t bi = static_cast<size_t>(A3c.b),
+                 ki = static_cast<size_t>(A3c.k);
+    const double Dn = lc.Dn[n], Cn = (n < 12) ? 0.0 : lc.Cn[n];
+    const double d0 = A3c.b * Dn, d1 = (A3c.b + 1.0) * A3c.b * Dn;
+    const double u2 = 1.0 - A3c.u, u3 = (1.0 - A3c.u) * A3c.u;
+    if (A3c.c == 0.0) {
+      // множители не зависят от плотности
+      const double e0 = d0 + A3c.b * Cn,
+                   e1 = d1 + A3c.b * (A3c.b + 1.0) * Cn, e3 = Dn + Cn;
+      for (size_t l = 0; l < ATHERM_LANES; ++l) {
+        const double st = b.a_tu[n][l] * sp.pw[bi][l];
+        a0[l] += st * e0;
+        a1[l] += st * e1;
+        a2[l] += st * u2 * e0;
+        a3[l] += st * u3 * e3;
+      }
+    } else {
+      // c равен 1, см. `A0_3_b_max`
+      for (size_t l = 0; l < ATHERM_LANES; ++l) {
+        const double st = b.a_tu[n][l] * sp.pw[bi][l];
+        const double csk = sp.pw[ki][l];
+        const double Une = Cn * sp.ex[ki][l];
+        const double bk = A3c.b - A3c.k * csk;
+        const double e0 = d0 + bk * Une;
+        a0[l] += st * e0;
+        a1[l] += st * (d1 + (bk * (bk + 1.0) - A3c.k * A3c.k * csk) * Une);
+        a2[l] += st * u2 * e0;
+        a3[l] += st * u3 * (Dn + Une);
+      }
+    }
+  }
+  for (size_t l = 0; l < ATHERM_LANES; ++l) {
+    A0[l] = a0[l];
+    A1[l] = a1[l];
+    A2[l] = a2[l];
+    A3[l] = a3[l];
+  }
+}
+
+/**
+ * \brief Рассчитать приведённые плотности блока точек методом
+ *   Ньютона, см. `Gost30319Kernel::CalculateSigma`
+ * \note Итерации всех точек выполняются совместно, сошедшиеся
+ *   точки маскируются. Для точек, не сошедшихся за
+ *   sigma_lanes_loop_max итераций, b.sigma обнуляется
+ * */
+ATHERM_LANES_TARGETS
+void set_lane_sigma(const lane_coefs& lc, lane_block& b) {
+  double s[ATHERM_LANES], done[ATHERM_LANES];
+  for (size_t l = 0; l < ATHERM_LANES; ++l) {
+    s[l] = b.sigma[l];
+    b.sigma[l] = 0.0;
+    done[l] = 0.0;
+  }
+  double A0[ATHERM_LANES], A1[ATHERM_LANES], A2[ATHERM_LANES],
+      A3[ATHERM_LANES];
+  for (int loop = 0; loop < sigma_lanes_loop_max; ++loop) {
+    set_lane_A0_3(lc, b, s, A0, A1, A2, A3);
+    double done_count = 0.0;
+    for (size_t l = 0; l < ATHERM_LANES; ++l) {
+      const double tau = b.t[l] / Lt, pi = b.pi[l];
+      const double ds = (pi / tau - (1.0 + A0[l]) * s[l]) / (1.0 + A1[l]);
+      const double next = s[l] + ds;
+      /* условия объединяются побитово: при && второе сравнение
+       *   становится условным и цикл не векторизуется */
+      const bool conv =
+          std::abs(s[l] * tau * (1.0 + A0[l]) - pi) / pi < sigma_accuracy;
+      b.sigma[l] = ((done[l] == 0.0) & conv) ? next : b.sigma[l];
+      // расходящиеся итерации прекращаются, плотность остаётся 0
+      const bool fail = !((next > DOUBLE_ACCURACY) & (next < HUGE_VAL));
+      done[l] = (conv | fail) ? 1.0 : done[l];
+      s[l] = (done[l] != 0.0) ? 1.0 : next;
+      done_count += done[l];
+    }
+    if (done_count == ATHERM_LANES)
+      break;
+  }
+}
+
+#if defined(ISO_20765)
+/**
+ * \brief Рассчитать энергию Гельмгольца и её производные для
+ *   приведённых плотностей b.sigma, см. `Gost30319Kernel::set_fi`
+ * */
+ATHERM_LANES_TARGETS
+void set_lane_fi(const lane_coefs& lc, lane_block& b) {
+  double sigma[ATHERM_LANES];
+  for (size_t l = 0; l < ATHERM_LANES; ++l)
+    sigma[l] = (b.sigma[l] > 0.0) ? b.sigma[l] : 1.0;
+  lane_sigma_powers sp;
+  set_lane_powers(sigma, sp);
+  const double tauT = Lt / 298.15;
+  double fi[ATHERM_LANES], fi_t[ATHERM_LANES], fi_tt[ATHERM_LANES],
+      fi_d[ATHERM_LANES], fi_1[ATHERM_LANES], fi_2[ATHERM_LANES];
+  for (size_t l = 0; l < ATHERM_LANES; ++l) {
+    const double tau = b.tau[l], s_k = sigma[l] * lc.kx3;
+    b.fi0r[l] += LaneLog(tauT / tau) + LaneLog(sigma[l] / lc.sigma_ref);
+    fi[l] = b.fi0r[l] + b.B[l] * s_k - sigma[l] * b.C[l];
+    fi_t[l] = tau * b.fi0r_t[l] + s_k * b.B_t[l] - sigma[l] * b.C_t[l];
+    fi_tt[l] = tau * tau * b.fi0r_tt[l] + s_k * b.B_tt[l]
+               - sigma[l] * b.C_tt[l];
+    fi_d[l] = 1.0 + b.B[l] * s_k - sigma[l] * b.C[l];
+    fi_1[l] = 1.0 + 2.0 * b.B[l] * s_k - 2.0 * sigma[l] * b.C[l];
+    fi_2[l] = 1.0 - s_k * (b.B_t[l] - b.B[l])
+              + sigma[l] * (b.C_t[l] - b.C[l]);
+  }
+  for (size_t n = 12; n < A0_3_coefs_count; ++n) {
+    const A0_3_coef& A3c = A0_3_coefs[n];
+    const size_t bi = static_cast<size_t>(A3c.b),
+                 ki = static_cast<size_t>(A3c.k);
+    const double Cn = lc.Cn[n];
+    const double u1 = A3c.u * (A3c.u - 1.0), u2 = 1.0 - A3c.u;
+    /* при c = 0 множитель exp(-c * sigma^k) равен 1, а k3 = b,
+     *   иначе c = 1, см. `set_lane_A0_3` */
+    const bool is_exp = A3c.c != 0.0;
+    for (size_t l = 0; l < ATHERM_LANES; ++l) {
+      const double csk = sp.pw[ki][l];
+      const double ex = sp.ex[ki][l];
+      double d1 = b.a_tu[n][l] * Cn * sp.pw[bi][l];
+      double k3 = A3c.b;
+      double k4 = k3;
+      if (is_exp) {
+        d1 *= ex;
+        k3 = A3c.b - A3c.k * csk;
+        k4 = k3 - A3c.k * A3c.k * csk;
+      }
+      const double d3 = d1 * k3;
+      fi[l] += d1;
+      fi_t[l] += A3c.u * d1;
+      fi_tt[l] += u1 * d1;
+      fi_d[l] += d3;
+      fi_1[l] += d1 * (k4 + k3 * k3);
+      fi_2[l] += d3 * u2;
+    }
+  }
+  for (size_t l = 0; l < ATHERM_LANES; ++l) {
+    const double tau = b.tau[l];
+    b.fi[l] = fi[l];
+    b.fi_t[l] = fi_t[l] / tau;
+    b.fi_tt[l] = fi_tt[l] / tau / tau;
+    b.fi_d[l] = fi_d[l] / sigma[l];
+    b.fi_1[l] = fi_1[l];
+    b.fi_2[l] = fi_2[l];
+  }
+}
+#endif  // ISO_20765
+
+/**
+ * \brief Рассчитать функции A0-A3 для приведённых плотностей b.sigma
+ * */
+ATHERM_LANES_TARGETS
+void set_lane_gost(const lane_coefs& lc, lane_block& b) {
+  double sigma[ATHERM_LANES];
+  for (size_t l = 0; l < ATHERM_LANES; ++l)
+    sigma[l] = (b.sigma[l] > 0.0) ? b.sigma[l] : 1.0;
+  set_lane_A0_3(lc, b, sigma, b.A0, b.A1, b.A2, b.A3);
+}
 }  // namespace
 
 GasParametersGost30319Dyn* GasParametersGost30319Dyn::Init(gas_params_input gpi,
@@ -192,10 +733,12 @@ GasParametersGost30319Dyn::GasParametersGost30319Dyn(parameters prs,
                                                      ng_gost_mix components,
                                                      bool use_iso)
     : GasParameters(prs, cgp, dyn_parameters()),
-      components_(components),
+      components_(sorted_mix(components)),
+      pseudocritic_(cgp.critical),
+      ng_gost_params_(),
+      tau_terms_(),
       use_iso20765_(use_iso) {
-  if (setFuncCoefficients())
-    set_p0m();
+  setFuncCoefficients();
   if (error_.GetErrorCode()) {
     // если была ошибка на стадии инициализации
     status_ = STATUS_HAVE_ERROR;
@@ -206,46 +749,25 @@ GasParametersGost30319Dyn::GasParametersGost30319Dyn(parameters prs,
 
 parameters GasParametersGost30319Dyn::calcPseudocriticVPT(
     ng_gost_mix components) {
+  ng_gost30319_mix_terms terms;
+  init_pseudocritic_terms(components, terms);
+  return calcPseudocriticVPT(components, terms);
+}
+
+parameters GasParametersGost30319Dyn::calcPseudocriticVPT(
+    const ng_gost_mix& components,
+    const ng_gost30319_mix_terms& terms) {
   double vol = 0.0;
   double temp = 0.0;
   double press_var = 0.0;
-  double tmp_var = 0;
-  double Mi = 0.0, Mj = 0.0;
-  const component_characteristics* x_ch = nullptr;
-  const critical_params* i_cp = nullptr;
-  const critical_params* j_cp = nullptr;
+  size_t ij = 0;
   for (size_t i = 0; i < components.size(); ++i) {
-    if ((x_ch = get_characteristics(components[i].first))) {
-      Mi = x_ch->M;
-    } else {
-      Logging::Append(
-          "init pseudocritic by gost model\n"
-          "  undefined component: #"
-          + std::to_string(components[i].first));
-      continue;
+    for (size_t j = i; j < components.size(); ++j, ++ij) {
+      const double xij = components[i].second * components[j].second;
+      vol += xij * terms.pc_volume[ij];
+      temp += xij * terms.pc_temperature[ij];
     }
-    if (!(i_cp = get_critical_params(components[i].first)))
-      continue;
-    for (size_t j = 0; j < components.size(); ++j) {
-      if ((x_ch = get_characteristics(components[j].first))) {
-        Mj = x_ch->M;
-      } else {
-        Logging::Append(
-            "init pseudocritic by gost model\n"
-            "  undefined component: #"
-            + std::to_string(components[j].first));
-        continue;
-      }
-      if (!(j_cp = get_critical_params(components[j].first)))
-        continue;
-      tmp_var = components[i].second * components[j].second
-                * pow(pow(Mi / i_cp->density, 0.333333)
-                          + pow(Mj / j_cp->density, 0.333333),
-                      3.0);
-      vol += tmp_var;
-      temp += tmp_var * sqrt(i_cp->temperature * j_cp->temperature);
-    }
-    press_var += components[i].second * i_cp->acentric;
+    press_var += components[i].second * terms.acentric[i];
   }
   press_var *= 0.08;
   press_var = 0.291 - press_var;
@@ -257,179 +779,441 @@ parameters GasParametersGost30319Dyn::calcPseudocriticVPT(
   return pseudocrit_vpt;
 }
 
-bool GasParametersGost30319Dyn::setFuncCoefficients() {
-  if (!init_kx()) {
-    set_V();
-    set_Q();
-    set_F();
-    set_G();
-    set_Bn();
-    set_Cn();
+void GasParametersGost30319Dyn::init_pseudocritic_terms(
+    const ng_gost_mix& components,
+    ng_gost30319_mix_terms& terms) {
+  const size_t count = components.size();
+  terms.acentric.assign(count, 0.0);
+  terms.pc_volume.assign(count * (count + 1) / 2, 0.0);
+  terms.pc_temperature.assign(count * (count + 1) / 2, 0.0);
+  // (M / density)^(1/3) компонентов, 0 - для компонентов без данных
+  std::vector<double> vr(count, 0.0);
+  const component_characteristics* x_ch = nullptr;
+  const critical_params* x_cp = nullptr;
+  for (size_t i = 0; i < count; ++i) {
+    if (!(x_ch = get_characteristics(components[i].first))) {
+      Logging::Append(
+          "init pseudocritic by gost model\n"
+          "  undefined component: #"
+          + std::to_string(components[i].first));
+      continue;
+    }
+    if (!(x_cp = get_critical_params(components[i].first)))
+      continue;
+    vr[i] = pow(x_ch->M / x_cp->density, 0.333333);
+    terms.acentric[i] = x_cp->acentric;
+  }
+  size_t ij = 0;
+  for (size_t i = 0; i < count; ++i) {
+    for (size_t j = i; j < count; ++j, ++ij) {
+      if (is_equal(vr[i], 0.0) || is_equal(vr[j], 0.0))
+        continue;
+      // слагаемые (i, j) и (j, i) равны
+      const double vij = ((i == j) ? 1.0 : 2.0) * pow(vr[i] + vr[j], 3.0);
+      terms.pc_volume[ij] = vij;
+      terms.pc_temperature[ij] =
+          vij
+          * sqrt(get_critical_params(components[i].first)->temperature
+                 * get_critical_params(components[j].first)->temperature);
+    }
   }
-  return (error_.GetErrorCode()) ? false : true;
 }
 
-// calculating
-merror_t GasParametersGost30319Dyn::init_kx() {
-  coef_kx_ = 0.0;
-  const component_characteristics* xi_ch = nullptr;
-  for (size_t i = 0; i < components_.size(); ++i) {
-    xi_ch = get_characteristics(components_[i].first);
-    if (xi_ch == nullptr)
+merror_t GasParametersGost30319Dyn::init_mix_terms() {
+  const size_t count = components_.size();
+  const size_t pairs = count * (count + 1) / 2;
+  auto shared_terms = std::make_shared<ng_gost30319_mix_terms>();
+  ng_gost30319_mix_terms& terms = *shared_terms;
+  terms.M.resize(count);
+  terms.Q.resize(count);
+  terms.F.resize(count);
+  terms.G.resize(count);
+  std::vector<const component_characteristics*> chs(count);
+  for (size_t i = 0; i < count; ++i) {
+    if (!(chs[i] = get_characteristics(components_[i].first)))
       return error_.SetError(ERROR_INIT_T, "undefined component in gost model");
-    coef_kx_ += components_[i].second * pow(xi_ch->K, 2.5);
-  }
-  coef_kx_ *= coef_kx_;
-  double associate_Kx_part = 0.0;
-  const binary_associate_coef* assoc_coefs = nullptr;
-  const component_characteristics* xj_ch = nullptr;
-  for (size_t i = 0; i < components_.size() - 1; ++i) {
-    xi_ch = get_characteristics(components_[i].first);
-    for (size_t j = i + 1; j < components_.size(); ++j) {
-      xj_ch = get_characteristics(components_[j].first);
-      assoc_coefs = get_binary_associate_coefs(components_[i].first,
-                                               components_[j].first);
-      associate_Kx_part +=
-          components_[i].second * components_[j].second
-          * ((pow(assoc_coefs->K, 5.0) - 1.0) * pow(xi_ch->K * xj_ch->K, 2.5));
+    terms.M[i] = chs[i]->M;
+    terms.Q[i] = chs[i]->Q;
+    terms.F[i] = chs[i]->F;
+    terms.G[i] = chs[i]->G;
+  }
+  terms.K5.resize(pairs);
+  terms.V5.resize(pairs);
+  terms.Gij.resize(pairs);
+  terms.Bn.resize(pairs * Bn_count);
+  size_t ij = 0;
+  for (size_t i = 0; i < count; ++i) {
+    const component_characteristics* xi_ch = chs[i];
+    for (size_t j = i; j < count; ++j, ++ij) {
+      const component_characteristics* xj_ch = chs[j];
+      const binary_associate_coef* assoc_coef = get_binary_associate_coefs(
+          components_[i].first, components_[j].first);
+      if (i == j) {
+        terms.K5[ij] = pow(xi_ch->K, 5.0);
+        terms.V5[ij] = pow(xi_ch->E, 5.0);
+        terms.Gij[ij] = 0.0;
+      } else {
+        // слагаемые (i, j) и (j, i) равны
+        terms.K5[ij] =
+            2.0 * pow(assoc_coef->K, 5.0) * pow(xi_ch->K * xj_ch->K, 2.5);
+        terms.V5[ij] =
+            2.0 * pow(assoc_coef->V, 5.0) * pow(xi_ch->E * xj_ch->E, 2.5);
+        terms.Gij[ij] = (assoc_coef->G - 1.0) * (xi_ch->G + xj_ch->G);
+      }
+      /* Показатели g, q, f, s, w в таблице ГОСТ 30319.3 равны 0 или 1,
+       *   т.е. множитель вида `pow(x + 1 - g, g)` равен либо 1, либо x */
+      const double Gij = assoc_coef->G * (xi_ch->G + xj_ch->G) / 2.0;
+      const double Qij = xi_ch->Q * xj_ch->Q;
+      const double Fij = sqrt(xi_ch->F * xj_ch->F);
+      const double Sij = xi_ch->S * xj_ch->S;
+      const double Wij = xi_ch->W * xj_ch->W;
+      const double Eij = assoc_coef->E * sqrt(xi_ch->E * xj_ch->E);
+      const double Kij =
+          ((i == j) ? 1.0 : 2.0) * pow(xi_ch->K * xj_ch->K, 1.5);
+      for (size_t n = 0; n < Bn_count; ++n) {
+        const A0_3_coef& A3c = A0_3_coefs[n];
+        double Bnij = Kij * pow(Eij, A3c.u);
+        if (A3c.g != 0.0)
+          Bnij *= Gij;
+        if (A3c.q != 0.0)
+          Bnij *= Qij;
+        if (A3c.f != 0.0)
+          Bnij *= Fij;
+        if (A3c.s != 0.0)
+          Bnij *= Sij;
+        if (A3c.w != 0.0)
+          Bnij *= Wij;
+        terms.Bn[ij * Bn_count + n] = Bnij;
+      }
     }
   }
-  associate_Kx_part *= 2.0;
-  coef_kx_ += associate_Kx_part;
-  coef_kx_ = pow(coef_kx_, 0.2);
+  init_pseudocritic_terms(components_, terms);
+  mix_terms_ = shared_terms;
   return ERROR_SUCCESS_T;
 }
 
-void GasParametersGost30319Dyn::set_V() {
-  double V = 0.0;
-  const component_characteristics* xi_ch = nullptr;
-  for (size_t i = 0; i < components_.size(); ++i) {
-    xi_ch = get_characteristics(components_[i].first);
-    if (xi_ch == nullptr) {
-      error_.SetError(ERROR_INIT_T, "undefined component in gost model");
-      return;
-    }
-    V += components_[i].second * pow(xi_ch->E, 2.5);
-  }
-  V *= V;
-  double associate_V_part = 0.0;
-  const binary_associate_coef* assoc_coefs = nullptr;
-  const component_characteristics* xj_ch = nullptr;
-  for (size_t i = 0; i < components_.size() - 1; ++i) {
-    xi_ch = get_characteristics(components_[i].first);
-    for (size_t j = i + 1; j < components_.size(); ++j) {
-      xj_ch = get_characteristics(components_[j].first);
-      assoc_coefs = get_binary_associate_coefs(components_[i].first,
-                                               components_[j].first);
-      associate_V_part +=
-          components_[i].second * components_[j].second
-          * ((pow(assoc_coefs->V, 5.0) - 1.0) * pow(xi_ch->E * xj_ch->E, 2.5));
-    }
+/* Компоненты упорядочены, поэтому состав смеси - ключ кэша, а порядок
+ *   величин пар в кэше совпадает с порядком компонентов объекта */
+bool GasParametersGost30319Dyn::setFuncCoefficients() {
+  gost_coefs_cache::value cached = coefs_cache.Get(components_);
+  if (!cached.coefs) {
+    if (init_mix_terms())
+      return false;
+    auto coefs = std::make_shared<ng_gost30319_coefs>();
+    calculate_coefs(*coefs);
+    cached = coefs_cache.Insert(components_, {coefs, mix_terms_});
   }
-  associate_V_part *= 2.0;
-  V += associate_V_part;
-  V = pow(V, 0.2);
-  coef_V_ = V;
+  mix_terms_ = cached.terms;
+  kernel_ = std::make_shared<const Gost30319Kernel>(
+      components_, cached.coefs, mix_terms_, const_params.mp, use_iso20765_);
+  return true;
 }
 
-void GasParametersGost30319Dyn::set_Q() {
-  coef_Q_ = 0.0;
-  const component_characteristics* xi_ch = nullptr;
-  for (size_t i = 0; i < components_.size(); ++i) {
-    xi_ch = get_characteristics(components_[i].first);
-    coef_Q_ += components_[i].second * xi_ch->Q;
-  }
+void GasParametersGost30319Dyn::calculate_coefs(ng_gost30319_coefs& coefs) {
+  std::vector<double> x(components_.size());
+  for (size_t i = 0; i < components_.size(); ++i)
+    x[i] = components_[i].second;
+  calculate_ng_gost30319_coefs(*mix_terms_, x.data(), coefs);
 }
 
-void GasParametersGost30319Dyn::set_F() {
-  coef_F_ = 0.0;
-  const component_characteristics* xi_ch = nullptr;
-  for (size_t i = 0; i < components_.size(); ++i) {
-    xi_ch = get_characteristics(components_[i].first);
-    coef_F_ += pow(components_[i].second, 2.0) * xi_ch->F;
+Gost30319Kernel::Gost30319Kernel(
+    const ng_gost_mix& components,
+    std::shared_ptr<const ng_gost30319_coefs> coefs,
+    std::shared_ptr<const ng_gost30319_mix_terms> terms,
+    const molar_parameters& mp,
+    bool use_iso)
+    : components_(components),
+      coefs_(coefs),
+      mix_terms_(terms),
+      mp_(mp),
+      use_iso20765_(use_iso),
+      sigma_ref_(0.0) {
+#if defined(ISO_20765)
+  if (use_iso20765_)
+    CalculateSigma(101325.0, 298.15, 0.0, &sigma_ref_);
+#endif  // ISO_20765
+}
+
+merror_t Gost30319Kernel::Evaluate(double p,
+                                   double t,
+                                   double sigma_init,
+                                   ng_gost30319_state* state) const {
+  if (!InLimits(p, t))
+    return ERROR_CALCULATE_T;
+  ng_gost30319_tau_terms terms;
+  merror_t error = CalculateTauTerms(t, &terms);
+  if (error)
+    return error;
+  return Evaluate(p, terms, sigma_init, state);
+}
+
+merror_t Gost30319Kernel::Evaluate(double p,
+                                   const ng_gost30319_tau_terms& terms,
+                                   double sigma_init,
+                                   ng_gost30319_state* state) const {
+  const double t = terms.t;
+  if (!InLimits(p, t))
+    return ERROR_CALCULATE_T;
+  ng_gost30319_state st = ng_gost30319_state();
+  if (CalculateSigma(p, terms, sigma_init, &st.sigma))
+    return ERROR_CALC_MODEL_ST;
+  st.volume = pow(coefs_->kx, 3.0) / (mp_.mass * st.sigma);
+  st.params.cp0r = terms.cp0r;
+#if defined(ISO_20765)
+  if (use_iso20765_) {
+    merror_t error = set_iso_params(terms, st.sigma, st.params);
+    if (error)
+      return error;
+  } else
+#endif  // ISO_20765
+  {
+    set_gost_params(terms, st.sigma, st.params);
   }
+  calculate_dynamic(t, st.params);
+  *state = st;
+  return ERROR_SUCCESS_T;
 }
 
-void GasParametersGost30319Dyn::set_G() {
-  double G = 0.0;
-  const component_characteristics* xi_ch = nullptr;
-  for (size_t i = 0; i < components_.size(); ++i) {
-    xi_ch = get_characteristics(components_[i].first);
-    if (xi_ch == nullptr) {
-      error_.SetError(ERROR_INIT_T, "undefined component in gost model");
-      return;
-    }
-    G += components_[i].second * xi_ch->G;
-  }
-  double associate_G_part = 0.0;
-  const binary_associate_coef* assoc_coefs = nullptr;
-  const component_characteristics* xj_ch = nullptr;
-  for (size_t i = 0; i < components_.size() - 1; ++i) {
-    xi_ch = get_characteristics(components_[i].first);
-    for (size_t j = i + 1; j < components_.size(); ++j) {
-      xj_ch = get_characteristics(components_[j].first);
-      assoc_coefs = get_binary_associate_coefs(components_[i].first,
-                                               components_[j].first);
-      associate_G_part += components_[i].second * components_[j].second
-                          * ((assoc_coefs->G - 1.0) * (xi_ch->G + xj_ch->G));
+merror_t Gost30319Kernel::EvaluateIsotherm(double t,
+                                           const double* p,
+                                           size_t count,
+                                           ng_gost30319_state* states) const {
+  ng_gost30319_tau_terms terms;
+  merror_t error = CalculateTauTerms(t, &terms);
+  if (error) {
+    std::fill(states, states + count, ng_gost30319_state());
+    return error;
+  }
+  double z_prev = 0.0;
+  for (size_t i = 0; i < count; ++i) {
+    // начальное приближение по фактору сжимаемости в предыдущей точке
+    double sigma_init =
+        (is_above0(z_prev)) ? SigmaStart(p[i], t) / z_prev : 0.0;
+    merror_t point_error = Evaluate(p[i], terms, sigma_init, &states[i]);
+    if (point_error) {
+      error = point_error;
+      states[i] = ng_gost30319_state();
     }
+    z_prev = states[i].params.z;
   }
-  G += associate_G_part;
-  coef_G_ = G;
+  return error;
 }
 
-void GasParametersGost30319Dyn::set_Bn() {
-  size_t n_max = A0_3_coefs_count;
-  if (!Bn_.empty())
-    Bn_.clear();
-  Bn_.assign(n_max, 0.0);
-  const component_characteristics* xi_ch = nullptr;
-  const component_characteristics* xj_ch = nullptr;
-  const binary_associate_coef* assoc_coef = nullptr;
-  for (size_t n = 0; n < n_max; ++n) {
-    // set Bnij
-    const A0_3_coef& A3c = A0_3_coefs[n];
-    for (size_t i = 0; i < components_.size(); ++i) {
-      xi_ch = get_characteristics(components_[i].first);
-      for (size_t j = 0; j < components_.size(); ++j) {
-        xj_ch = get_characteristics(components_[j].first);
-        assoc_coef = get_binary_associate_coefs(components_[i].first,
-                                                components_[j].first);
-        double Gij = assoc_coef->G * (xi_ch->G + xj_ch->G) / 2.0;
-        double Bnij = pow(Gij + 1.0 - A3c.g, A3c.g)
-                      * pow(xi_ch->Q * xj_ch->Q + 1.0 - A3c.q, A3c.q)
-                      * pow(sqrt(xi_ch->F * xj_ch->F) + 1.0 - A3c.f, A3c.f)
-                      * pow(xi_ch->S * xj_ch->S + 1.0 - A3c.s, A3c.s)
-                      * pow(xi_ch->W * xj_ch->W + 1.0 - A3c.w, A3c.w);
-        double Eij = assoc_coef->E * sqrt(xi_ch->E * xj_ch->E);
-        Bn_[n] += components_[i].second * components_[j].second * Bnij
-                  * pow(Eij, A3c.u) * pow(xi_ch->K * xj_ch->K, 1.5);
+merror_t Gost30319Kernel::EvaluateBatch(const double* p,
+                                        const double* t,
+                                        size_t count,
+                                        ng_gost30319_state* states) const {
+  lane_coefs lc;
+  lc.kx3 = 1.0 / (coefs_->kx * coefs_->kx * coefs_->kx);
+  for (size_t n = 0; n < A0_3_coefs_count; ++n) {
+    lc.Dn[n] = (n < 12)   ? coefs_->Bn[n] * lc.kx3
+               : (n < 18) ? coefs_->Bn[n] * lc.kx3 - coefs_->Cn[n]
+                          : 0.0;
+    lc.Cn[n] = coefs_->Cn[n];
+  }
+  for (size_t n = 0; n < Bn_count; ++n)
+    lc.Bn[n] = coefs_->Bn[n];
+  lc.Rm = mp_.Rm;
+  lc.sigma_ref = sigma_ref_;
+  lc.use_iso = use_iso20765_;
+  bool is_lanes = !use_iso20765_ || is_above0(sigma_ref_);
+  for (const auto& c : components_) {
+    const A4_coef* cpc = get_A4_coefs(c.first);
+    const component_characteristics* x_ch = get_characteristics(c.first);
+    if (cpc == nullptr || x_ch == nullptr || !is_above0(c.second)) {
+      is_lanes = false;
+      break;
+    }
+    const bool is_noble = gas_char::IsNoble(c.first);
+    lc.components.push_back(
+        {cpc, c.second, std::log(c.second),
+         (is_noble) ? 1.0 : x_ch->M / (1000.0 * GAS_CONSTANT), is_noble});
+  }
+  merror_t error = ERROR_SUCCESS_T;
+  /* коэффициентов компонента нет, ошибку для каждой точки вернёт
+   *   расчёт по одной точке */
+  if (!is_lanes) {
+    for (size_t i = 0; i < count; ++i) {
+      merror_t point_error = Evaluate(p[i], t[i], 0.0, &states[i]);
+      if (point_error) {
+        error = point_error;
+        states[i] = ng_gost30319_state();
+      }
+    }
+    return error;
+  }
+  const double kx3 = pow(coefs_->kx, 3.0);
+  lane_block b;
+  double z_prev[ATHERM_LANES] = {0.0};
+  bool is_active[ATHERM_LANES];
+  for (size_t i0 = 0; i0 < count; i0 += ATHERM_LANES) {
+    const size_t lanes = std::min<size_t>(ATHERM_LANES, count - i0);
+    for (size_t l = 0; l < ATHERM_LANES; ++l) {
+      is_active[l] = l < lanes && InLimits(p[i0 + l], t[i0 + l]);
+      // свободные дорожки заполняются допустимой точкой
+      const double pl = (is_active[l]) ? p[i0 + l] : 1.0e+6,
+                   tl = (is_active[l]) ? t[i0 + l] : 300.0;
+      b.t[l] = tl;
+      b.tau[l] = Lt / tl;
+      b.pi[l] = 0.000001 * pl / coefs_->p0m;
+      // начальное приближение по фактору сжимаемости предыдущего блока
+      b.sigma[l] = (is_above0(z_prev[l])) ? SigmaStart(pl, tl) / z_prev[l]
+                                          : SigmaStart(pl, tl);
+    }
+    set_lane_tau_terms(lc, b);
+    set_lane_sigma(lc, b);
+#if defined(ISO_20765)
+    if (use_iso20765_)
+      set_lane_fi(lc, b);
+    else
+#endif  // ISO_20765
+      set_lane_gost(lc, b);
+    for (size_t l = 0; l < lanes; ++l) {
+      const size_t i = i0 + l;
+      merror_t point_error = ERROR_SUCCESS_T;
+      if (!is_active[l]) {
+        point_error = ERROR_CALCULATE_T;
+      } else if (!is_above0(b.sigma[l])) {
+        point_error = Evaluate(p[i], t[i], 0.0, &states[i]);
+      } else {
+        ng_gost30319_state& st = states[i];
+        st = ng_gost30319_state();
+        st.sigma = b.sigma[l];
+        st.volume = kx3 / (mp_.mass * st.sigma);
+        ng_gost30319_params& ps = st.params;
+        ps.cp0r = b.cp0r[l];
+#if defined(ISO_20765)
+        if (use_iso20765_) {
+          ps.fi0r = b.fi0r[l];
+          ps.fi0r_t = b.fi0r_t[l];
+          ps.fi0r_tt = b.fi0r_tt[l];
+          ps.B = b.B[l];
+          ps.fi = b.fi[l];
+          ps.fi_t = b.fi_t[l];
+          ps.fi_tt = b.fi_tt[l];
+          ps.fi_d = b.fi_d[l];
+          ps.fi_1 = b.fi_1[l];
+          ps.fi_2 = b.fi_2[l];
+          ps.z = st.sigma * ps.fi_d;
+        } else
+#endif  // ISO_20765
+        {
+          ps.A0 = b.A0[l];
+          ps.A1 = b.A1[l];
+          ps.A2 = b.A2[l];
+          ps.A3 = b.A3[l];
+          ps.z = 1.0 + ps.A0;
+        }
+        calculate_dynamic(t[i], ps);
       }
+      if (point_error) {
+        error = point_error;
+        states[i] = ng_gost30319_state();
+      }
+      z_prev[l] = states[i].params.z;
     }
   }
+  return error;
 }
 
-void GasParametersGost30319Dyn::set_Cn() {
-  size_t n_max = A0_3_coefs_count;
-  if (!Cn_.empty())
-    Cn_.clear();
-  Cn_.assign(n_max, 0.0);
-  for (size_t n = 0; n < n_max; ++n) {
-    const A0_3_coef& A3c = A0_3_coefs[n];
-    Cn_[n] = pow(coef_G_ + 1.0 - A3c.g, A3c.g)
-             * pow(coef_Q_ * coef_Q_ + 1.0 - A3c.q, A3c.q)
-             * pow(coef_F_ + 1.0 - A3c.f, A3c.f) * pow(coef_V_, A3c.u);
+merror_t Gost30319Kernel::CalculateTauTerms(
+    double t,
+    ng_gost30319_tau_terms* terms) const {
+  set_a_tu(t, *terms);
+  merror_t error = set_cp0r(*terms);
+#if defined(ISO_20765)
+  if (use_iso20765_ && !error) {
+    set_coefB(*terms);
+    set_coefC(*terms);
+    error = set_fi0r(*terms);
+  }
+#endif  // ISO_20765
+  return error;
+}
+
+merror_t Gost30319Kernel::CalculateSigma(double p,
+                                         double t,
+                                         double sigma_init,
+                                         double* sigma) const {
+  ng_gost30319_tau_terms terms;
+  set_a_tu(t, terms);
+  return CalculateSigma(p, terms, sigma_init, sigma);
+}
+
+merror_t Gost30319Kernel::CalculateSigma(double p,
+                                         const ng_gost30319_tau_terms& terms,
+                                         double sigma_init,
+                                         double* sigma) const {
+  return calculate_sigma(*coefs_, p, terms, sigma_init, sigma);
+}
+
+/* check 07_11_19 */
+double Gost30319Kernel::SigmaStart(double p, double t) const {
+  return sigma_start(*coefs_, p, t);
+}
+
+bool Gost30319Kernel::InLimits(double p, double t) {
+  /* ckeck pressure[0.1, 30.0]MPa, temperature[250,350]K */
+  return gost_30319_within(p, t);
+}
+
+const ng_gost_mix& Gost30319Kernel::GetComponents() const {
+  return components_;
+}
+
+const ng_gost30319_coefs& Gost30319Kernel::GetCoefs() const {
+  return *coefs_;
+}
+
+const molar_parameters& Gost30319Kernel::GetMolarParameters() const {
+  return mp_;
+}
+
+bool Gost30319Kernel::IsIso20765() const {
+  return use_iso20765_;
+}
+
+merror_t Gost30319Kernel::calculate_sigma(const ng_gost30319_coefs& coefs,
+                                          double p,
+                                          const ng_gost30319_tau_terms& terms,
+                                          double sigma_init,
+                                          double* sigma) {
+  const double t = terms.t;
+  const double tau = t / Lt, pi = 0.000001 * p / coefs.p0m;
+  const double sigm_cold = sigma_start(coefs, p, t);
+  double sigm = is_above0(sigma_init) ? sigma_init : sigm_cold;
+  /* Производная функции sigma * (1 + A0) по приведённой плотности
+   *   равна (1 + A1), поэтому невязка и её производная берутся из
+   *   одного расчёта функций A0-A3 */
+  for (int loop = 0; loop < sigma_loop_max; ++loop) {
+    ng_gost30319_A0_3 a = calculate_A0_3(coefs, terms.a_tu.data(), sigm);
+    const double ds = (pi / tau - (1.0 + a.A0) * sigm) / (1.0 + a.A1);
+    if (std::abs(sigm * tau * (1.0 + a.A0) - pi) / pi < sigma_accuracy) {
+      /* уже рассчитанная поправка Ньютона уточняет результат до
+       *   ~sigma_accuracy^2, что важно для производных по T */
+      *sigma = sigm + ds;
+      return ERROR_SUCCESS_T;
+    }
+    sigm += ds;
+    if (!std::isfinite(sigm) || !is_above0(sigm))
+      break;
   }
+  // начальное приближение из предыдущей точки могло оказаться неудачным
+  if (!is_equal(sigm_cold, sigma_init) && is_above0(sigma_init))
+    return calculate_sigma(coefs, p, terms, 0.0, sigma);
+  return ERROR_CALC_MODEL_ST;
 }
 
-void GasParametersGost30319Dyn::set_p0m() {
-  coef_p0m_ = 0.001 * pow(coef_kx_, -3.0) * GAS_CONSTANT * Lt;
+double Gost30319Kernel::sigma_start(const ng_gost30319_coefs& coefs,
+                                    double p,
+                                    double t) {
+  return 0.001 * p * pow(coefs.kx, 3.0) / (GAS_CONSTANT * t);
 }
 
-merror_t GasParametersGost30319Dyn::set_cp0r() {
+merror_t Gost30319Kernel::set_cp0r(ng_gost30319_tau_terms& terms) const {
   merror_t error = ERROR_SUCCESS_T;
   double cp0r = 0.0;
-  const double tet = Lt / vpte_.temperature;
+  const double tet = Lt / terms.t;
   auto pow_sinh = [tet](double C, double D) {
     // for carbon monoxide we get nan
     return (is_equal(D, 0.0)) ? 0.0 : C * pow(D * tet / sinh(D * tet), 2.0);
@@ -461,113 +1245,223 @@ merror_t GasParametersGost30319Dyn::set_cp0r() {
             * x_ch->M / (1000.0 * GAS_CONSTANT);
       }
     } else {
-      error = error_.SetError(ERROR_INIT_T,
-                              "ГОСТ модель: cp0r, не распознан компонент");
+      // ГОСТ модель: cp0r, не распознан компонент
+      error = ERROR_INIT_T;
     }
   }
-  ng_gost_params_.cp0r = cp0r * const_params.mp.Rm;
+  terms.cp0r = cp0r * mp_.Rm;
   return error;
 }
 
+void Gost30319Kernel::set_gost_params(const ng_gost30319_tau_terms& terms,
+                                      double sigma,
+                                      ng_gost30319_params& ps) const {
+  ng_gost30319_A0_3 a = calculate_A0_3(*coefs_, terms.a_tu.data(), sigma);
+  ps.A0 = a.A0;
+  ps.A1 = a.A1;
+  ps.A2 = a.A2;
+  ps.A3 = a.A3;
+  ps.z = 1.0 + ps.A0;
+}
+
 #if defined(ISO_20765)
-merror_t GasParametersGost30319Dyn::set_fi0r() {
-  merror_t error = ERROR_SUCCESS_T;
+merror_t Gost30319Kernel::set_fi0r(ng_gost30319_tau_terms& terms) const {
   double fi0r = 0.0, fi0r_t = 0.0;
   double fi0r_tt = 0.0;
-  const double tau = Lt / vpte_.temperature, tauT = Lt / 298.15;
-  const double sigm = calculate_sigma(vpte_.pressure, vpte_.temperature),
-               sigmT = calculate_sigma(101325.0, 298.15);
+  const double tau = Lt / terms.t;
   auto pow_sinh = [tau](double C, double D) {
     return (is_equal(D, 0.0)) ? 0.0 : C * pow(D / sinh(D * tau), 2.0);
   };
   auto pow_cosh = [tau](double C, double D) {
     return C * pow(D / cosh(D * tau), 2.0);
   };
-  if (is_above0(sigm) && is_above0(sigmT)) {
-    const double appendix = std::log(tauT / tau) + std::log(sigm / sigmT);
-    auto ln_sinh = [tau](double C, double D) {
-      return (is_equal(D, 0.0)) ? 0.0 : C * std::log(sinh(D * tau));
-    };
-    auto ln_cosh = [tau](double C, double D) {
-      return C * std::log(cosh(D * tau));
-    };
-    auto sinh_cosh = [tau](double C, double D) {
-      return C * D * sinh(D * tau) / cosh(D * tau);
-    };
-    auto cosh_sinh = [tau](double C, double D) {
-      return (is_equal(D, 0.0)) ? 0.0 : C * D * cosh(D * tau) / sinh(D * tau);
-    };
-    const A4_coef* cpc = nullptr;
-    for (size_t i = 0; i < components_.size(); ++i) {
-      cpc = get_A4_coefs(components_[i].first);
-      if (cpc != nullptr) {
-        // by Appex B of ISO 20765
-        fi0r += components_[i].second
-                * (cpc->A1 + cpc->A2 * tau + cpc->B * std::log(tau)
-                   + ln_sinh(cpc->C, cpc->D) - ln_cosh(cpc->E, cpc->F)
-                   + ln_sinh(cpc->G, cpc->H) - ln_cosh(cpc->I, cpc->J)
-                   + std::log(components_[i].second));
-        fi0r_t += components_[i].second
-                  * (cpc->A2 + (cpc->B - 1.0) / tau + cosh_sinh(cpc->C, cpc->D)
-                     - sinh_cosh(cpc->E, cpc->F) + cosh_sinh(cpc->G, cpc->H)
-                     - sinh_cosh(cpc->I, cpc->J));
-        fi0r_tt += components_[i].second
-                   * (-(cpc->B - 1.0) / tau / tau - pow_sinh(cpc->C, cpc->D)
-                      - pow_cosh(cpc->E, cpc->F) - pow_sinh(cpc->G, cpc->H)
-                      - pow_cosh(cpc->I, cpc->J));
-      } else {
-        error = error_.SetError(ERROR_INIT_T,
-                                "ГОСТ модель: fi0r, не распознан компонент");
-        break;
-      }
-    }
-    ng_gost_params_.fi0r = fi0r + appendix;
-    ng_gost_params_.fi0r_t = fi0r_t;
-    ng_gost_params_.fi0r_tt = fi0r_tt;
-  } else {
-    error = error_.SetError(ERROR_INIT_T,
-                            "ГОСТ модель: fi0r, результат "
-                            "расчёта приведённой плотности некорректен.");
+  auto ln_sinh = [tau](double C, double D) {
+    return (is_equal(D, 0.0)) ? 0.0 : C * std::log(sinh(D * tau));
+  };
+  auto ln_cosh = [tau](double C, double D) {
+    return C * std::log(cosh(D * tau));
+  };
+  auto sinh_cosh = [tau](double C, double D) {
+    return C * D * sinh(D * tau) / cosh(D * tau);
+  };
+  auto cosh_sinh = [tau](double C, double D) {
+    return (is_equal(D, 0.0)) ? 0.0 : C * D * cosh(D * tau) / sinh(D * tau);
+  };
+  const A4_coef* cpc = nullptr;
+  for (size_t i = 0; i < components_.size(); ++i) {
+    // ГОСТ модель: fi0r, не распознан компонент
+    if ((cpc = get_A4_coefs(components_[i].first)) == nullptr)
+      return ERROR_INIT_T;
+    // by Appex B of ISO 20765
+    fi0r += components_[i].second
+            * (cpc->A1 + cpc->A2 * tau + cpc->B * std::log(tau)
+               + ln_sinh(cpc->C, cpc->D) - ln_cosh(cpc->E, cpc->F)
+               + ln_sinh(cpc->G, cpc->H) - ln_cosh(cpc->I, cpc->J)
+               + std::log(components_[i].second));
+    fi0r_t += components_[i].second
+              * (cpc->A2 + (cpc->B - 1.0) / tau + cosh_sinh(cpc->C, cpc->D)
+                 - sinh_cosh(cpc->E, cpc->F) + cosh_sinh(cpc->G, cpc->H)
+                 - sinh_cosh(cpc->I, cpc->J));
+    fi0r_tt += components_[i].second
+               * (-(cpc->B - 1.0) / tau / tau - pow_sinh(cpc->C, cpc->D)
+                  - pow_cosh(cpc->E, cpc->F) - pow_sinh(cpc->G, cpc->H)
+                  - pow_cosh(cpc->I, cpc->J));
+  }
+  terms.fi0r = fi0r;
+  terms.fi0r_t = fi0r_t;
+  terms.fi0r_tt = fi0r_tt;
+  return ERROR_SUCCESS_T;
+}
+
+merror_t Gost30319Kernel::set_iso_params(const ng_gost30319_tau_terms& terms,
+                                         double sigma,
+                                         ng_gost30319_params& ps) const {
+  // ГОСТ модель: fi0r, результат расчёта приведённой плотности некорректен
+  if (!is_above0(sigma) || !is_above0(sigma_ref_))
+    return ERROR_INIT_T;
+  const double tau = Lt / terms.t, tauT = Lt / 298.15;
+  ps.fi0r = terms.fi0r + std::log(tauT / tau) + std::log(sigma / sigma_ref_);
+  ps.fi0r_t = terms.fi0r_t;
+  ps.fi0r_tt = terms.fi0r_tt;
+  ps.B = terms.B;
+  set_fi(terms, sigma, ps);
+  ps.z = sigma * ps.fi_d;
+  return ERROR_SUCCESS_T;
+}
+
+void Gost30319Kernel::set_coefB(ng_gost30319_tau_terms& terms) const {
+  terms.B = 0.0, terms.B_t = 0.0, terms.B_tt = 0.0;
+  for (size_t n = 0; n < Bn_count; ++n) {
+    const double u = A0_3_coefs[n].u;
+    const double d1 = terms.a_tu[n] * coefs_->Bn[n];
+    terms.B += d1;
+    terms.B_t += u * d1;
+    terms.B_tt += u * (u - 1.0) * d1;
+  }
+}
+
+void Gost30319Kernel::set_coefC(ng_gost30319_tau_terms& terms) const {
+  terms.C = 0.0, terms.C_t = 0.0, terms.C_tt = 0.0;
+  for (size_t n = 12; n < Bn_count; ++n) {
+    const double u = A0_3_coefs[n].u;
+    const double d1 = terms.a_tu[n] * coefs_->Cn[n];
+    terms.C += d1;
+    terms.C_t += u * d1;
+    terms.C_tt += u * (u - 1.0) * d1;
   }
-  return error;
+}
+
+/* Члены 1-18 при Bn и 13-18 при -Cn * sigma от плотности зависят
+ *   линейно, их суммы рассчитаны для температуры в set_coefB и
+ *   set_coefC. Для членов 13-58 функция и все производные
+ *   набираются за один проход с общими sigma^b и exp(-sigma^k) */
+void Gost30319Kernel::set_fi(const ng_gost30319_tau_terms& terms,
+                             double sigma,
+                             ng_gost30319_params& ps) const {
+  const double tau = Lt / terms.t;
+  const double s_k = sigma / (coefs_->kx * coefs_->kx * coefs_->kx);
+  double fi = ps.fi0r + ps.B * s_k - sigma * terms.C,
+         fi_t = tau * ps.fi0r_t + s_k * terms.B_t - sigma * terms.C_t,
+         fi_tt = tau * tau * ps.fi0r_tt + s_k * terms.B_tt
+                 - sigma * terms.C_tt,
+         fi_d = 1.0 + ps.B * s_k - sigma * terms.C,
+         fi_1 = 1.0 + 2.0 * ps.B * s_k - 2.0 * sigma * terms.C,
+         fi_2 = 1.0 - s_k * (terms.B_t - terms.B)
+                + sigma * (terms.C_t - terms.C);
+
+  // 13 - 58
+  const sigma_powers sp(sigma);
+  for (size_t n = 12; n < A0_3_coefs_count; ++n) {
+    const A0_3_coef& A3c = A0_3_coefs[n];
+    const double csk = sp.Csk(A3c);
+    const double d1 =
+        terms.a_tu[n] * coefs_->Cn[n] * sp.Pow(A3c) * sp.Exp(A3c);
+    const double k3 = A3c.b - A3c.k * csk;
+    const double d3 = d1 * k3;
+    fi += d1;
+    fi_t += A3c.u * d1;
+    fi_tt += A3c.u * (A3c.u - 1.0) * d1;
+    fi_d += d3;
+    fi_1 += d1 * (k3 - A3c.k * A3c.k * csk + k3 * k3);
+    fi_2 += d3 * (1.0 - A3c.u);
+  }
+
+  ps.fi = fi;
+  ps.fi_t = fi_t / tau;
+  ps.fi_tt = fi_tt / tau / tau;
+  ps.fi_d = fi_d / sigma;
+  ps.fi_1 = fi_1;
+  ps.fi_2 = fi_2;
 }
 #endif  // ISO_20765
 
+void Gost30319Kernel::calculate_dynamic(double t,
+                                        ng_gost30319_params& ps) const {
+  double Rm = mp_.Rm;
+#if defined(ISO_20765)
+  ps.u = 0.0;
+  ps.h = 0.0;
+  ps.s = 0.0;
+  ps.cv = 0.0;
+  ps.cp = 0.0;
+  if (use_iso20765_) {
+    double tau = Lt / t;
+    ps.u = ps.fi_t * Rm;
+    ps.h = ps.u + ps.z * Rm * t;
+    ps.s = (tau * ps.fi_t - ps.fi) * Rm;
+    ps.cv = -tau * tau * ps.fi_tt * Rm;
+    ps.cp = ps.cv + ps.fi_2 * ps.fi_2 * Rm / ps.fi_1;
+    ps.k = ps.fi_1 * ps.cp / (ps.z * ps.cv);
+    ps.w = std::sqrt(ps.z * ps.k * t * Rm);
+  } else
+#endif  // ISO_20765
+  {
+    auto tk = 1.0 + ps.A1
+              + std::pow(1.0 + ps.A2, 2.0) / (ps.cp0r - 1.0 + ps.A3);
+    ps.k = tk / ps.z;
+    ps.w = sqrt(Rm * tk * t);
+  }
+}
+
 merror_t GasParametersGost30319Dyn::set_volume() {
   merror_t error = ERROR_INIT_T;
   if (status_ != STATUS_HAVE_ERROR) {
-    if (inLimits(vpte_.pressure, vpte_.temperature)) {
-      double sigma = calculate_sigma(vpte_.pressure, vpte_.temperature);
-      vpte_.volume = pow(coef_kx_, 3.0) / (const_params.mp.mass * sigma);
-      bool is_valid = (set_cp0r() == ERROR_SUCCESS_T);
-#if defined(ISO_20765)
-      if (use_iso20765_ && is_valid) {
-        if ((is_valid = (set_fi0r() == ERROR_SUCCESS_T))) {
-          set_iso_params(sigma);
-        }
-      } else
-#endif  // ISO_20765
-      {
-        if (is_valid)
-          set_gost_params(sigma);
-      }
+    if (!(error = calculate_state())) {
       update_dynamic();
+      status_ = STATUS_OK;
     } else {
-      Logging::Append(ERROR_CALCULATE_T, "check ng_gost limits");
       status_ = STATUS_NOT;
-      error = ERROR_CALCULATE_T;
     }
   }
   // function end
   return error;
 }
 
-void GasParametersGost30319Dyn::set_gost_params(double sigma) {
-  ng_gost_params_.A0 = calculate_A0(vpte_.temperature, sigma);
-  ng_gost_params_.A1 = calculate_A1(vpte_.temperature, sigma);
-  ng_gost_params_.A2 = calculate_A2(vpte_.temperature, sigma);
-  ng_gost_params_.A3 = calculate_A3(vpte_.temperature, sigma);
-  ng_gost_params_.z = 1.0 + ng_gost_params_.A0;
+merror_t GasParametersGost30319Dyn::calculate_state() {
+  /* начальное приближение по фактору сжимаемости в предыдущей
+   *   точке, для соседних точек изотерм и изобар он меняется мало */
+  double sigma_init =
+      (is_above0(ng_gost_params_.z))
+          ? kernel_->SigmaStart(vpte_.pressure, vpte_.temperature)
+                / ng_gost_params_.z
+          : 0.0;
+  // слагаемые, зависящие от температуры, пересчитываются при её смене
+  merror_t error = ERROR_SUCCESS_T;
+  if (!is_equal(tau_terms_.t, vpte_.temperature)) {
+    if ((error = kernel_->CalculateTauTerms(vpte_.temperature, &tau_terms_)))
+      tau_terms_.t = 0.0;
+  }
+  ng_gost30319_state st;
+  if (!error)
+    error = kernel_->Evaluate(vpte_.pressure, tau_terms_, sigma_init, &st);
+  if (error) {
+    log_state_error(error, vpte_.pressure, vpte_.temperature);
+    ng_gost_params_.z = 0.0;
+    return error;
+  }
+  vpte_.volume = st.volume;
+  ng_gost_params_ = st.params;
+  return ERROR_SUCCESS_T;
 }
 
 void GasParametersGost30319Dyn::set_viscosity0() {
@@ -583,184 +1477,8 @@ void GasParametersGost30319Dyn::set_viscosity0() {
   // assert(0);
 }
 
-double GasParametersGost30319Dyn::get_Dn(size_t n) const {
-  if (n < 12)
-    return Bn_[n] * pow(coef_kx_, -3.0);
-  else if (n >= 12 && n < 18)
-    return Bn_[n] * pow(coef_kx_, -3.0) - Cn_[n];
-  return 0.0;
-}
-
-double GasParametersGost30319Dyn::get_Un(size_t n) const {
-  if (n < 12)
-    return 0.0;
-  return Cn_[n];
-}
-
-#if defined(ISO_20765)
-void GasParametersGost30319Dyn::set_iso_params(double sigma) {
-  // calculate functions
-  set_coefB(vpte_.temperature);
-  set_fi(vpte_.temperature, sigma);
-  set_fi_der(vpte_.temperature, sigma);
-
-  // set parameters
-  ng_gost_params_.z = sigma * ng_gost_params_.fi_d;
-}
-
-void GasParametersGost30319Dyn::set_coefB(double t) {
-  double tau = 1.0 / t;
-  ng_gost_params_.B = 0.0;
-  for (size_t n = 0; n < 18; ++n) {
-    ng_gost_params_.B +=
-        A0_3_coefs[n].a * Bn_[n] * std::pow(tau, A0_3_coefs[n].u);
-  }
-}
-
-void GasParametersGost30319Dyn::set_fi(double t, double sigma) {
-  double tau = Lt / t;
-  ng_gost_params_.fi = ng_gost_params_.fi0r
-                       + ng_gost_params_.B * sigma / std::pow(coef_kx_, 3.0);
-  double c1 = 0.0, c2 = 0.0;
-  for (size_t n = 12; n < 18; ++n)
-    c1 += A0_3_coefs[n].a * Cn_[n] * std::pow(tau, A0_3_coefs[n].u);
-  c1 *= sigma;
-  for (size_t n = 12; n < 58; ++n)
-    c2 += A0_3_coefs[n].a * Cn_[n] * std::pow(tau, A0_3_coefs[n].u)
-          * std::pow(sigma, A0_3_coefs[n].b)
-          * std::exp(-A0_3_coefs[n].c * std::pow(sigma, A0_3_coefs[n].k));
-  ng_gost_params_.fi += -c1 + c2;
-}
-
-/* наверное излишне оптимизировано */
-void GasParametersGost30319Dyn::set_fi_der(double t, double sigma) {
-  double tau = Lt / t;
-  double s_k = sigma / pow(coef_kx_, 3.0);
-  double fi_t = tau * ng_gost_params_.fi0r_t,
-         fi_tt = tau * tau * ng_gost_params_.fi0r_tt,
-         fi_d = 1.0 + ng_gost_params_.B * s_k,
-         fi_1 = 1.0 + 2.0 * ng_gost_params_.B * s_k, fi_2 = 1.0;
-  double dfi_t = 0.0, dfi_tt = 0.0, dfi_d = 0.0, dfi_1 = 0.0, dfi_2 = 0.0;
-
-  // 1 - 18
-  for (size_t n = 0; n < 18; ++n) {
-    const A0_3_coef& A3c = A0_3_coefs[n];
-    double d1 = A3c.a * Bn_[n] * pow(tau, A3c.u);
-    double d2 = (A3c.u - 1.0) * d1;
-    dfi_t += A3c.u * d1;
-    dfi_tt += A3c.u * d2;
-    dfi_2 += -d2;
-  }
-  fi_t += s_k * dfi_t;
-  fi_tt += s_k * dfi_tt;
-  fi_2 += s_k * dfi_2;
-
-  // 13 - 18
-  dfi_t = 0.0, dfi_tt = 0.0, dfi_d = 0.0, dfi_1 = 0.0, dfi_2 = 0.0;
-  for (size_t n = 12; n < 18; ++n) {
-    const A0_3_coef& A3c = A0_3_coefs[n];
-    double d1 = A3c.a * Cn_[n] * pow(tau, A3c.u);
-    double d2 = (A3c.u - 1.0) * d1;
-    dfi_t += A3c.u * d1;
-    dfi_tt += A3c.u * d2;
-    dfi_d += d1;
-    dfi_1 += d1;
-    dfi_2 += -d2;
-  }
-  fi_t += -sigma * dfi_t;
-  fi_tt += -sigma * dfi_tt;
-  fi_d += -sigma * dfi_d;
-  fi_1 += -2.0 * sigma * dfi_1;
-  fi_2 += -sigma * dfi_2;
-
-  // 13 - 58
-  dfi_t = 0.0, dfi_tt = 0.0, dfi_d = 0.0, dfi_1 = 0.0, dfi_2 = 0.0;
-  for (size_t n = 12; n < 58; ++n) {
-    const A0_3_coef& A3c = A0_3_coefs[n];
-    double d1 = A3c.a * Cn_[n] * pow(tau, A3c.u) * pow(sigma, A3c.b)
-                * exp(-A3c.c * pow(sigma, A3c.k));
-    double d2 = A3c.u * (A3c.u - 1.0) * d1;
-    double k3 = A3c.b - A3c.c * A3c.k * pow(sigma, A3c.k);
-    double d3 = d1 * k3;
-    double d4 =
-        d1 * (k3 - pow(A3c.k, 2.0) * A3c.c * pow(sigma, A3c.k) + pow(k3, 2.0));
-    double d5 = d3 * (1.0 - A3c.u);
-    dfi_t += A3c.u * d1;
-    dfi_tt += d2;
-    dfi_d += d3;
-    dfi_1 += d4;
-    dfi_2 += d5;
-  }
-  fi_t += dfi_t;
-  fi_tt += dfi_tt;
-  fi_d += dfi_d;
-  fi_1 += dfi_1;
-  fi_2 += dfi_2;
-
-  ng_gost_params_.fi_t = fi_t / tau;
-  ng_gost_params_.fi_tt = fi_tt / tau / tau;
-  ng_gost_params_.fi_d = fi_d / sigma;
-  ng_gost_params_.fi_1 = fi_1;
-  ng_gost_params_.fi_2 = fi_2;
-}
-#endif  // ISO_20765
-
-double GasParametersGost30319Dyn::calculate_sigma(double p, double t) const {
-  double sigm = sigma_start(p, t), tau = t / Lt;
-  double A0 = calculate_A0(t, sigm);
-  // todo: remove magic numbers!!!
-  double pi_calc = sigm * tau * (1.0 + A0), pi = 0.000001 * p / coef_p0m_;
-  int loop_max = 3000;
-  while (--loop_max > 0) {
-    if (abs(pi_calc - pi) / pi < 0.000001)
-      break;
-    sigm += calculate_d_sigm(t, p, sigm);
-    A0 = calculate_A0(t, sigm);
-    pi_calc = sigm * tau * (1.0 + A0);
-  }
-#ifdef _DEBUG
-  if (loop_max == 0)
-    assert(0 && "so many roads but assert");
-#else
-  assert(0);
-  // set error, break procedure
-#endif  // _DEBUG
-  return sigm;
-}
-
 void GasParametersGost30319Dyn::update_dynamic() {
-  std::map<dyn_setup, double> params;
-  double Rm = const_params.mp.Rm;
-#if defined(ISO_20765)
-  ng_gost_params_.u = 0.0;
-  ng_gost_params_.h = 0.0;
-  ng_gost_params_.s = 0.0;
-  ng_gost_params_.cv = 0.0;
-  ng_gost_params_.cp = 0.0;
-  if (use_iso20765_) {
-    double tau = Lt / vpte_.temperature;
-    ng_gost_params_.u = ng_gost_params_.fi_t * Rm;
-    ng_gost_params_.h =
-        ng_gost_params_.u + (ng_gost_params_.z) * Rm * vpte_.temperature;
-    ng_gost_params_.s = (tau * ng_gost_params_.fi_t - ng_gost_params_.fi) * Rm;
-    ng_gost_params_.cv = -tau * tau * ng_gost_params_.fi_tt * Rm;
-    ng_gost_params_.cp = ng_gost_params_.cv
-                         + ng_gost_params_.fi_2 * ng_gost_params_.fi_2 * Rm
-                               / ng_gost_params_.fi_1;
-    ng_gost_params_.k = ng_gost_params_.fi_1 * ng_gost_params_.cp
-                        / (ng_gost_params_.z * ng_gost_params_.cv);
-    ng_gost_params_.w = std::sqrt(ng_gost_params_.z * ng_gost_params_.k
-                                  * vpte_.temperature * Rm);
-  } else
-#endif  // ISO_20765
-  {
-    auto t = 1.0 + ng_gost_params_.A1
-             + std::pow(1.0 + ng_gost_params_.A2, 2.0)
-                   / (ng_gost_params_.cp0r - 1.0 + ng_gost_params_.A3);
-    ng_gost_params_.k = t / ng_gost_params_.z;
-    ng_gost_params_.w = sqrt(Rm * t * vpte_.temperature);
-  }
-  params = {
+  std::map<dyn_setup, double> params = {
 #if defined(ISO_20765)
     {DYNAMIC_HEAT_CAP_PRES, ng_gost_params_.cp},
     {DYNAMIC_HEAT_CAP_VOL, ng_gost_params_.cv},
@@ -774,98 +1492,124 @@ void GasParametersGost30319Dyn::update_dynamic() {
 }
 
 merror_t GasParametersGost30319Dyn::inLimits(double p, double t) {
-  /* ckeck pressure[0.1, 30.0]MPa, temperature[250,350]K */
-  return gost_30319_within(p, t);
+  return Gost30319Kernel::InLimits(p, t);
 }
 
-/* check 07_11_19 */
-double GasParametersGost30319Dyn::sigma_start(double p, double t) const {
-  return 0.001 * p * pow(coef_kx_, 3.0) / (GAS_CONSTANT * t);
-}
-
-/* check 07_11_19 */
-double GasParametersGost30319Dyn::calculate_d_sigm(double t,
-                                                   double p,
-                                                   double sigm) const {
-  double tau = t / Lt, pi = 0.000001 * p / coef_p0m_,
-         d_sigm = (pi / tau - (1.0 + calculate_A0(t, sigm)) * sigm)
-                  / (1.0 + calculate_A1(t, sigm));
-  return d_sigm;
+void GasParametersGost30319Dyn::csetParameters(double v,
+                                               double p,
+                                               double t,
+                                               state_phase) {
+  (void)v;
+  vpte_.pressure = p;
+  vpte_.temperature = t;
+  set_volume();
 }
 
-//   dens is sigma, temp is tau
-/* check 07_11_19 */
-double GasParametersGost30319Dyn::calculate_A0(double t, double sigm) const {
-  double A0 = 0.0;
-  double tau = t / Lt;
-  for (size_t n = 0; n < A0_3_coefs_count; ++n) {
-    const A0_3_coef& A3c = A0_3_coefs[n];
-    A0 += A3c.a * pow(sigm, A3c.b) * pow(tau, -A3c.u)
-          * (A3c.b * get_Dn(n)
-             + (A3c.b - A3c.c * A3c.k * pow(sigm, A3c.k)) * get_Un(n)
-                   * exp(-A3c.c * pow(sigm, A3c.k)));
+double GasParametersGost30319Dyn::cCalculateVolume(double p, double t) {
+  if (status_ == STATUS_HAVE_ERROR)
+    return 0.0;
+  ng_gost30319_state st;
+  merror_t error = kernel_->Evaluate(p, t, 0.0, &st);
+  if (error) {
+    log_state_error(error, p, t);
+    return 0.0;
   }
-  return A0;
+  return st.volume;
 }
 
-/* check 07_11_19 */
-double GasParametersGost30319Dyn::calculate_A1(double t, double sigm) const {
-  double A1 = 0.0;
-  double tau = t / Lt;
-  for (size_t n = 0; n < A0_3_coefs_count; ++n) {
-    const A0_3_coef& A3c = A0_3_coefs[n];
-    A1 += A3c.a * pow(sigm, A3c.b) * pow(tau, -A3c.u)
-          * ((A3c.b + 1.0) * A3c.b * get_Dn(n)
-             + ((A3c.b - A3c.c * A3c.k * pow(sigm, A3c.k))
-                    * (A3c.b - A3c.c * A3c.k * pow(sigm, A3c.k) + 1.0)
-                - A3c.c * A3c.k * A3c.k * pow(sigm, A3c.k))
-                   * get_Un(n) * exp(-A3c.c * pow(sigm, A3c.k)));
+merror_t GasParametersGost30319Dyn::CalculateBatch(
+    const double* p,
+    const double* t,
+    size_t count,
+    ng_gost30319_batch& res) const {
+  if (status_ == STATUS_HAVE_ERROR)
+    return ERROR_INIT_T;
+  merror_t error = ERROR_SUCCESS_T;
+  auto set = [](double* arr, size_t i, double val) {
+    if (arr != nullptr)
+      arr[i] = val;
+  };
+  // точки рассчитываются частями, чтобы не держать состояния всех точек
+  const size_t part_max = 32 * ATHERM_LANES;
+  std::vector<ng_gost30319_state> states(std::min(count, part_max));
+  for (size_t i0 = 0; i0 < count; i0 += part_max) {
+    const size_t part = std::min(part_max, count - i0);
+    merror_t part_error =
+        kernel_->EvaluateBatch(p + i0, t + i0, part, states.data());
+    if (part_error)
+      error = part_error;
+    for (size_t j = 0; j < part; ++j) {
+      const size_t i = i0 + j;
+      const ng_gost30319_params& ps = states[j].params;
+      set(res.z, i, ps.z);
+      set(res.volume, i, states[j].volume);
+      set(res.k, i, ps.k);
+      set(res.w, i, ps.w);
+#if defined(ISO_20765)
+      set(res.u, i, ps.u);
+      set(res.h, i, ps.h);
+      set(res.s, i, ps.s);
+      set(res.cv, i, ps.cv);
+      set(res.cp, i, ps.cp);
+#endif  // ISO_20765
+    }
   }
-  return A1;
+  return error;
 }
 
-/* check 07_11_19 */
-double GasParametersGost30319Dyn::calculate_A2(double t, double sigm) const {
-  double A2 = 0.0;
-  double tau = t / Lt;
-  for (size_t n = 0; n < A0_3_coefs_count; ++n) {
-    const A0_3_coef& A3c = A0_3_coefs[n];
-    A2 += A3c.a * pow(sigm, A3c.b) * pow(tau, -A3c.u) * (1.0 - A3c.u)
-          * (A3c.b * get_Dn(n)
-             + (A3c.b - A3c.c * A3c.k * pow(sigm, A3c.k)) * get_Un(n)
-                   * exp(-A3c.c * pow(sigm, A3c.k)));
-  }
-  return A2;
+std::shared_ptr<const Gost30319Kernel> GasParametersGost30319Dyn::GetKernel()
+    const {
+  return kernel_;
 }
 
-/* check 07_11_19 */
-double GasParametersGost30319Dyn::calculate_A3(double t, double sigm) const {
-  double A3 = 0.0;
-  double tau = t / Lt;
-  for (size_t n = 0; n < A0_3_coefs_count; ++n) {
-    const A0_3_coef& A3c = A0_3_coefs[n];
-    A3 += A3c.a * pow(sigm, A3c.b) * pow(tau, -A3c.u) * (1.0 - A3c.u) * A3c.u
-          * (get_Dn(n) + get_Un(n) * exp(-A3c.c * pow(sigm, A3c.k)));
+merror_t GasParametersGost30319Dyn::UpdateComponents(
+    const ng_gost_mix& components) {
+  if (status_ == STATUS_HAVE_ERROR)
+    return ERROR_INIT_T;
+  // позиции новых долей в `components_`
+  std::vector<size_t> pos(components.size());
+  bool is_same = components.size() == components_.size();
+  for (size_t i = 0; i < components.size() && is_same; ++i) {
+    auto it = std::find_if(components_.begin(), components_.end(),
+                           [&components, i](const ng_gost_component& c) {
+                             return c.first == components[i].first;
+                           });
+    is_same = it != components_.end();
+    pos[i] = it - components_.begin();
   }
-  return A3;
-}
-
-void GasParametersGost30319Dyn::csetParameters(double v,
-                                               double p,
-                                               double t,
-                                               state_phase) {
-  (void)v;
-  vpte_.pressure = p;
-  vpte_.temperature = t;
-  set_volume();
+  if (!is_same) {
+    Logging::Append(ERROR_INIT_T,
+                    "ГОСТ модель: обновление состава смеси, "
+                    "набор компонентов не совпадает с исходным");
+    return ERROR_INIT_T;
+  }
+  if (!is_valid_limits(components, use_iso20765_)) {
+    Logging::Append(ERROR_INIT_T,
+                    "natural gas model update error:\n"
+                    "components limits check fail\n");
+    return ERROR_INIT_T;
+  }
+  for (size_t i = 0; i < components.size(); ++i)
+    components_[pos[i]].second = components[i].second;
+  molar_parameters mp;
+  mp.mass = 0.0;
+  for (size_t i = 0; i < components_.size(); ++i)
+    mp.mass += components_[i].second * mix_terms_->M[i];
+  mp.Rm = 1000.0 * GAS_CONSTANT / mp.mass;
+  const_params.mp = mp;
+  pseudocritic_ = calcPseudocriticVPT(components_, *mix_terms_);
+  /* блок коэффициентов не добавляется в кэш: составы при отслеживании
+   *   смеси по пробам почти не повторяются */
+  auto coefs = std::make_shared<ng_gost30319_coefs>();
+  calculate_coefs(*coefs);
+  kernel_ = std::make_shared<const Gost30319Kernel>(
+      components_, coefs, mix_terms_, mp, use_iso20765_);
+  tau_terms_.t = 0.0;
+  return set_volume();
 }
 
-double GasParametersGost30319Dyn::cCalculateVolume(double p, double t) {
-  parameters bpars = vpte_;
-  csetParameters(0.0, p, t, state_phase::GAS);
-  double v = vpte_.volume;
-  csetParameters(0.0, bpars.pressure, bpars.temperature, state_phase::GAS);
-  return v;
+parameters GasParametersGost30319Dyn::GetPseudocritic() const {
+  return pseudocritic_;
 }
 
 bool GasParametersGost30319Dyn::IsValid() {
@@ -19,8 +19,13 @@
 #define _CORE__GAS_PARAMETERS__GAS_NG_GOST30319_H_
 
 #include "asp_utils/ErrorWrap.h"
+#include "dual_number.h"
 #include "gas_description_static.h"
+#include "gas_ng_gost_defines.h"
 
+#include <array>
+#include <cmath>
+#include <memory>
 #include <vector>
 
 // Размерности, константы, параметры при НФУ см. в первой части ГОСТ 30319,
@@ -87,6 +92,562 @@ struct ng_gost30319_params {
 #endif  // ISO_20765
 };
 
+/**
+ * \brief Значения функций A0, A1, A2, A3 ГОСТ модели
+ *   для одной пары (температура, приведённая плотность)
+ * */
+template <class T>
+struct basic_ng_gost30319_A0_3 {
+  T A0, A1, A2, A3;
+};
+typedef basic_ng_gost30319_A0_3<double> ng_gost30319_A0_3;
+
+/**
+ * \brief Коэффициенты расчётных функций ГОСТ модели, зависящие
+ *   только от состава смеси
+ * \note После расчёта блок не изменяется и разделяется всеми
+ *   объектами с одинаковым составом смеси, см. `setFuncCoefficients`
+ * */
+template <class T>
+struct basic_ng_gost30319_coefs {
+  T kx;
+  T V, Q, F, G, p0m;
+  std::vector<T> Bn;
+  std::vector<T> Cn;
+};
+typedef basic_ng_gost30319_coefs<double> ng_gost30319_coefs;
+
+/**
+ * \brief Величины для расчёта коэффициентов смеси, не зависящие от
+ *   мольных долей компонентов: характеристики компонентов и слагаемые
+ *   пар компонентов (i, j), i <= j, в порядке обхода `for i, for j >= i`
+ * \note Слагаемые пар с i != j уже учитывают равное им слагаемое (j, i).
+ *   При изменении долей компонентов коэффициенты смеси пересчитываются
+ *   по этим величинам без обращения к таблицам ГОСТ 30319.3 и без pow
+ * */
+struct ng_gost30319_mix_terms {
+  /// молярные массы компонентов
+  std::vector<double> M;
+  /// параметры Q, F, G компонентов
+  std::vector<double> Q, F, G;
+  /// факторы ацентричности компонентов
+  std::vector<double> acentric;
+  /// слагаемые пар для kx^5 и V^5
+  std::vector<double> K5, V5;
+  /// слагаемые пар бинарной части G
+  std::vector<double> Gij;
+  /// слагаемые пар для псевдокритических объёма и температуры
+  std::vector<double> pc_volume, pc_temperature;
+  /// слагаемые пар для Bn, по `Bn_count` значений на пару
+  std::vector<double> Bn;
+};
+
+/**
+ * \brief Рассчитать коэффициенты расчётных функций для мольных
+ *   долей x[i] компонентов, по которым рассчитаны terms
+ * \note Для T = dual<N>(dual_number.h) коэффициенты несут производные
+ *   по долям компонентов
+ * */
+template <class T>
+void calculate_ng_gost30319_coefs(const ng_gost30319_mix_terms& terms,
+                                  const T* x,
+                                  basic_ng_gost30319_coefs<T>& coefs) {
+  using std::pow;
+  T K5 = T(0.0), V5 = T(0.0), G = T(0.0), associate_G_part = T(0.0);
+  coefs.Q = T(0.0);
+  coefs.F = T(0.0);
+  coefs.Bn.assign(A0_3_coefs_count, T(0.0));
+  const double* Bnij = terms.Bn.data();
+  size_t ij = 0;
+  for (size_t i = 0; i < terms.M.size(); ++i) {
+    coefs.Q += x[i] * terms.Q[i];
+    coefs.F += x[i] * x[i] * terms.F[i];
+    G += x[i] * terms.G[i];
+    for (size_t j = i; j < terms.M.size(); ++j, ++ij, Bnij += Bn_count) {
+      const T xij = x[i] * x[j];
+      K5 += xij * terms.K5[ij];
+      V5 += xij * terms.V5[ij];
+      associate_G_part += xij * terms.Gij[ij];
+      // Bn используются только для n < Bn_count
+      for (size_t n = 0; n < Bn_count; ++n)
+        coefs.Bn[n] += xij * Bnij[n];
+    }
+  }
+  coefs.kx = pow(K5, 0.2);
+  coefs.V = pow(V5, 0.2);
+  coefs.G = G + associate_G_part;
+  /* Показатели g, q, f в таблице ГОСТ 30319.3 равны 0 или 1 */
+  coefs.Cn.resize(A0_3_coefs_count);
+  for (size_t n = 0; n < A0_3_coefs_count; ++n) {
+    const A0_3_coef& A3c = A0_3_coefs[n];
+    T Cn = pow(coefs.V, A3c.u);
+    if (A3c.g != 0.0)
+      Cn *= coefs.G;
+    if (A3c.q != 0.0)
+      Cn *= coefs.Q * coefs.Q;
+    if (A3c.f != 0.0)
+      Cn *= coefs.F;
+    coefs.Cn[n] = Cn;
+  }
+  coefs.p0m = 0.001 * pow(coefs.kx, -3.0) * GAS_CONSTANT * Lt;
+}
+
+/**
+ * \brief Выходные массивы пакетного расчёта параметров смеси
+ *   по ГОСТ 30319(ISO 20765) в формате "структура массивов"
+ * \note Каждый ненулевой указатель должен адресовать массив
+ *   на `count` элементов, нулевые указатели пропускаются
+ * */
+struct ng_gost30319_batch {
+  /// фактор сжимаемости
+  double* z;
+  /// удельный объём
+  double* volume;
+  /// показатель адиабаты
+  double* k;
+  /// скорость звука
+  double* w;
+#if defined(ISO_20765)
+  /// внутренняя энергия
+  double* u;
+  /// энтальпия
+  double* h;
+  /// энтропия
+  double* s;
+  /// удельная изохорная теплоёмкость
+  double* cv;
+  /// удельная изобарная теплоёмкость
+  double* cp;
+#endif  // ISO_20765
+};
+
+/**
+ * \brief Слагаемые расчётных функций ГОСТ(ISO) модели, зависящие
+ *   только от температуры при заданном составе смеси
+ * \note Рассчитываются `Gost30319Kernel::CalculateTauTerms` один раз
+ *   для изотермы и используются для всех давлений на ней
+ * */
+struct ng_gost30319_tau_terms {
+  /// температура
+  double t;
+  /// a[n] * pow(Lt / t, u[n]) для всех членов ряда `A0_3_coefs`
+  std::array<double, A0_3_coefs_count> a_tu;
+  /// изобарная теплоёмкость в идеальном состоянии
+  double cp0r;
+#if defined(ISO_20765)
+  /// коэффициент B
+  double B,
+      /// сумма u[n] * a_tu[n] * Bn[n], n < 18
+      B_t,
+      /// сумма u[n] * (u[n] - 1) * a_tu[n] * Bn[n], n < 18
+      B_tt;
+  /// сумма a_tu[n] * Cn[n], 12 <= n < 18
+  double C,
+      /// сумма u[n] * a_tu[n] * Cn[n], 12 <= n < 18
+      C_t,
+      /// сумма u[n] * (u[n] - 1) * a_tu[n] * Cn[n], 12 <= n < 18
+      C_tt;
+  /// энергия Гельмгольца идеального газа без слагаемого плотности
+  double fi0r,
+      /// первая производная fi0r по приведённой температуре
+      fi0r_t,
+      /// вторая производная fi0r по приведённой температуре
+      fi0r_tt;
+#endif  // ISO_20765
+};
+
+/**
+ * \brief Результат расчёта состояния смеси ГОСТ(ISO) моделью
+ *   для одной пары (давление, температура)
+ * */
+struct ng_gost30319_state {
+  /// удельный объём
+  double volume;
+  /// приведённая плотность
+  double sigma;
+  /// параметры ГОСТ(ISO) модели
+  ng_gost30319_params params;
+};
+
+/**
+ * \brief Удельный объём смеси в арифметике T, например
+ *   dual<N>(dual_number.h), см. `Gost30319Kernel::Evaluate`
+ * */
+template <class T>
+struct basic_ng_gost30319_volume {
+  /// удельный объём
+  T volume;
+  /// приведённая плотность
+  T sigma;
+  /// фактор сжимаемости 1 + A0
+  T z;
+};
+
+/**
+ * \brief Ядро расчёта параметров смеси по ГОСТ 30319(ISO 20765)
+ * \note Хранит только состав смеси и коэффициенты расчётных функций,
+ *   после создания не изменяется. Все методы константны и не имеют
+ *   побочных эффектов, поэтому один объект ядра можно разделить
+ *   между несколькими потоками
+ * */
+class Gost30319Kernel {
+  ADD_TEST_CLASS(GasParameters_NG_Gost_dynProxy);
+
+ public:
+  /**
+   * \param terms Не зависящие от долей величины для компонентов
+   *   components в том же порядке
+   * */
+  Gost30319Kernel(const ng_gost_mix& components,
+                  std::shared_ptr<const ng_gost30319_coefs> coefs,
+                  std::shared_ptr<const ng_gost30319_mix_terms> terms,
+                  const molar_parameters& mp,
+                  bool use_iso);
+  /**
+   * \brief Рассчитать состояние смеси
+   * \param p Давление
+   * \param t Температура
+   * \param sigma_init Начальное приближение приведённой плотности,
+   *   см. `CalculateSigma`
+   * \param state[out] Результат расчёта
+   *
+   * \return ERROR_SUCCESS_T, ERROR_CALCULATE_T если (p, t) вне границ
+   *   применимости модели, ERROR_CALC_MODEL_ST если не удалось
+   *   рассчитать приведённую плотность
+   * */
+  merror_t Evaluate(double p,
+                    double t,
+                    double sigma_init,
+                    ng_gost30319_state* state) const;
+  /**
+   * \brief Рассчитать состояние смеси по заранее рассчитанным
+   *   слагаемым для температуры terms.t
+   * \note См. `CalculateTauTerms`, `Evaluate(p, t, sigma_init, state)`
+   * */
+  merror_t Evaluate(double p,
+                    const ng_gost30319_tau_terms& terms,
+                    double sigma_init,
+                    ng_gost30319_state* state) const;
+  /**
+   * \brief Рассчитать удельный объём смеси в арифметике T, например
+   *   dual<N>(dual_number.h)
+   * \param x Мольные доли компонентов в порядке `GetComponents`,
+   *   nullptr - доли компонентов ядра
+   * \param state[out] Результат расчёта
+   *
+   * \return ERROR_SUCCESS_T, ERROR_CALCULATE_T если (p, t) вне границ
+   *   применимости модели, ERROR_CALC_MODEL_ST если не удалось
+   *   рассчитать приведённую плотность
+   *
+   * \note Приведённая плотность рассчитывается в double(`CalculateSigma`),
+   *   затем один шаг Ньютона по ней выполняется в арифметике T:
+   *   значение не меняется, а производные равны производным неявной
+   *   функции sigma(p, t, x). Доли x не нормируются, производные по
+   *   x[i] - частные
+   * */
+  template <class T>
+  merror_t Evaluate(const T& p,
+                    const T& t,
+                    const T* x,
+                    double sigma_init,
+                    basic_ng_gost30319_volume<T>* state) const;
+  template <class T>
+  merror_t Evaluate(const T& p,
+                    const T& t,
+                    double sigma_init,
+                    basic_ng_gost30319_volume<T>* state) const {
+    return Evaluate(p, t, static_cast<const T*>(nullptr), sigma_init, state);
+  }
+  /**
+   * \brief Рассчитать состояния смеси на изотерме t для давлений
+   *   p[i], i < count
+   * \param states[out] Массив на count элементов
+   *
+   * \return ERROR_SUCCESS_T или код ошибки последней точки, для
+   *   которой расчёт не удался(состояние такой точки обнулено)
+   *
+   * \note Зависящие от температуры слагаемые рассчитываются один раз,
+   *   каждая точка использует предыдущую как начальное приближение
+   * */
+  merror_t EvaluateIsotherm(double t,
+                            const double* p,
+                            size_t count,
+                            ng_gost30319_state* states) const;
+  /**
+   * \brief Рассчитать состояния смеси для точек (p[i], t[i]), i < count
+   * \param states[out] Массив на count элементов
+   *
+   * \return ERROR_SUCCESS_T или код ошибки последней точки, для
+   *   которой расчёт не удался(состояние такой точки обнулено)
+   *
+   * \note Точки рассчитываются блоками по ATHERM_LANES(lane_math.h):
+   *   зависящие от температуры слагаемые, итерации Ньютона для
+   *   приведённой плотности и функции модели считаются сразу для всех
+   *   точек блока векторными командами процессора. Начальное
+   *   приближение точки - результат точки на ATHERM_LANES раньше.
+   *   Точки, не сошедшиеся за фиксированное число итераций, пересчитываются
+   *   по одной `Evaluate`. Результат совпадает с `Evaluate` с точностью
+   *   до округления
+   * */
+  merror_t EvaluateBatch(const double* p,
+                         const double* t,
+                         size_t count,
+                         ng_gost30319_state* states) const;
+  /**
+   * \brief Рассчитать зависящие только от температуры слагаемые
+   *   расчётных функций
+   *
+   * \return ERROR_SUCCESS_T или ERROR_INIT_T, если для компонента
+   *   смеси нет коэффициентов теплоёмкости
+   * */
+  merror_t CalculateTauTerms(double t, ng_gost30319_tau_terms* terms) const;
+  /**
+   * \brief Пересчитать приведённую плотность методом Ньютона
+   * \param p Давление
+   * \param t Температура
+   * \param sigma_init Начальное приближение, например, по результатам
+   *   расчёта соседней точки. Если не положительно, то используется
+   *   приближение идеального газа `SigmaStart`
+   * \param sigma[out] Приведённая плотность
+   *
+   * \return ERROR_SUCCESS_T или ERROR_CALC_MODEL_ST, если итерационная
+   *   процедура не сошлась
+   * */
+  merror_t CalculateSigma(double p,
+                          double t,
+                          double sigma_init,
+                          double* sigma) const;
+  merror_t CalculateSigma(double p,
+                          const ng_gost30319_tau_terms& terms,
+                          double sigma_init,
+                          double* sigma) const;
+  /**
+   * \brief Получить первое приблежение для итерационной процедуры
+   *   поиска приведённой плотности
+   * */
+  double SigmaStart(double p, double t) const;
+  /**
+   * \brief Проверить допустимость применения модели для p, t
+   * */
+  static bool InLimits(double p, double t);
+  const ng_gost_mix& GetComponents() const;
+  const ng_gost30319_coefs& GetCoefs() const;
+  const molar_parameters& GetMolarParameters() const;
+  /**
+   * \brief Расчёт ведётся по методике ISO 20765
+   * */
+  bool IsIso20765() const;
+
+ private:
+  /**
+   * \brief Рассчитать функции A0, A1, A2, A3 за один проход
+   *   по коэффициентам `A0_3_coefs`
+   * \param a_tu Множители a[n] * pow(Lt / t, u[n]) для температуры
+   * \param sigm Приведённая плотность
+   *
+   * \note Степени sigma и экспоненты exp(-sigma^k) вычисляются
+   *   один раз для точки и разделяются между всеми членами ряда
+   * */
+  template <class T>
+  static basic_ng_gost30319_A0_3<T> calculate_A0_3(
+      const basic_ng_gost30319_coefs<T>& coefs,
+      const T* a_tu,
+      const T& sigm);
+  /**
+   * \brief Пересчитать приведённую плотность методом Ньютона для
+   *   коэффициентов coefs, см. `CalculateSigma`
+   * */
+  static merror_t calculate_sigma(const ng_gost30319_coefs& coefs,
+                                  double p,
+                                  const ng_gost30319_tau_terms& terms,
+                                  double sigma_init,
+                                  double* sigma);
+  static double sigma_start(const ng_gost30319_coefs& coefs,
+                            double p,
+                            double t);
+  /**
+   * \brief Рассчитать нулевое значение удельной теплоёмкости
+   * */
+  merror_t set_cp0r(ng_gost30319_tau_terms& terms) const;
+  /**
+   * \brief Установить параметры A0, A1, A2, A3
+   * \param sigma Приведённая плотность
+   * */
+  void set_gost_params(const ng_gost30319_tau_terms& terms,
+                       double sigma,
+                       ng_gost30319_params& ps) const;
+#if defined(ISO_20765)
+  /**
+   * \brief Рассчитать зависящую от температуры часть энергии
+   *   Гельмгольца идеального газа и её производные
+   * */
+  merror_t set_fi0r(ng_gost30319_tau_terms& terms) const;
+  /**
+   * \brief Рассчитать коэффициент B=B(tau) и суммы его членов,
+   *   входящие в производные свободной энергии по температуре
+   * */
+  void set_coefB(ng_gost30319_tau_terms& terms) const;
+  /**
+   * \brief Рассчитать суммы членов 13-18 при Cn, не зависящие
+   *   от плотности
+   * */
+  void set_coefC(ng_gost30319_tau_terms& terms) const;
+  /**
+   * \brief Установить данные для пересчёта параметров
+   *   модели по ISO20765
+   * \param sigma Приведённая плотность
+   * */
+  merror_t set_iso_params(const ng_gost30319_tau_terms& terms,
+                          double sigma,
+                          ng_gost30319_params& ps) const;
+  /**
+   * \brief Рассчитать значение свободной энергии и её производных
+   *   fi_t, fi_tt, fi_d, fi_1, fi_2 за один проход по членам ряда
+   * */
+  void set_fi(const ng_gost30319_tau_terms& terms,
+              double sigma,
+              ng_gost30319_params& ps) const;
+#endif  // ISO_20765
+  /**
+   * \brief Рассчитать показатель адиабаты, скорость звука и,
+   *   для ISO 20765, калорические параметры смеси
+   * */
+  void calculate_dynamic(double t, ng_gost30319_params& ps) const;
+
+ private:
+  /**
+   * \brief Контейнер компонентов смеси
+   * */
+  const ng_gost_mix components_;
+  /**
+   * \brief Коэффициенты расчётных функций для состава смеси
+   * */
+  const std::shared_ptr<const ng_gost30319_coefs> coefs_;
+  /**
+   * \brief Не зависящие от долей величины компонентов, по ним
+   *   коэффициенты пересчитываются для другого состава
+   * */
+  const std::shared_ptr<const ng_gost30319_mix_terms> mix_terms_;
+  const molar_parameters mp_;
+  /**
+   * \brief Расчёт по методике ISO 20765
+   * */
+  const bool use_iso20765_;
+  /**
+   * \brief Приведённая плотность смеси при стандартных условиях
+   *   (101325 Па, 298.15 К) для расчёта энергии Гельмгольца
+   *   идеального газа. Зависит только от состава смеси
+   * */
+  double sigma_ref_;
+};
+
+template <class T>
+merror_t Gost30319Kernel::Evaluate(const T& p,
+                                   const T& t,
+                                   const T* x,
+                                   double sigma_init,
+                                   basic_ng_gost30319_volume<T>* state) const {
+  using std::pow;
+  const double p_val = value_of(p), t_val = value_of(t);
+  if (!InLimits(p_val, t_val))
+    return ERROR_CALCULATE_T;
+  const size_t count = components_.size();
+  std::vector<T> xt(count);
+  std::vector<double> x_val(count);
+  T mass = T(mp_.mass);
+  if (x != nullptr) {
+    mass = T(0.0);
+    for (size_t i = 0; i < count; ++i) {
+      xt[i] = x[i];
+      x_val[i] = value_of(x[i]);
+      mass += x[i] * mix_terms_->M[i];
+    }
+  } else {
+    for (size_t i = 0; i < count; ++i)
+      xt[i] = T(components_[i].second);
+  }
+  basic_ng_gost30319_coefs<T> coefs;
+  calculate_ng_gost30319_coefs(*mix_terms_, xt.data(), coefs);
+  ng_gost30319_coefs coefs_val;
+  if (x != nullptr)
+    calculate_ng_gost30319_coefs(*mix_terms_, x_val.data(), coefs_val);
+  std::array<T, A0_3_coefs_count> a_tu;
+  ng_gost30319_tau_terms terms;
+  terms.t = t_val;
+  for (size_t n = 0; n < A0_3_coefs_count; ++n) {
+    a_tu[n] = A0_3_coefs[n].a * pow(Lt / t, A0_3_coefs[n].u);
+    terms.a_tu[n] = value_of(a_tu[n]);
+  }
+  double sigma = 0.0;
+  if (calculate_sigma((x != nullptr) ? coefs_val : *coefs_, p_val, terms,
+                      sigma_init, &sigma))
+    return ERROR_CALC_MODEL_ST;
+  /* Невязка sigma * (1 + A0) - pi / tau в найденной точке равна нулю
+   *   с точностью расчёта, её производная по sigma равна 1 + A1 */
+  const T tau = t / Lt, pi = 0.000001 * p / coefs.p0m;
+  const basic_ng_gost30319_A0_3<T> a =
+      calculate_A0_3(coefs, a_tu.data(), T(sigma));
+  const T ds = (pi / tau - (1.0 + a.A0) * sigma) / (1.0 + a.A1);
+  const T sigma_t = sigma + (ds - value_of(ds));
+  const T z = pi / (tau * sigma_t);
+  state->volume = pow(coefs.kx, 3.0) / (mass * sigma_t);
+  state->sigma = sigma_t;
+  state->z = (1.0 + value_of(a.A0)) + (z - value_of(z));
+  return ERROR_SUCCESS_T;
+}
+
+/* Слагаемые функций A0-A3 различаются только множителями при
+ *   общих для всех функций степенях и экспоненте, поэтому все четыре
+ *   суммы набираются за один проход. Коэффициенты Dn и Un:
+ *     n < 12:       Dn = Bn * Kx^-3,        Un = 0
+ *     12 <= n < 18: Dn = Bn * Kx^-3 - Cn,   Un = Cn
+ *     n >= 18:      Dn = 0,                 Un = Cn */
+template <class T>
+basic_ng_gost30319_A0_3<T> Gost30319Kernel::calculate_A0_3(
+    const basic_ng_gost30319_coefs<T>& coefs,
+    const T* a_tu,
+    const T& sigm) {
+  using std::exp;
+  basic_ng_gost30319_A0_3<T> a = {T(0.0), T(0.0), T(0.0), T(0.0)};
+  const T kx3 = 1.0 / (coefs.kx * coefs.kx * coefs.kx);
+  // sigma^b и exp(-sigma^k), общие для всех членов ряда
+  T pw[A0_3_b_max + 1], ex[A0_3_k_max + 1];
+  pw[0] = T(1.0);
+  for (size_t i = 1; i <= A0_3_b_max; ++i)
+    pw[i] = pw[i - 1] * sigm;
+  for (size_t i = 0; i <= A0_3_k_max; ++i)
+    ex[i] = exp(-pw[i]);
+  for (size_t n = 0; n < A0_3_coefs_count; ++n) {
+    const A0_3_coef& A3c = A0_3_coefs[n];
+    const T Dn = (n < 12)   ? coefs.Bn[n] * kx3
+                 : (n < 18) ? coefs.Bn[n] * kx3 - coefs.Cn[n]
+                            : T(0.0);
+    const T st = a_tu[n] * pw[static_cast<size_t>(A3c.b)];
+    // множители слагаемых A0(A2), A1 и A3 при общем st
+    T d0 = A3c.b * Dn;
+    T d1 = (A3c.b + 1.0) * A3c.b * Dn;
+    T d3 = Dn;
+    if (n >= 12) {
+      // множитель c равен 0 или 1, см. A0_3_coef
+      const T csk = A3c.c * pw[static_cast<size_t>(A3c.k)];
+      const T Une =
+          coefs.Cn[n]
+          * ((A3c.c == 0.0)   ? T(1.0)
+             : (A3c.c == 1.0) ? ex[static_cast<size_t>(A3c.k)]
+                              : exp(-csk));
+      const T bk = A3c.b - A3c.k * csk;
+      d0 += bk * Une;
+      d1 += (bk * (bk + 1.0) - A3c.k * A3c.k * csk) * Une;
+      d3 += Une;
+    }
+    a.A0 += st * d0;
+    a.A1 += st * d1;
+    a.A2 += st * (1.0 - A3c.u) * d0;
+    a.A3 += st * (1.0 - A3c.u) * A3c.u * d3;
+  }
+  return a;
+}
+
 // const_dyn_parameters init_natural_gas(const gost_ng_components &comps);
 /**
  * \brief Класс имплементирующий расчёты компрессированных газовых смесей
@@ -102,7 +663,56 @@ class GasParametersGost30319Dyn : public GasParameters {
  public:
   static GasParametersGost30319Dyn* Init(gas_params_input gpi, bool use_iso);
   void csetParameters(double v, double p, double t, state_phase) override;
+  /**
+   * \brief Рассчитать удельный объём для (p, t)
+   * \note Состояние объекта не изменяется
+   * */
   double cCalculateVolume(double p, double t) override;
+  /**
+   * \brief Рассчитать параметры смеси для массива точек
+   *   (p[i], t[i]), i < count
+   * \param res Выходные массивы
+   *
+   * \return ERROR_SUCCESS_T или код ошибки последней точки, для
+   *   которой расчёт не удался(результаты такой точки обнулены)
+   *
+   * \note Текущее состояние объекта не изменяется, динамические
+   *   параметры не пересобираются. Точки рассчитываются блоками,
+   *   см. `Gost30319Kernel::EvaluateBatch`, поэтому соседние точки
+   *   выгодно упорядочить по изотермам или изобарам
+   * */
+  merror_t CalculateBatch(const double* p,
+                          const double* t,
+                          size_t count,
+                          ng_gost30319_batch& res) const;
+  /**
+   * \brief Получить ядро расчёта параметров смеси
+   * \note Ядро не зависит от объекта и может использоваться
+   *   несколькими потоками одновременно
+   * */
+  std::shared_ptr<const Gost30319Kernel> GetKernel() const;
+  /**
+   * \brief Обновить мольные доли компонентов смеси
+   * \param components Тот же набор компонентов, что и при
+   *   инициализации(порядок может отличаться), с новыми долями
+   *
+   * \return ERROR_SUCCESS_T, ERROR_INIT_T если набор компонентов
+   *   отличается или доли вне допусков модели(состав смеси при этом
+   *   не меняется), либо код ошибки пересчёта состояния смеси
+   *
+   * \note Характеристики компонентов и их пар не пересчитываются,
+   *   коэффициенты kx, V, Q, F, G, Bn, Cn, молярная масса и
+   *   псевдокритические параметры собираются из `ng_gost30319_mix_terms`.
+   *   Ядро, полученное ранее через `GetKernel`, остаётся действительным
+   *   для прежнего состава
+   * */
+  merror_t UpdateComponents(const ng_gost_mix& components);
+  /**
+   * \brief Псевдокритические параметры смеси текущего состава
+   * \note `const_params.critical` неизменяемы и соответствуют
+   *   составу смеси при инициализации
+   * */
+  parameters GetPseudocritic() const;
   /**
    * \brief Проверить текущие параметры смеси
    * */
@@ -123,76 +733,50 @@ class GasParametersGost30319Dyn : public GasParameters {
    * \brief Инициализировать псевдокритические параметры смеси
    * */
   static parameters calcPseudocriticVPT(ng_gost_mix components);
-
   /**
-   * \brief Инициализировать коэффициенты расчётных функций
-   * \note Расчитываются только на старте программы
+   * \brief Рассчитать псевдокритические параметры смеси по
+   *   заранее рассчитанным слагаемым пар компонентов
    * */
-  bool setFuncCoefficients();
-  // init methods
-  merror_t init_kx();
-  void set_V();
-  void set_Q();
-  void set_F();
-  void set_G();
-  void set_Bn();
-  void set_Cn();
+  static parameters calcPseudocriticVPT(const ng_gost_mix& components,
+                                        const ng_gost30319_mix_terms& terms);
   /**
-   * \brief Рассчить медианные значения удельной теплоёмкости
-   *   и свободной энергии
-   * \note Расчитываются только на старте программы
+   * \brief Рассчитать слагаемые псевдокритических параметров смеси
    * */
-  void set_p0m();
+  static void init_pseudocritic_terms(const ng_gost_mix& components,
+                                      ng_gost30319_mix_terms& terms);
   /**
-   * \brief Установить нулевое значение удельной теплоёмкости
+   * \brief Рассчитать не зависящие от долей компонентов величины
+   *   для текущего набора компонентов
    * */
-  merror_t set_cp0r();
-#if defined(ISO_20765)
+  merror_t init_mix_terms();
+
   /**
-   * \brief Установить нулевое значение энергии Гельмгольца
-   *   и её производных
+   * \brief Инициализировать коэффициенты расчётных функций
+   *   и ядро расчёта
+   * \note Коэффициенты берутся из общего для процесса кэша, если
+   *   смесь такого состава уже рассчитывалась, иначе расчитываются
+   *   и добавляются в кэш
    * */
-  merror_t set_fi0r();
-#endif  // ISO_20765
+  bool setFuncCoefficients();
+  /**
+   * \brief Рассчитать коэффициенты расчётных функций по величинам
+   *   `mix_terms_` и текущим долям компонентов
+   * */
+  void calculate_coefs(ng_gost30319_coefs& coefs);
   /**
    * \brief Пересчитать параметры газовой смеси для новых значений
    *   давления и температуры
    * */
   merror_t set_volume();
   /**
-   * \brief Установить параметры A0, A1, A2, A3
-   * \param sigma Приведённая плотность
+   * \brief Рассчитать объём и параметры ГОСТ(ISO) модели для
+   *   текущих давления и температуры
+   * \note Не обновляет dyn_params_ и статус объекта
    * */
-  void set_gost_params(double sigma);
+  merror_t calculate_state();
   ///  calculate default value of viscosity(mU0)
   void set_viscosity0();
   // init methods end
-  double get_Dn(size_t n) const;
-  double get_Un(size_t n) const;
-#if defined(ISO_20765)
-  /**
-   * \brief Установить данные для пересчёта параметров
-   *   модели по ISO20765
-   * */
-  void set_iso_params(double sigma);
-  /**
-   * \brief Рассчитать коэффициент B=B(tau)
-   * */
-  void set_coefB(double t);
-  /**
-   * \brief Рассчитать значение свободной энергии
-   * */
-  void set_fi(double t, double sigma);
-  /**
-   * \brief Рассчитать значение производных свободной энергии
-   * */
-  void set_fi_der(double t, double sigma);
-#endif  // ISO_20765
-  /**
-   * \brief Пересчитать приведённую плотность
-   * \return Приведённая плотность
-   * */
-  double calculate_sigma(double p, double t) const;
   /**
    * \brief Обновить динамические параметры смеси
    * */
@@ -203,32 +787,34 @@ class GasParametersGost30319Dyn : public GasParameters {
    *
    * \param p Давление
    * \param t Температура
-   *
-   * \note Установит ошибку при несоответствии границ
    * */
   merror_t inLimits(double p, double t);
-  /**
-   * \brief Получить первое приблежение для итерационной процедуры
-   *   поиска приведённой плотности
-   * */
-  double sigma_start(double p, double t) const;
-  double calculate_d_sigm(double t, double p, double sigm) const;
-  double calculate_A0(double t, double sigm) const;
-  double calculate_A1(double t, double sigm) const;
-  double calculate_A2(double t, double sigm) const;
-  double calculate_A3(double t, double sigm) const;
   // void update_parametrs();
 
  private:
   /**
-   * \brief Контейнер компонентов смеси
+   * \brief Контейнер компонентов смеси, упорядочен по компонентам
    * */
   ng_gost_mix components_;
+  /**
+   * \brief Не зависящие от долей компонентов величины, разделяются
+   *   с ядром и кэшем коэффициентов
+   * */
+  std::shared_ptr<const ng_gost30319_mix_terms> mix_terms_;
+  /**
+   * \brief Псевдокритические параметры смеси текущего состава
+   * */
+  parameters pseudocritic_;
   ng_gost30319_params ng_gost_params_;
-  double coef_kx_;
-  double coef_V_, coef_Q_, coef_F_, coef_G_, coef_p0m_;
-  std::vector<double> Bn_;
-  std::vector<double> Cn_;
+  /**
+   * \brief Слагаемые расчётных функций для последней температуры,
+   *   при расчёте по изотерме рассчитываются один раз
+   * */
+  ng_gost30319_tau_terms tau_terms_;
+  /**
+   * \brief Ядро расчёта для текущего состава смеси
+   * */
+  std::shared_ptr<const Gost30319Kernel> kernel_;
   /**
    * \brief Расчёт по методике ISO 20765
    * */
@@ -0,0 +1,275 @@
+/**
+ * asp_therm - implementation of real gas equations of state
+ *
+ *
+ * Copyright (c) 2020-2021 Mishutinski Yurii
+ *
+ * This library is distributed under the MIT License.
+ * See LICENSE file in the project root for full license information.
+ */
+#include "gas_ng_gost30319_table.h"
+
+#include "asp_utils/Logging.h"
+#include "atherm_common.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+/* Область применимости ГОСТ 30319, см. `gost_30319_within` */
+const double table_p_min = 100000.0;
+const double table_p_max = 30000000.0;
+const double table_t_min = 250.0;
+const double table_t_max = 350.0;
+/** \brief Начальное число узлов сетки по давлению и температуре */
+const size_t start_p_nodes = 9;
+const size_t start_t_nodes = 5;
+/** \brief Максимальное число узлов таблицы */
+const size_t max_nodes = 1 << 20;
+/** \brief Индексы табулированных параметров */
+enum table_props { prop_z = 0, prop_k, prop_w, prop_h, prop_s };
+
+/**
+ * \brief Давление для координаты x = ln(p), с поправкой на
+ *   погрешность округления у границ области
+ * */
+double table_pressure(double x) {
+  return std::max(table_p_min, std::min(std::exp(x), table_p_max));
+}
+
+/**
+ * \brief Найти первый из 4 узлов интерполяции и веса
+ *   кубического многочлена Лагранжа
+ * \param pos Координата точки в шагах сетки
+ * \param nodes Число узлов сетки, не меньше 4
+ * */
+size_t cubic_stencil(double pos, size_t nodes, double* w) {
+  double cell = std::floor(pos);
+  cell = std::max(0.0, std::min(cell, double(nodes - 2)));
+  size_t first = (cell < 1.0) ? 0 : size_t(cell) - 1;
+  first = std::min(first, nodes - 4);
+  const double u = pos - double(first);
+  w[0] = -(u - 1.0) * (u - 2.0) * (u - 3.0) / 6.0;
+  w[1] = u * (u - 2.0) * (u - 3.0) / 2.0;
+  w[2] = -u * (u - 1.0) * (u - 3.0) / 2.0;
+  w[3] = u * (u - 1.0) * (u - 2.0) / 6.0;
+  return first;
+}
+}  // namespace
+
+Gost30319Table* Gost30319Table::Init(
+    std::shared_ptr<const Gost30319Kernel> kernel,
+    double tolerance) {
+  if (kernel == nullptr || !is_above0(tolerance)) {
+    Logging::Append(ERROR_INIT_T, "ГОСТ таблица: некорректные параметры");
+    return nullptr;
+  }
+  std::unique_ptr<Gost30319Table> table(new Gost30319Table(kernel));
+  size_t p_nodes = start_p_nodes, t_nodes = start_t_nodes;
+  double prev_error = 0.0;
+  while (p_nodes * t_nodes <= max_nodes) {
+    double p_error = 0.0, t_error = 0.0, c_error = 0.0;
+    if (table->set_nodes(p_nodes, t_nodes)
+        || table->check_nodes(&p_error, &t_error, &c_error)) {
+      Logging::Append(ERROR_CALC_MODEL_ST,
+                      "ГОСТ таблица: ошибка расчёта узлов таблицы");
+      return nullptr;
+    }
+    table->max_error_ = std::max(c_error, std::max(p_error, t_error));
+    if (table->max_error_ <= tolerance)
+      return table.release();
+    /* при сгущении сетки погрешность кубической интерполяции убывает
+     *   в разы, если этого не происходит, то она упёрлась в точность
+     *   итерационного расчёта приведённой плотности */
+    if (is_above0(prev_error) && table->max_error_ > 0.5 * prev_error)
+      break;
+    prev_error = table->max_error_;
+    // погрешность в центрах ячеек относим к оси с большей погрешностью
+    bool refine_p = p_error > tolerance;
+    bool refine_t = t_error > tolerance;
+    if (c_error > tolerance && !refine_p && !refine_t) {
+      refine_p = p_error >= t_error;
+      refine_t = !refine_p;
+    }
+    if (refine_p)
+      p_nodes = 2 * p_nodes - 1;
+    if (refine_t)
+      t_nodes = 2 * t_nodes - 1;
+  }
+  Logging::Append(ERROR_INIT_T,
+                  "ГОСТ таблица: заданная точность " + std::to_string(tolerance)
+                      + " не достигнута");
+  return nullptr;
+}
+
+Gost30319Table::Gost30319Table(std::shared_ptr<const Gost30319Kernel> kernel)
+    : kernel_(kernel),
+      props_count_(kernel->IsIso20765() ? 5 : 3),
+      x_min_(std::log(table_p_min)),
+      x_max_(std::log(table_p_max)),
+      x_step_(0.0),
+      t_min_(table_t_min),
+      t_max_(table_t_max),
+      t_step_(0.0),
+      p_nodes_(0),
+      t_nodes_(0),
+      max_error_(0.0) {}
+
+merror_t Gost30319Table::Get(double p,
+                             double t,
+                             ng_gost30319_table_value* res) const {
+  if (!Gost30319Kernel::InLimits(p, t))
+    return ERROR_CALCULATE_T;
+  double vals[5] = {0.0, 0.0, 0.0, 0.0, 0.0};
+  interpolate(std::log(p), t, vals);
+  res->z = vals[prop_z];
+  res->volume = vals[prop_z] * kernel_->GetMolarParameters().Rm * t / p;
+  res->k = vals[prop_k];
+  res->w = vals[prop_w];
+#if defined(ISO_20765)
+  res->h = vals[prop_h];
+  res->s = vals[prop_s];
+#endif  // ISO_20765
+  return ERROR_SUCCESS_T;
+}
+
+double Gost30319Table::GetMaxError() const {
+  return max_error_;
+}
+
+size_t Gost30319Table::GetPressureNodes() const {
+  return p_nodes_;
+}
+
+size_t Gost30319Table::GetTemperatureNodes() const {
+  return t_nodes_;
+}
+
+merror_t Gost30319Table::set_nodes(size_t p_nodes, size_t t_nodes) {
+  p_nodes_ = p_nodes;
+  t_nodes_ = t_nodes;
+  x_step_ = (x_max_ - x_min_) / double(p_nodes - 1);
+  t_step_ = (t_max_ - t_min_) / double(t_nodes - 1);
+  values_.assign(p_nodes * t_nodes * props_count_, 0.0);
+  ng_gost30319_state st;
+  ng_gost30319_tau_terms terms;
+  for (size_t it = 0; it < t_nodes; ++it) {
+    const double t = std::min(t_min_ + it * t_step_, t_max_);
+    merror_t error = kernel_->CalculateTauTerms(t, &terms);
+    if (error)
+      return error;
+    // вдоль изотермы начальное приближение берётся из предыдущего узла
+    st = ng_gost30319_state();
+    for (size_t ix = 0; ix < p_nodes; ++ix) {
+      const double p = table_pressure(x_min_ + ix * x_step_);
+      const double sigma_init =
+          (is_above0(st.params.z)) ? kernel_->SigmaStart(p, t) / st.params.z
+                                   : 0.0;
+      error = evaluate(p, terms, sigma_init, &st,
+                       &values_[(it * p_nodes + ix) * props_count_]);
+      if (error)
+        return error;
+    }
+  }
+  return ERROR_SUCCESS_T;
+}
+
+merror_t Gost30319Table::check_nodes(double* p_error,
+                                     double* t_error,
+                                     double* c_error) const {
+  *p_error = 0.0;
+  *t_error = 0.0;
+  *c_error = 0.0;
+  double error = 0.0;
+  merror_t res = ERROR_SUCCESS_T;
+  ng_gost30319_tau_terms terms, mid_terms;
+  for (size_t it = 0; it < t_nodes_ && !res; ++it) {
+    const double t = std::min(t_min_ + it * t_step_, t_max_);
+    if ((res = kernel_->CalculateTauTerms(t, &terms)))
+      break;
+    if (it + 1 < t_nodes_
+        && (res = kernel_->CalculateTauTerms(t + 0.5 * t_step_, &mid_terms)))
+      break;
+    // начальные приближения вдоль каждой из трёх линий проверки
+    ng_gost30319_state p_st = ng_gost30319_state();
+    ng_gost30319_state c_st = ng_gost30319_state();
+    ng_gost30319_state t_st = ng_gost30319_state();
+    for (size_t ix = 0; ix + 1 < p_nodes_ && !res; ++ix) {
+      const double x_mid = x_min_ + (ix + 0.5) * x_step_;
+      if (!(res = point_error(x_mid, terms, &p_st, &error)))
+        *p_error = std::max(*p_error, error);
+      if (it + 1 == t_nodes_ || res)
+        continue;
+      if (!(res = point_error(x_mid, mid_terms, &c_st, &error)))
+        *c_error = std::max(*c_error, error);
+      if (!res && !(res = point_error(x_mid - 0.5 * x_step_, mid_terms, &t_st,
+                                      &error)))
+        *t_error = std::max(*t_error, error);
+    }
+  }
+  return res;
+}
+
+merror_t Gost30319Table::point_error(double x,
+                                     const ng_gost30319_tau_terms& terms,
+                                     ng_gost30319_state* state,
+                                     double* error) const {
+  const double p = table_pressure(x);
+  const double t = terms.t;
+  double exact[5] = {0.0, 0.0, 0.0, 0.0, 0.0};
+  double approx[5] = {0.0, 0.0, 0.0, 0.0, 0.0};
+  const double sigma_init = (is_above0(state->params.z))
+                                ? kernel_->SigmaStart(p, t) / state->params.z
+                                : 0.0;
+  merror_t res = evaluate(p, terms, sigma_init, state, exact);
+  if (res)
+    return res;
+  interpolate(x, t, approx);
+  const double Rm = kernel_->GetMolarParameters().Rm;
+  *error = 0.0;
+  for (size_t i = 0; i < props_count_; ++i) {
+    double norm = std::abs(exact[i]);
+    if (i == prop_h)
+      norm = std::max(norm, Rm * t);
+    else if (i == prop_s)
+      norm = std::max(norm, Rm);
+    *error = std::max(*error, std::abs(approx[i] - exact[i]) / norm);
+  }
+  return ERROR_SUCCESS_T;
+}
+
+void Gost30319Table::interpolate(double x, double t, double* res) const {
+  double wx[4], wt[4];
+  const size_t fx = cubic_stencil((x - x_min_) / x_step_, p_nodes_, wx);
+  const size_t ft = cubic_stencil((t - t_min_) / t_step_, t_nodes_, wt);
+  for (size_t i = 0; i < props_count_; ++i)
+    res[i] = 0.0;
+  for (size_t jt = 0; jt < 4; ++jt) {
+    const double* row = &values_[((ft + jt) * p_nodes_ + fx) * props_count_];
+    for (size_t jx = 0; jx < 4; ++jx) {
+      const double w = wt[jt] * wx[jx];
+      for (size_t i = 0; i < props_count_; ++i)
+        res[i] += w * row[jx * props_count_ + i];
+    }
+  }
+}
+
+merror_t Gost30319Table::evaluate(double p,
+                                  const ng_gost30319_tau_terms& terms,
+                                  double sigma_init,
+                                  ng_gost30319_state* state,
+                                  double* res) const {
+  merror_t error = kernel_->Evaluate(p, terms, sigma_init, state);
+  if (error)
+    return error;
+  res[prop_z] = state->params.z;
+  res[prop_k] = state->params.k;
+  res[prop_w] = state->params.w;
+#if defined(ISO_20765)
+  if (props_count_ > prop_h) {
+    res[prop_h] = state->params.h;
+    res[prop_s] = state->params.s;
+  }
+#endif  // ISO_20765
+  return ERROR_SUCCESS_T;
+}
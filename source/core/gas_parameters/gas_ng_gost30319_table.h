@@ -0,0 +1,155 @@
+/**
+ * asp_therm - implementation of real gas equations of state
+ * ===================================================================
+ * * gas_ng_gost30319_table *
+ *   Табличный расчёт параметров природного газа по ГОСТ 30319
+ * (ISO 20765) для фиксированного состава смеси. Таблица строится
+ * один раз по всей области применимости модели, точность
+ * интерполяции проверяется по точному расчёту ядром модели.
+ * ===================================================================
+ *
+ * Copyright (c) 2020-2021 Mishutinski Yurii
+ *
+ * This library is distributed under the MIT License.
+ * See LICENSE file in the project root for full license information.
+ */
+#ifndef _CORE__GAS_PARAMETERS__GAS_NG_GOST30319_TABLE_H_
+#define _CORE__GAS_PARAMETERS__GAS_NG_GOST30319_TABLE_H_
+
+#include "gas_ng_gost30319.h"
+
+#include <memory>
+#include <vector>
+
+/**
+ * \brief Параметры смеси, получаемые из таблицы
+ * */
+struct ng_gost30319_table_value {
+  /// фактор сжимаемости
+  double z;
+  /// удельный объём
+  double volume;
+  /// показатель адиабаты
+  double k;
+  /// скорость звука
+  double w;
+#if defined(ISO_20765)
+  /// энтальпия, только для ядра ISO 20765
+  double h;
+  /// энтропия, только для ядра ISO 20765
+  double s;
+#endif  // ISO_20765
+};
+
+/**
+ * \brief Таблица параметров z, k, w (и h, s для ISO 20765) смеси
+ *   фиксированного состава по области применимости ГОСТ 30319:
+ *   давление 0.1-30 МПа, температура 250-350 К
+ *
+ * Узлы таблицы расположены равномерно по ln(p) и t, значения между
+ *   узлами восстанавливаются бикубической интерполяцией по 4x4 узлам.
+ *   При построении сетка сгущается отдельно по каждой оси, пока
+ *   погрешность интерполяции в серединах ячеек и их рёбер не станет
+ *   меньше заданной относительно точного расчёта ядром модели.
+ *   Для h и s погрешность отнесена к max(|h|, Rm * t) и max(|s|, Rm)
+ *   соответственно, т.к. эти функции проходят через ноль.
+ *
+ * \note После построения таблица не изменяется, методы чтения
+ *   константны и могут вызываться из нескольких потоков
+ * */
+class Gost30319Table {
+  ADD_TEST_CLASS(Gost30319TableProxy);
+
+ public:
+  /**
+   * \brief Построить таблицу для ядра kernel
+   * \param tolerance Допустимая относительная погрешность интерполяции
+   *
+   * \return nullptr, если не удалось рассчитать узлы таблицы или
+   *   достичь заданной точности при допустимом размере таблицы
+   *
+   * \note Приведённая плотность рассчитывается с относительной
+   *   точностью 1e-6, поэтому меньшая погрешность таблицы недостижима
+   * */
+  static Gost30319Table* Init(std::shared_ptr<const Gost30319Kernel> kernel,
+                              double tolerance);
+  /**
+   * \brief Получить параметры смеси для давления p и температуры t
+   *
+   * \return ERROR_SUCCESS_T или ERROR_CALCULATE_T, если (p, t)
+   *   вне области применимости модели
+   * */
+  merror_t Get(double p, double t, ng_gost30319_table_value* res) const;
+  /**
+   * \brief Максимальная погрешность интерполяции, полученная
+   *   при проверке таблицы
+   * */
+  double GetMaxError() const;
+  /**
+   * \brief Число узлов таблицы по давлению и по температуре
+   * */
+  size_t GetPressureNodes() const;
+  size_t GetTemperatureNodes() const;
+
+ private:
+  Gost30319Table(std::shared_ptr<const Gost30319Kernel> kernel);
+
+  /**
+   * \brief Рассчитать значения в узлах сетки p_nodes x t_nodes
+   * */
+  merror_t set_nodes(size_t p_nodes, size_t t_nodes);
+  /**
+   * \brief Проверить интерполяцию в серединах рёбер и ячеек сетки
+   * \param p_error[out] Погрешность в серединах рёбер по давлению
+   * \param t_error[out] Погрешность в серединах рёбер по температуре
+   * \param c_error[out] Погрешность в центрах ячеек
+   * */
+  merror_t check_nodes(double* p_error,
+                       double* t_error,
+                       double* c_error) const;
+  /**
+   * \brief Погрешность интерполяции в точке (x, terms.t), где x = ln(p)
+   * \param state[in,out] Состояние в соседней точке для начального
+   *   приближения, перезаписывается состоянием в (x, t)
+   * */
+  merror_t point_error(double x,
+                       const ng_gost30319_tau_terms& terms,
+                       ng_gost30319_state* state,
+                       double* error) const;
+  /**
+   * \brief Интерполировать значения параметров в точке (x, t)
+   * \param res[out] Массив на `props_count` значений
+   * */
+  void interpolate(double x, double t, double* res) const;
+  /**
+   * \brief Рассчитать параметры ядром модели
+   * \param res[out] Массив на `props_count` значений
+   * */
+  merror_t evaluate(double p,
+                    const ng_gost30319_tau_terms& terms,
+                    double sigma_init,
+                    ng_gost30319_state* state,
+                    double* res) const;
+
+ private:
+  std::shared_ptr<const Gost30319Kernel> kernel_;
+  /**
+   * \brief Число табулированных параметров:
+   *   z, k, w и h, s для ISO 20765
+   * */
+  size_t props_count_;
+  /**
+   * \brief Границы и шаг сетки по ln(p) и t
+   * */
+  double x_min_, x_max_, x_step_;
+  double t_min_, t_max_, t_step_;
+  size_t p_nodes_, t_nodes_;
+  /**
+   * \brief Значения в узлах, `props_count_` значений на узел,
+   *   узлы по давлению идут подряд
+   * */
+  std::vector<double> values_;
+  double max_error_;
+};
+
+#endif  // !_CORE__GAS_PARAMETERS__GAS_NG_GOST30319_TABLE_H_
@@ -13,18 +13,59 @@
 #include "atherm_common.h"
 #include "gas_defines.h"
 
-#include <stdint.h>
+#include <array>
 #include <limits>
 
+#include <stdint.h>
+
 #define GET_ARRAY_SIZE(M) (sizeof(M) / sizeof(M[0]))
 
+namespace {
+/**
+ * \brief Размер прямоадресуемых таблиц. Идентификаторы компонентов
+ *   ГОСТ модели лежат в диапазоне [GAS_TYPE_UNDEFINED, GAS_TYPE_WATER],
+ *   для прочих идентификаторов(в т.ч. следовых компонентов) данных нет
+ * */
+constexpr size_t gas_index_size = GAS_TYPE_WATER + 1;
+/** \brief Номер строки таблицы по идентификатору компонента, -1 - нет */
+typedef std::array<int16_t, gas_index_size> gas_index_t;
+/** \brief Номер строки таблицы по паре идентификаторов компонентов */
+typedef std::array<gas_index_t, gas_index_size> gas_pair_index_t;
+
+/**
+ * \brief Собрать индекс таблицы коэффициентов на этапе компиляции
+ * \note При повторе компонента используется первая строка,
+ *   как и в `get_coefs`
+ * */
+template <class NG_COEF_T, size_t N>
+constexpr gas_index_t make_gas_index(const NG_COEF_T (&coefs)[N]) {
+  gas_index_t index{};
+  for (size_t i = 0; i < gas_index_size; ++i)
+    index[i] = -1;
+  for (size_t i = N; i-- > 0;) {
+    if (coefs[i].gas_name < gas_index_size)
+      index[coefs[i].gas_name] = static_cast<int16_t>(i);
+  }
+  return index;
+}
+
+template <class NG_COEF_T, size_t N>
+const NG_COEF_T* get_indexed(const NG_COEF_T (&coefs)[N],
+                             const gas_index_t& index,
+                             gas_t gas_name) {
+  return (gas_name < gas_index_size && index[gas_name] >= 0)
+             ? &coefs[index[gas_name]]
+             : nullptr;
+}
+}  // namespace
+
 // clang-format off
 /* check 07_11_19 */
 // Параметры бинарного взаимодействия
 // const size_t gases_count = 13;
 /* checked 17_11_19 by ISO 20765-1:2005(E)
        excel with coefs look in Documents/studing */
-const component_characteristics gases[] = {
+constexpr component_characteristics gases[] = {
 // gas                  M        E           K          G         Q     F    S    W
 #ifdef ISO_20765
   {GAS_TYPE_HEPTANE,    100.204,  427.72263, 0.7525189, 0.337542, 0.0,  0.0, 0.0, 0.0},
@@ -54,14 +95,16 @@ const component_characteristics gases[] = {
   {GAS_TYPE_HYDROGEN,    2.0159,  26.957940, 0.3514916, 0.034369, 0.0,  0.0, 0.0, 0.0}
 };
 
+static constexpr gas_index_t gases_index = make_gas_index(gases);
+
 const component_characteristics *get_characteristics(gas_t gas_name) {
-  return get_coefs(gases, GET_ARRAY_SIZE(gases), gas_name);
+  return get_indexed(gases, gases_index, gas_name);
 }
 
 // const size_t binary_associate_count = 38;
 /* checked 17_11_19 by ISO 20765-1:2005(E)
        excel with coefs look in Documents/studing */
-const binary_associate_coef gases_coef[] = {
+constexpr binary_associate_coef gases_coef[] = {
 // gas i                gas j                     E         V         K         G
 #ifdef ISO_20765
   {GAS_TYPE_METHANE,  GAS_TYPE_HEPTANE,           0.88088,  1.191904, 0.983565, 1.0},
@@ -144,29 +187,32 @@ const binary_associate_coef gases_coef[] = {
   {GAS_TYPE_UNDEFINED,  GAS_TYPE_UNDEFINED,       1.000000, 1.000000, 1.000000, 1.0}
 };
 
-const binary_associate_coef *get_binary_associate_coefs(gas_t i, gas_t j) {
-  if (j > i)
-    std::swap(i, j);
-  size_t bin_coef_count = sizeof(gases_coef) / sizeof(gases_coef[0]);
-  size_t z = 0;
-  for (; z < bin_coef_count; ++z)
-    if (gases_coef[z].i == i) 
-      break;
-  // undefined gas or gas isn't in list
-  if (z >= bin_coef_count - 1)
-    return &(gases_coef[bin_coef_count - 1]);
-  while (gases_coef[z].i == i) {
-    if (gases_coef[z].j == j)
-      return &(gases_coef[z]);
-    ++z;
+/* Коэффициенты симметричны, строки таблицы gases_coef заданы для одного
+ *   порядка пары, поэтому матрица заполняется для (i, j) и (j, i).
+ *   Для пар без данных - последняя строка с единичными значениями */
+static constexpr gas_pair_index_t make_binary_index() {
+  constexpr size_t count = GET_ARRAY_SIZE(gases_coef);
+  gas_pair_index_t index{};
+  for (size_t i = 0; i < gas_index_size; ++i)
+    for (size_t j = 0; j < gas_index_size; ++j)
+      index[i][j] = static_cast<int16_t>(count - 1);
+  for (size_t z = count - 1; z-- > 0;) {
+    index[gases_coef[z].i][gases_coef[z].j] = static_cast<int16_t>(z);
+    index[gases_coef[z].j][gases_coef[z].i] = static_cast<int16_t>(z);
   }
-  return &(gases_coef[bin_coef_count - 1]);
+  return index;
+}
+static constexpr gas_pair_index_t binary_index = make_binary_index();
+
+const binary_associate_coef *get_binary_associate_coefs(gas_t i, gas_t j) {
+  if (i >= gas_index_size || j >= gas_index_size)
+    return &gases_coef[GET_ARRAY_SIZE(gases_coef) - 1];
+  return &gases_coef[binary_index[i][j]];
 }
 
 /* checked 08_11_19 */
 /* checked 17_11_19 by ISO 20765-1:2005(E)
        excel with coefs look in Documents/studing */
-const size_t A0_3_coefs_count = 58;
 const A0_3_coef A0_3_coefs[] = {
 // a              b    c    k     u    g    q    f    s    w
   { 0.153832600,  1.0, 0.0, 0.0,  0.0, 0.0, 0.0, 0.0, 0.0, 0.0},  // 1
@@ -228,11 +274,13 @@ const A0_3_coef A0_3_coefs[] = {
   {-0.001226752,  9.0, 1.0, 2.0,  1.0, 0.0, 0.0, 0.0, 0.0, 0.0},  // 57
   { 0.002850908,  9.0, 1.0, 2.0,  0.0, 0.0, 1.0, 0.0, 0.0, 0.0}   // 58
 };
+static_assert(sizeof(A0_3_coefs) / sizeof(A0_3_coefs[0]) == A0_3_coefs_count,
+              "A0_3_coefs size mismatch");
 
 /* checked 08_11_19 */
 /* checked 18_11_19 by ISO 20765-1:2005(E)
        excel with coefs look in Documents/studing */
-const A4_coef A4_coefs[] = {
+constexpr A4_coef A4_coefs[] = {
 #ifdef ISO_20765
   {GAS_TYPE_HEPTANE,         57.77391, -57104.81056, 4.00000, 13.7266, 169.7890, 30.4707, 836.195, 43.55610, 1760.46,  0.00000,   0.000},
   {GAS_TYPE_OCTANE,          62.95591, -60546.76385, 4.00000, 15.6865, 158.9220, 33.8029, 815.064, 48.17310, 1693.07,  0.00000,   0.000},
@@ -258,12 +306,14 @@ const A4_coef A4_coefs[] = {
   {GAS_TYPE_HYDROGEN,        18.77280, - 5836.94370, 2.47906, 0.95806,  228.734, 0.45444, 326.843, 1.560390, 1651.71,  -1.3756, 1671.69},
 };
 
+static constexpr gas_index_t A4_index = make_gas_index(A4_coefs);
+
 const A4_coef *get_A4_coefs(gas_t gas_name) {
-  return get_coefs(A4_coefs, GET_ARRAY_SIZE(A4_coefs), gas_name);
+  return get_indexed(A4_coefs, A4_index, gas_name);
 }
 
 /* checked 08_11_19 */
-const critical_params A5_critical_params[] = {
+constexpr critical_params A5_critical_params[] = {
   {GAS_TYPE_METHANE,       190.564, 162.66, 0.064294},
   {GAS_TYPE_ETHANE,        305.320, 206.58, 0.109580},
   {GAS_TYPE_PROPANE,       369.825, 220.49, 0.184260},
@@ -278,12 +328,14 @@ const critical_params A5_critical_params[] = {
   {GAS_TYPE_HYDROGEN,      32.9380,  31.36, -0.12916}
 };
 
+static constexpr gas_index_t A5_index = make_gas_index(A5_critical_params);
+
 const critical_params *get_critical_params(gas_t gas_name) {
-  return get_coefs(A5_critical_params, GET_ARRAY_SIZE(A5_critical_params), gas_name);
+  return get_indexed(A5_critical_params, A5_index, gas_name);
 }
 
 /* not used 11_08_2019 */
-const A6_coef A6_coefs[] = {
+constexpr A6_coef A6_coefs[] = {
   {GAS_TYPE_HYDROGEN,      -0.279070091, 7.81221301,  -0.699863421, 0.0378831186},
   {GAS_TYPE_CARBON_DIOXIDE,-0.468233636, 5.37907799,  -0.034963335, -0.0126198032},
   {GAS_TYPE_METHANE,       -0.838029104, 4.88406903,  -0.344504244, 0.0151593109},
@@ -298,8 +350,10 @@ const A6_coef A6_coefs[] = {
   {GAS_TYPE_HYDROGEN,       1.424108950, 3.03739469, -0.2030487370,  0.0106137856}
 };
 
+static constexpr gas_index_t A6_index = make_gas_index(A6_coefs);
+
 const A6_coef *get_A6_coefs(gas_t gas_name) {
-  return get_coefs(A6_coefs, GET_ARRAY_SIZE(A6_coefs), gas_name);
+  return get_indexed(A6_coefs, A6_index, gas_name);
 }
 
 const A7_coef A7_coefs[] = {
@@ -315,7 +369,7 @@ const A7_coef A7_coefs[] = {
 
 const int A8_sigmas[] = {1, 1, 0, 1, 0, 1};
 
-const A8_coef A8_coefs[] = {
+constexpr A8_coef A8_coefs[] = {
   {GAS_TYPE_NITROGEN,       -0.005352690, 0.09101896, 0.01501200,
                              0.26406420,  -0.1032012, -0.1078872},
   {GAS_TYPE_CARBON_DIOXIDE, -0.034682020, 0.11304980, 0.05811886,
@@ -341,8 +395,10 @@ const A8_coef A8_coefs[] = {
                             -0.13992090, -0.06955475,-1.0490550}
 };
 
+static constexpr gas_index_t A8_index = make_gas_index(A8_coefs);
+
 const A8_coef *get_A8_coefs(gas_t gas_name) {
-  return get_coefs(A8_coefs, GET_ARRAY_SIZE(A8_coefs), gas_name);
+  return get_indexed(A8_coefs, A8_index, gas_name);
 }
 
 #ifndef ISO_20765
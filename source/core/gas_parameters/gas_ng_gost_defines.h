@@ -37,7 +37,16 @@ struct binary_associate_coef {
 };
 const binary_associate_coef *get_binary_associate_coefs(gas_t i, gas_t j);
 
-extern const size_t A0_3_coefs_count;
+/** \brief Число членов ряда функций A0-A3, размер `A0_3_coefs` */
+constexpr size_t A0_3_coefs_count = 58;
+/** \brief Наибольшие показатели степени b и k членов `A0_3_coefs`,
+ *    показатели целые, а множитель c равен 0 или 1 */
+constexpr size_t A0_3_b_max = 9;
+constexpr size_t A0_3_k_max = 4;
+/** \brief Число ненулевых коэффициентов Bn */
+constexpr size_t Bn_count = 18;
+/** \brief Масштаб приведённой температуры, К */
+constexpr double Lt = 1.0;
 struct A0_3_coef {
   const double a,
                b,
@@ -0,0 +1,103 @@
+/**
+ * asp_therm - implementation of real gas equations of state
+ *
+ *
+ * Copyright (c) 2020-2021 Mishutinski Yurii
+ *
+ * This library is distributed under the MIT License.
+ * See LICENSE file in the project root for full license information.
+ */
+#ifndef _CORE__MODELS__MODEL_CUBIC_H_
+#define _CORE__MODELS__MODEL_CUBIC_H_
+
+#include "atherm_common.h"
+#include "model_cubic_eos.h"
+#include "model_general.h"
+#include "models_math.h"
+
+/** \brief Общая часть кубических моделей(Пенга-Робинсона,
+  *   Редлиха-Квонга, Соаве-Редлиха-Квонга): методы, которые
+  *   полностью выражаются через ядро расчёта Eos */
+template <class Eos>
+class modelCubic: public modelGeneral {
+public:
+  typedef Eos eos_t;
+
+public:
+  merror_t GetCaloric(double p, double t, caloric_point *cal) override {
+    if (cal == nullptr)
+      return ERROR_INIT_NULLP_ST;
+    if (!is_above0(p, t)) {
+      error_.SetError(ERROR_PAIR_DEFAULT(ERROR_CALC_MODEL_ST));
+      return ERROR_CALC_MODEL_ST;
+    }
+    const cubic_eos_departure dep = eos_.Departure(p, t);
+    if (!is_above0(dep.volume)) {
+      error_.SetError(ERROR_PAIR_DEFAULT(ERROR_CALC_MODEL_ST));
+      return ERROR_CALC_MODEL_ST;
+    }
+    *cal = {dep.volume, dep.enthalpy, dep.entropy, dep.heat_cap_pres};
+    add_ideal_caloric(p, t, cal);
+    return ERROR_SUCCESS_T;
+  }
+  /** \brief Рассчитать удельные объёмы для точек (p[i], t[i]), i < count
+    * \param v[out] массив на count элементов, для точек, в которых
+    *   объём не рассчитан, записывается 0.0
+    * \return ERROR_SUCCESS_T или ERROR_CALC_MODEL_ST, если объём
+    *   рассчитан не для всех точек
+    *
+    * \note Как и в GetVolume, выбирается корень с наименьшей энергией
+    *   Гиббса, уравнения решаются блоками по ATHERM_LANES точек, см.
+    *   CubicEOS::VolumeBatch. Зависящие от температуры коэффициенты
+    *   пересчитываются только при смене t, поэтому точки выгодно
+    *   упорядочить по t */
+  merror_t GetVolumeBatch(const double *p, const double *t, size_t count,
+      double *v) {
+    merror_t error = eos_.VolumeBatch(p, t, count, v);
+    if (error)
+      error_.SetError(ERROR_PAIR_DEFAULT(ERROR_CALC_MODEL_ST));
+    return error;
+  }
+  /** \brief Рассчитать давление и его частные производные
+    *   dP/dv, dP/dT, d2P/dT2 в точке (v, t)
+    * \param d[out] результат расчёта
+    * \return ERROR_SUCCESS_T, ERROR_INIT_NULLP_ST или
+    *   ERROR_CALC_MODEL_ST, если точка вне области определения
+    *   уравнения состояния(t <= 0 или v <= b) */
+  merror_t GetPressureDerivatives(double v, double t,
+      cubic_eos_derivatives *d) {
+    if (d == nullptr)
+      return ERROR_INIT_NULLP_ST;
+    if (!is_above0(t) || !(v > eos_.B())) {
+      error_.SetError(ERROR_PAIR_DEFAULT(ERROR_CALC_MODEL_ST));
+      return ERROR_CALC_MODEL_ST;
+    }
+    *d = eos_.Derivatives(v, t);
+    return ERROR_SUCCESS_T;
+  }
+  /** \brief Рассчитать давление и его частные производные для точек
+    *   (v[i], t[i]), i < count, см. CubicEOS::DerivativesBatch */
+  merror_t GetPressureDerivativesBatch(const double *v, const double *t,
+      size_t count, const cubic_eos_derivatives_batch &d) {
+    merror_t error = eos_.DerivativesBatch(v, t, count, d);
+    if (error)
+      error_.SetError(ERROR_PAIR_DEFAULT(ERROR_CALC_MODEL_ST));
+    return error;
+  }
+
+  /** \brief Ядро расчёта уравнения состояния, шаблонные методы
+    *   которого можно вызывать со скалярным типом dual<N> для расчёта
+    *   производных по p, T и долям компонентов */
+  const eos_t &GetEOS() const { return eos_; }
+
+protected:
+  modelCubic(model_str model_config, gas_marks_t gm, binodalpoints *bp)
+    : modelGeneral(model_config, gm, bp) {}
+
+protected:
+  /** \brief Ядро расчёта P(v, T) и v(P, T), единственное место
+    *   хранения коэффициентов модели и правила смешения */
+  eos_t eos_;
+};
+
+#endif  // !_CORE__MODELS__MODEL_CUBIC_H_
@@ -0,0 +1,847 @@
+/**
+ * asp_therm - implementation of real gas equations of state
+ *
+ *
+ * Copyright (c) 2020-2021 Mishutinski Yurii
+ *
+ * This library is distributed under the MIT License.
+ * See LICENSE file in the project root for full license information.
+ */
+#ifndef _CORE__MODELS__MODEL_CUBIC_EOS_H_
+#define _CORE__MODELS__MODEL_CUBIC_EOS_H_
+
+#include "atherm_common.h"
+#include "dual_number.h"
+#include "models_math.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+#include <stddef.h>
+
+/**
+ * \brief Давление и его частные производные в точке (v, T)
+ * \tparam T Скалярный тип(double, dual<N>)
+ * */
+template <class T>
+struct basic_cubic_eos_derivatives {
+  /// давление
+  T p;
+  /// производная давления по удельному объёму (dP/dv)_T
+  T dp_dv;
+  /// производная давления по температуре (dP/dT)_v
+  T dp_dt;
+  /// вторая производная давления по температуре (d2P/dT2)_v
+  T d2p_dt2;
+};
+typedef basic_cubic_eos_derivatives<double> cubic_eos_derivatives;
+
+/**
+ * \brief Выходные массивы пакетного расчёта производных давления
+ *   в формате "структура массивов"
+ * \note Каждый ненулевой указатель должен адресовать массив
+ *   на `count` элементов, нулевые указатели пропускаются
+ * */
+struct cubic_eos_derivatives_batch {
+  /// давление
+  double* p;
+  /// (dP/dv)_T
+  double* dp_dv;
+  /// (dP/dT)_v
+  double* dp_dt;
+  /// (d2P/dT2)_v
+  double* d2p_dt2;
+};
+
+/**
+ * \brief Отклонения энтальпии, энтропии и изобарной теплоёмкости
+ *   от значений идеального газа при тех же давлении и температуре
+ * \tparam T Скалярный тип(double, dual<N>)
+ * */
+template <class T>
+struct basic_cubic_eos_departure {
+  /// удельный объём
+  T volume;
+  /// h - h_ideal
+  T enthalpy;
+  /// s - s_ideal
+  T entropy;
+  /// cp - cp_ideal
+  T heat_cap_pres;
+};
+typedef basic_cubic_eos_departure<double> cubic_eos_departure;
+
+/**
+ * \brief Параметры δ1, δ2 двухпараметрического кубического уравнения
+ *   состояния
+ *     P = R*T / (v - b) - a(T) / ((v + δ1*b) * (v + δ2*b))
+ *   для модели Пенга-Робинсона: (v + δ1*b) * (v + δ2*b) = v^2 + 2bv - b^2
+ * */
+struct peng_robinson_traits {
+  static constexpr double delta1 = 1.0 + 1.4142135623730951;
+  static constexpr double delta2 = 1.0 - 1.4142135623730951;
+};
+
+/**
+ * \brief Параметры δ1, δ2 для моделей Редлиха-Квонга и
+ *   Соаве-Редлиха-Квонга: (v + δ1*b) * (v + δ2*b) = v * (v + b)
+ * */
+struct redlich_kwong_traits {
+  static constexpr double delta1 = 1.0;
+  static constexpr double delta2 = 0.0;
+};
+
+/**
+ * \brief Функция alpha(T) = 1 / sqrt(T) классической модели
+ *   Редлиха-Квонга
+ * */
+struct alpha_rk {
+  template <class T>
+  T operator()(const T& t) const {
+    using std::sqrt;
+    return 1.0 / sqrt(t);
+  }
+  /** \brief sqrt(alpha(T)) */
+  template <class T>
+  T Sqrt(const T& t) const {
+    using std::sqrt;
+    return 1.0 / sqrt(sqrt(t));
+  }
+  /** \brief sqrt(alpha(T)) = T^(-1/4) и её производные по T */
+  template <class T>
+  void SqrtDerivatives(const T& t, T* s, T* s_t, T* s_tt) const {
+    *s = Sqrt(t);
+    *s_t = -0.25 * *s / t;
+    *s_tt = 1.25 * 0.25 * *s / (t * t);
+  }
+};
+
+/**
+ * \brief Функция alpha(T) = (1 + m * (1 - sqrt(T / Tc)))^2 моделей
+ *   Соаве-Редлиха-Квонга и Пенга-Робинсона
+ * */
+struct alpha_soave {
+  /// коэффициент m(w), зависящий от фактора ацентричности
+  double m;
+  /// критическая температура
+  double tc;
+
+  template <class T>
+  T operator()(const T& t) const {
+    const T s = Sqrt(t);
+    return s * s;
+  }
+  /** \brief sqrt(alpha(T)) */
+  template <class T>
+  T Sqrt(const T& t) const {
+    using std::abs;
+    using std::sqrt;
+    return abs(1.0 + m * (1.0 - sqrt(t / tc)));
+  }
+  /** \brief sqrt(alpha(T)) и её производные по T */
+  template <class T>
+  void SqrtDerivatives(const T& t, T* s, T* s_t, T* s_tt) const {
+    using std::sqrt;
+    const T st = sqrt(t * tc);
+    *s = 1.0 + m * (1.0 - st / tc);
+    *s_t = -0.5 * m / st;
+    *s_tt = 0.25 * m / (t * st);
+    if (*s < 0.0) {
+      *s = -*s;
+      *s_t = -*s_t;
+      *s_tt = -*s_tt;
+    }
+  }
+};
+
+/**
+ * \brief Правило смешения для чистого газа или смеси, заданной
+ *   псевдокритическими параметрами: a(T) = a * alpha(T)
+ * */
+template <class Alpha>
+struct mixing_pure {
+  double a;
+  double b;
+  Alpha alpha;
+
+  template <class T>
+  T A(const T& t) const {
+    return a * alpha(t);
+  }
+  /**
+   * \brief Коэффициент a(T) и его производные по температуре
+   * */
+  template <class T>
+  T A(const T& t, T* a_t, T* a_tt) const {
+    T s, s_t, s_tt;
+    alpha.SqrtDerivatives(t, &s, &s_t, &s_tt);
+    *a_t = 2.0 * a * s * s_t;
+    *a_tt = 2.0 * a * (s_t * s_t + s * s_tt);
+    return a * s * s;
+  }
+  double B() const { return b; }
+};
+
+/**
+ * \brief Правило смешения Ван-дер-Ваальса с коэффициентами бинарного
+ *   взаимодействия k_ij:
+ *     a(T) = sum_ij x_i * x_j * (1 - k_ij) * sqrt(a_i(T) * a_j(T)),
+ *     b = sum_i x_i * b_i
+ *
+ * Матрица (1 - k_ij) и произведения x_i * sqrt(a_i) рассчитываются
+ *   при добавлении компонентов, a(T) вычисляется как симметричная
+ *   квадратичная форма по верхнему треугольнику матрицы. Последние
+ *   `cache_size` значений a(T) запоминаются, поэтому расчёт на
+ *   изотерме не повторяет суммирование
+ *
+ * Шаблонные перегрузки A(t), A(t, a_t, a_tt), A(t, x), B(x), M(x)
+ *   принимают произвольный скалярный тип(например, dual<N>) и не
+ *   используют кэш и рабочий массив, варианты с x рассчитывают
+ *   коэффициенты для переданных мольных долей компонентов
+ *
+ * \note Из-за кэша вызов A(t) изменяет состояние объекта, один объект
+ *   нельзя использовать из нескольких потоков одновременно
+ * */
+template <class Alpha>
+class mixing_vdw {
+ public:
+  /** \brief Число запоминаемых значений a(T) */
+  static constexpr size_t cache_size = 4;
+
+ public:
+  mixing_vdw() = default;
+  /**
+   * \brief Добавить компонент смеси, коэффициенты k_ij добавленных
+   *   ранее компонентов сбрасываются в 0
+   * \param x Мольная доля компонента
+   * \param a Коэффициент a_i при alpha_i(T)
+   * \param b Коэффициент b_i
+   * \param mass Молярная масса компонента, если не задана(0.0) для
+   *   какого-либо компонента, M() возвращает 0.0
+   * */
+  void AddComponent(double x,
+                    double a,
+                    double b,
+                    Alpha alpha,
+                    double mass = 0.0) {
+    sqrt_ai_.push_back(std::sqrt(a));
+    xsqrt_a_.push_back(x * sqrt_ai_.back());
+    alpha_.push_back(alpha);
+    bi_.push_back(b);
+    b_ += x * b;
+    mass_i_.push_back(mass);
+    mass_ += x * mass;
+    has_mass_ = (mass_i_.size() == 1 || has_mass_) && mass > 0.0;
+    m_.assign(xsqrt_a_.size() * xsqrt_a_.size(), 1.0);
+    sqrt_a_.assign(3 * xsqrt_a_.size(), 0.0);
+    reset_cache();
+  }
+  /**
+   * \brief Установить коэффициент бинарного взаимодействия k_ij = k_ji
+   * */
+  void SetBinaryCoef(size_t i, size_t j, double k) {
+    m_[i * xsqrt_a_.size() + j] = 1.0 - k;
+    m_[j * xsqrt_a_.size() + i] = 1.0 - k;
+    reset_cache();
+  }
+  size_t Size() const { return xsqrt_a_.size(); }
+
+  double A(double t) const {
+    for (size_t k = 0; k < cache_size; ++k)
+      if (cache_t_[k] == t)
+        return cache_a_[k];
+    for (size_t i = 0; i < xsqrt_a_.size(); ++i)
+      sqrt_a_[i] = xsqrt_a_[i] * alpha_[i].Sqrt(t);
+    const double a = quadratic_form(sqrt_a_.data());
+    cache_t_[cache_next_] = t;
+    cache_a_[cache_next_] = a;
+    cache_next_ = (cache_next_ + 1) % cache_size;
+    return a;
+  }
+  template <class T>
+  T A(const T& t) const {
+    std::vector<T> q(xsqrt_a_.size());
+    for (size_t i = 0; i < q.size(); ++i)
+      q[i] = xsqrt_a_[i] * alpha_[i].Sqrt(t);
+    return quadratic_form(q.data());
+  }
+  /**
+   * \brief Коэффициент a(T, x) для долей компонентов x[i], i < Size()
+   * */
+  template <class T>
+  T A(const T& t, const T* x) const {
+    std::vector<T> q(sqrt_ai_.size());
+    for (size_t i = 0; i < q.size(); ++i)
+      q[i] = x[i] * sqrt_ai_[i] * alpha_[i].Sqrt(t);
+    return quadratic_form(q.data());
+  }
+  /**
+   * \brief Коэффициент a(T) и его производные по температуре
+   *
+   * С q_i = x_i * sqrt(a_i * alpha_i(T)) и r_i = sum_j (1 - k_ij) * q_j:
+   *   a = sum_i q_i * r_i,  a_t = 2 * sum_i q_i' * r_i,
+   *   a_tt = 2 * sum_i (q_i'' * r_i + q_i' * r_i')
+   * */
+  double A(double t, double* a_t, double* a_tt) const {
+    return a_derivatives(t, a_t, a_tt, sqrt_a_.data());
+  }
+  template <class T>
+  T A(const T& t, T* a_t, T* a_tt) const {
+    std::vector<T> q(3 * xsqrt_a_.size());
+    return a_derivatives(t, a_t, a_tt, q.data());
+  }
+  double B() const { return b_; }
+  /**
+   * \brief Коэффициент b(x) для долей компонентов x[i], i < Size()
+   * */
+  template <class T>
+  T B(const T* x) const {
+    T b(0.0);
+    for (size_t i = 0; i < bi_.size(); ++i)
+      b += x[i] * bi_[i];
+    return b;
+  }
+  /** \brief Молярная масса смеси sum_i x_i * M_i или 0.0 */
+  double M() const { return has_mass_ ? mass_ : 0.0; }
+  /**
+   * \brief Молярная масса смеси для долей компонентов x[i], i < Size()
+   * */
+  template <class T>
+  T M(const T* x) const {
+    T m(0.0);
+    for (size_t i = 0; i < mass_i_.size(); ++i)
+      m += x[i] * mass_i_[i];
+    return m;
+  }
+
+ private:
+  /**
+   * \brief sum_ij (1 - k_ij) * q_i * q_j по верхнему треугольнику
+   * */
+  template <class T>
+  T quadratic_form(const T* q) const {
+    const size_t n = xsqrt_a_.size();
+    T a(0.0);
+    for (size_t i = 0; i < n; ++i) {
+      const double* mi = &m_[i * n];
+      T ai(0.0);
+      for (size_t j = i + 1; j < n; ++j)
+        ai += mi[j] * q[j];
+      a += q[i] * (mi[i] * q[i] + 2.0 * ai);
+    }
+    return a;
+  }
+  /**
+   * \brief a(T), a_t, a_tt с рабочим массивом q на 3 * Size() элементов
+   * */
+  template <class T>
+  T a_derivatives(const T& t, T* a_t, T* a_tt, T* q) const {
+    const size_t n = xsqrt_a_.size();
+    T *q_t = q + n, *q_tt = q_t + n;
+    for (size_t i = 0; i < n; ++i) {
+      alpha_[i].SqrtDerivatives(t, &q[i], &q_t[i], &q_tt[i]);
+      q[i] *= xsqrt_a_[i];
+      q_t[i] *= xsqrt_a_[i];
+      q_tt[i] *= xsqrt_a_[i];
+    }
+    T a(0.0), da(0.0), d2a(0.0);
+    for (size_t i = 0; i < n; ++i) {
+      const double* mi = &m_[i * n];
+      T r(0.0), r_t(0.0);
+      for (size_t j = 0; j < n; ++j) {
+        r += mi[j] * q[j];
+        r_t += mi[j] * q_t[j];
+      }
+      a += q[i] * r;
+      da += q_t[i] * r;
+      d2a += q_tt[i] * r + q_t[i] * r_t;
+    }
+    *a_t = 2.0 * da;
+    *a_tt = 2.0 * d2a;
+    return a;
+  }
+  void reset_cache() {
+    cache_t_.fill(0.0);
+    cache_next_ = 0;
+  }
+
+ private:
+  /// sqrt(a_i)
+  std::vector<double> sqrt_ai_;
+  /// x_i * sqrt(a_i)
+  std::vector<double> xsqrt_a_;
+  std::vector<Alpha> alpha_;
+  /// b_i
+  std::vector<double> bi_;
+  /// молярные массы M_i
+  std::vector<double> mass_i_;
+  /// 1 - k_ij, матрица n x n по строкам
+  std::vector<double> m_;
+  double b_ = 0.0;
+  double mass_ = 0.0;
+  bool has_mass_ = false;
+  /// x_i * sqrt(a_i * alpha_i(T)) и её производные, рабочий массив
+  mutable std::vector<double> sqrt_a_;
+  /// температуры и значения a(T) последних расчётов
+  mutable std::array<double, cache_size> cache_t_ = {};
+  mutable std::array<double, cache_size> cache_a_ = {};
+  mutable size_t cache_next_ = 0;
+};
+
+/**
+ * \brief Двухпараметрическое кубическое уравнение состояния
+ *     P = R*T / (v - b) - a(T) / ((v + δ1*b) * (v + δ2*b))
+ *
+ * \tparam Traits Параметры δ1, δ2(`peng_robinson_traits`,
+ *   `redlich_kwong_traits`)
+ * \tparam Mixing Правило расчёта коэффициентов a(T) и b
+ *   (`mixing_pure`, `mixing_vdw`)
+ *
+ * Все методы не виртуальные и определены в заголовке, поэтому для
+ *   каждой модели компилируется отдельное ядро расчёта. A, Pressure,
+ *   Volume, Derivatives, Departure и изотермические интегралы
+ *   InternalEnergyIntegral, HeatCapVolIntegral шаблонные по скалярному
+ *   типу: для double используются те же вычисления, что и раньше, а с
+ *   dual<N>(dual_number.h) за один проход рассчитываются производные
+ *   по p, T и долям компонентов. Пакетные VolumeBatch и
+ *   DerivativesBatch рассчитываются только в double
+ *
+ * \note Уравнение записано в удельных(на кг) величинах: R - удельная
+ *   газовая постоянная смеси, a_i и b_i рассчитаны по удельным газовым
+ *   постоянным компонентов. Перегрузки по долям компонентов учитывают
+ *   зависимость R от состава, см. R(x)
+ * */
+template <class Traits, class Mixing>
+class CubicEOS {
+ public:
+  static constexpr double delta1 = Traits::delta1;
+  static constexpr double delta2 = Traits::delta2;
+
+ public:
+  CubicEOS() = default;
+  /**
+   * \param R Удельная газовая постоянная
+   * */
+  CubicEOS(double R, Mixing mixing) : R_(R), mixing_(std::move(mixing)) {}
+
+  /** \brief Коэффициент a(T) */
+  template <class T>
+  T A(const T& t) const {
+    return mixing_.A(t);
+  }
+  /**
+   * \brief Коэффициент a(T) и его производные a_t, a_tt по
+   *   температуре, коэффициент b от температуры не зависит
+   * */
+  template <class T>
+  T A(const T& t, T* a_t, T* a_tt) const {
+    return mixing_.A(t, a_t, a_tt);
+  }
+  /** \brief Коэффициент b */
+  double B() const { return mixing_.B(); }
+  /** \brief Удельная газовая постоянная */
+  double R() const { return R_; }
+  /**
+   * \brief Удельная газовая постоянная для мольных долей компонентов
+   *   x[i], i < GetMixing().Size(): R(x) = R * M / M(x), где M и M(x) -
+   *   молярные массы смеси исходного и заданного состава
+   * \note Если молярные массы компонентов не заданы(Mixing::M() = 0.0),
+   *   R от состава не зависит
+   * */
+  template <class T>
+  T R(const T* x) const {
+    const double m = mixing_.M();
+    if (!(m > 0.0))
+      return T(R_);
+    return R_ * m / mixing_.M(x);
+  }
+
+  template <class T>
+  T Pressure(const T& v, const T& t) const {
+    return Pressure(v, t, A(t));
+  }
+  /**
+   * \brief Давление при известном коэффициенте a_t = a(T)
+   * */
+  template <class T>
+  T Pressure(const T& v, const T& t, const T& a_t) const {
+    return pressure(v, t, a_t, T(B()), T(R_));
+  }
+  /**
+   * \brief Давление для мольных долей компонентов x[i],
+   *   i < GetMixing().Size(), газовая постоянная - R(x)
+   * */
+  template <class T>
+  T Pressure(const T& v, const T& t, const T* x) const {
+    return pressure(v, t, mixing_.A(t, x), mixing_.B(x), R(x));
+  }
+
+  double Volume(double p, double t) const { return Volume(p, t, A(t)); }
+  /**
+   * \brief Удельный объём при известном коэффициенте a_t = a(T):
+   *   корень уравнения состояния с наименьшей энергией Гиббса, при
+   *   трёх корнях - газ(наибольший) или жидкость(наименьший),
+   *   см. volume_root
+   * */
+  double Volume(double p, double t, double a_t) const {
+    return volume_root(p, t, a_t, B(), R_);
+  }
+  /**
+   * \brief Удельный объём для произвольного скалярного типа
+   *
+   * Корень находится для значений в double, производные - по теореме
+   *   о неявной функции одним шагом Ньютона в арифметике T:
+   *   dv = -(dP - dp) / (dP/dv)
+   * */
+  template <class T>
+  T Volume(const T& p, const T& t) const {
+    return implicit_volume(p, t, A(t), T(B()), T(R_));
+  }
+  /**
+   * \brief Удельный объём для долей компонентов x[i],
+   *   см. Pressure(v, t, x)
+   * */
+  template <class T>
+  T Volume(const T& p, const T& t, const T* x) const {
+    return implicit_volume(p, t, mixing_.A(t, x), mixing_.B(x), R(x));
+  }
+  /**
+   * \brief Удельные объёмы для точек (p[i], t[i]), i < count
+   * \param v[out] Массив на count элементов, для точек, в которых
+   *   объём не рассчитан, записывается 0.0
+   *
+   * \return ERROR_SUCCESS_T или ERROR_CALC_MODEL_ST, если объём
+   *   рассчитан не для всех точек
+   *
+   * Корни уравнения состояния находятся блоками по ATHERM_LANES точек
+   *   без ветвлений, см. CubicOuterRootsLanes, из наибольшего и
+   *   наименьшего корня выбирается корень с наименьшей энергией Гиббса,
+   *   как в Volume(p, t). Результат совпадает с Volume(p, t) с
+   *   точностью до округления
+   *
+   * \note a(T) пересчитывается только при смене температуры
+   * */
+  merror_t VolumeBatch(const double* p,
+                       const double* t,
+                       size_t count,
+                       double* v) const {
+    if (p == nullptr || t == nullptr || v == nullptr)
+      return ERROR_INIT_NULLP_ST;
+    merror_t error = ERROR_SUCCESS_T;
+    const double b = B(), u = delta1 + delta2, w = delta1 * delta2;
+    double t_prev = 0.0, a_t = 0.0;
+    for (size_t i0 = 0; i0 < count; i0 += ATHERM_LANES) {
+      const size_t n = std::min<size_t>(ATHERM_LANES, count - i0);
+      double pl[ATHERM_LANES], Rtp[ATHERM_LANES], al[ATHERM_LANES],
+          c1[ATHERM_LANES], c2[ATHERM_LANES], c3[ATHERM_LANES],
+          root[ATHERM_LANES], root_min[ATHERM_LANES];
+      bool valid[ATHERM_LANES];
+      for (size_t l = 0; l < ATHERM_LANES; ++l) {
+        const size_t i = i0 + l;
+        valid[l] = (l < n) && is_above0(p[i], t[i]);
+        // неполный блок и точки вне области определения - условная точка
+        pl[l] = 1.0, Rtp[l] = 1.0, al[l] = 0.0;
+        if (!valid[l])
+          continue;
+        if (t[i] != t_prev) {
+          t_prev = t[i];
+          a_t = A(t[i]);
+        }
+        pl[l] = p[i];
+        Rtp[l] = R_ * t[i] / p[i];
+        al[l] = a_t;
+      }
+      // коэффициенты те же, что в volume_root
+      for (size_t l = 0; l < ATHERM_LANES; ++l) {
+        const double ap = al[l] / pl[l];
+        c1[l] = (u - 1.0) * b - Rtp[l];
+        c2[l] = (w - u) * b * b - u * b * Rtp[l] + ap;
+        c3[l] = -w * b * b * (b + Rtp[l]) - ap * b;
+      }
+      CubicOuterRootsLanes(c1, c2, c3, root, root_min);
+      for (size_t l = 0; l < ATHERM_LANES; ++l) {
+        const double c = al[l] / ((delta1 - delta2) * b * pl[l] * Rtp[l]);
+        root[l] =
+            (gibbs_difference(root[l], root_min[l], b, Rtp[l], c) < 0.0)
+                ? root_min[l]
+                : root[l];
+      }
+      for (size_t l = 0; l < n; ++l) {
+        const bool ok = valid[l] && is_above0(root[l]);
+        v[i0 + l] = ok ? root[l] : 0.0;
+        if (!ok)
+          error = ERROR_CALC_MODEL_ST;
+      }
+    }
+    return error;
+  }
+
+  /**
+   * \brief Давление и его частные производные в точке (v, t)
+   * */
+  template <class T>
+  basic_cubic_eos_derivatives<T> Derivatives(const T& v, const T& t) const {
+    T a_t, a_tt;
+    const T a = A(t, &a_t, &a_tt);
+    return Derivatives(v, t, a, a_t, a_tt);
+  }
+  /**
+   * \brief Давление и его частные производные при известных
+   *   a(T) и её производных a_t, a_tt
+   * */
+  template <class T>
+  basic_cubic_eos_derivatives<T> Derivatives(const T& v,
+                                             const T& t,
+                                             const T& a,
+                                             const T& a_t,
+                                             const T& a_tt) const {
+    const double b = B();
+    const T vmb = v - b, vb = (v + delta1 * b) * (v + delta2 * b);
+    basic_cubic_eos_derivatives<T> d;
+    d.p = R_ * t / vmb - a / vb;
+    d.dp_dv = -R_ * t / (vmb * vmb)
+              + a * (2.0 * v + (delta1 + delta2) * b) / (vb * vb);
+    d.dp_dt = R_ / vmb - a_t / vb;
+    d.d2p_dt2 = -a_tt / vb;
+    return d;
+  }
+  /**
+   * \brief Давление и его частные производные для точек (v[i], t[i]),
+   *   i < count
+   *
+   * \return ERROR_SUCCESS_T, ERROR_INIT_NULLP_ST если не заданы v или t,
+   *   ERROR_CALC_MODEL_ST если производные рассчитаны не для всех точек,
+   *   в таких точках записывается 0.0
+   *
+   * \note a(T) и её производные пересчитываются только при смене
+   *   температуры
+   * */
+  merror_t DerivativesBatch(const double* v,
+                            const double* t,
+                            size_t count,
+                            const cubic_eos_derivatives_batch& out) const {
+    if (v == nullptr || t == nullptr)
+      return ERROR_INIT_NULLP_ST;
+    merror_t error = ERROR_SUCCESS_T;
+    double t_prev = 0.0, a = 0.0, a_t = 0.0, a_tt = 0.0;
+    for (size_t i = 0; i < count; ++i) {
+      cubic_eos_derivatives d = {0.0, 0.0, 0.0, 0.0};
+      if (is_above0(t[i]) && v[i] > B()) {
+        if (t[i] != t_prev) {
+          t_prev = t[i];
+          a = A(t[i], &a_t, &a_tt);
+        }
+        d = Derivatives(v[i], t[i], a, a_t, a_tt);
+      } else {
+        error = ERROR_CALC_MODEL_ST;
+      }
+      if (out.p)
+        out.p[i] = d.p;
+      if (out.dp_dv)
+        out.dp_dv[i] = d.dp_dv;
+      if (out.dp_dt)
+        out.dp_dt[i] = d.dp_dt;
+      if (out.d2p_dt2)
+        out.d2p_dt2[i] = d.d2p_dt2;
+    }
+    return error;
+  }
+
+  /**
+   * \brief Отклонения калорических параметров от идеального газа
+   *   в точке (p, t), объём - корень уравнения состояния с наименьшей
+   *   энергией Гиббса, тот же, что в Volume(p, t)
+   *
+   * С L = ln((v + δ2*b) / (v + δ1*b)) / ((δ1 - δ2) * b):
+   *   h - h_id = (a - T*a_t) * L + p*v - R*T,
+   *   s - s_id = R * ln(p * (v - b) / (R*T)) - a_t * L,
+   *   cv - cv_id = -T * a_tt * L
+   *
+   * \note Если объём не рассчитан(v <= b), volume = 0.0
+   * \note Для dual<N> производные объёма рассчитываются, как в Volume,
+   *   см. volume_by_root, выбор корня от производных не зависит
+   * */
+  template <class T>
+  basic_cubic_eos_departure<T> Departure(const T& p, const T& t) const {
+    using std::log;
+    T a_t, a_tt;
+    const T a = A(t, &a_t, &a_tt);
+    const double b = B();
+    basic_cubic_eos_departure<T> dep = {T(0.0), T(0.0), T(0.0), T(0.0)};
+    const double v0 =
+        volume_root(value_of(p), value_of(t), value_of(a), b, R_);
+    if (!(v0 > b))
+      return dep;
+    const T v = volume_by_root(v0, p, t, a, T(b), T(R_));
+    const basic_cubic_eos_derivatives<T> d = Derivatives(v, t, a, a_t, a_tt);
+    const T L = log((v + delta2 * b) / (v + delta1 * b))
+                / ((delta1 - delta2) * b);
+    dep.volume = v;
+    dep.enthalpy = (a - t * a_t) * L + p * v - R_ * t;
+    dep.entropy = R_ * log(p * (v - b) / (R_ * t)) - a_t * L;
+    dep.heat_cap_pres =
+        -t * a_tt * L - t * d.dp_dt * d.dp_dt / d.dp_dv - R_;
+    return dep;
+  }
+
+  /**
+   * \brief Изменение удельной внутренней энергии на изотерме t при
+   *   изменении объёма от v0 до v:
+   *     u - u0 = int_v0^v (T * dP/dT - P) dv = (a - T*a_t) * L,
+   *   L = ln((v + δ2*b)(v0 + δ1*b) / ((v + δ1*b)(v0 + δ2*b)))
+   *       / ((δ1 - δ2) * b)
+   * */
+  template <class T>
+  T InternalEnergyIntegral(const T& v0,
+                           const T& v,
+                           const T& t,
+                           const T& a,
+                           const T& a_t) const {
+    return (a - t * a_t) * isotherm_log(v0, v);
+  }
+  /**
+   * \brief Изменение изохорной теплоёмкости на изотерме t при
+   *   изменении объёма от v0 до v:
+   *     cv - cv0 = int_v0^v T * d2P/dT2 dv = -T * a_tt * L,
+   *   L - см. InternalEnergyIntegral
+   * */
+  template <class T>
+  T HeatCapVolIntegral(const T& v0,
+                       const T& v,
+                       const T& t,
+                       const T& a_tt) const {
+    return -t * a_tt * isotherm_log(v0, v);
+  }
+
+  const Mixing& GetMixing() const { return mixing_; }
+
+ private:
+  template <class T>
+  T pressure(const T& v,
+             const T& t,
+             const T& a,
+             const T& b,
+             const T& r) const {
+    return r * t / (v - b) - a / ((v + delta1 * b) * (v + delta2 * b));
+  }
+  /**
+   * \brief Корень уравнения состояния с наименьшей энергией Гиббса:
+   *   при трёх корнях сравниваются наибольший(газ) и наименьший
+   *   (жидкость), как в PhaseEquilibrium::ln_phi, см. gibbs_difference
+   * */
+  double volume_root(double p, double t, double a, double b, double r) const {
+    double roots[3];
+    const int roots_count = volume_roots(p, t, a, b, r, roots);
+    const double Rtp = r * t / p, c = a / ((delta1 - delta2) * b * r * t);
+    if (roots_count == 3 && gibbs_difference(roots[0], roots[2], b, Rtp, c)
+                                < 0.0)
+      return roots[2];
+    return roots[0];
+  }
+  /**
+   * \brief Корни уравнения состояния по убыванию, см. CubicRealRoots
+   * \return Количество действительных корней(1 или 3)
+   * */
+  int volume_roots(double p,
+                   double t,
+                   double a,
+                   double b,
+                   double r,
+                   double* roots) const {
+    const double Rtp = r * t / p, ap = a / p, u = delta1 + delta2,
+                 w = delta1 * delta2;
+    const double coef[4] = {1.0, (u - 1.0) * b - Rtp,
+                            (w - u) * b * b - u * b * Rtp + ap,
+                            -w * b * b * (b + Rtp) - ap * b};
+    int roots_count = 1;
+    CubicRealRoots(coef, roots, &roots_count);
+    return roots_count;
+  }
+  /**
+   * \brief g(v_min) - g(v_max), где g(v) - приведённая энергия Гиббса
+   *   без слагаемых, не зависящих от корня:
+   *   g(v) = p*v / (R*T) - ln(v - b)
+   *          - c * ln((v + δ1*b) / (v + δ2*b)),
+   *   c = a / ((δ1 - δ2) * b * R*T), Rtp = R*T / p
+   * \note Без ветвлений, используется и в VolumeBatch. Если v_min не
+   *   корень жидкости(v_min <= b или v_min >= v_max), возвращает 0.0,
+   *   то есть жидкость не выбирается
+   * */
+  static double gibbs_difference(double v_max,
+                                 double v_min,
+                                 double b,
+                                 double Rtp,
+                                 double c) {
+    const bool liquid = v_min > b && v_min < v_max;
+    const double dv = liquid ? v_min - v_max : 0.0,
+                 r1 = liquid ? (v_min - b) / (v_max - b) : 1.0,
+                 r2 = liquid ? (v_min + delta1 * b) * (v_max + delta2 * b)
+                                   / ((v_min + delta2 * b)
+                                      * (v_max + delta1 * b))
+                             : 1.0;
+    return dv / Rtp - LaneLog(r1) - c * LaneLog(r2);
+  }
+  template <class T>
+  T implicit_volume(const T& p,
+                    const T& t,
+                    const T& a,
+                    const T& b,
+                    const T& r) const {
+    const double v = volume_root(value_of(p), value_of(t), value_of(a),
+                                 value_of(b), value_of(r));
+    if (!(v > value_of(b)))
+      return T(v);
+    return volume_by_root(v, p, t, a, b, r);
+  }
+  /**
+   * \brief Объём как функция аргументов(p, t, a, b, r) по корню v
+   *   уравнения состояния, рассчитанному в double: шаг Ньютона
+   *   dv = -(P(v) - p) / (dP/dv)_T переносит производные аргументов,
+   *   значение v не изменяется
+   * */
+  template <class T>
+  T volume_by_root(double v,
+                   const T& p,
+                   const T& t,
+                   const T& a,
+                   const T& b,
+                   const T& r) const {
+    const double tv = value_of(t), av = value_of(a), bv = value_of(b),
+                 rv = value_of(r);
+    const double vmb = v - bv, vb = (v + delta1 * bv) * (v + delta2 * bv);
+    const double dp_dv = -rv * tv / (vmb * vmb)
+                         + av * (2.0 * v + (delta1 + delta2) * bv) / (vb * vb);
+    const T dv = (p - pressure(T(v), t, a, b, r)) / dp_dv;
+    return v + (dv - value_of(dv));
+  }
+  /** \brief Для double корень уже найден, шаг Ньютона не нужен */
+  double volume_by_root(double v,
+                        double,
+                        double,
+                        double,
+                        double,
+                        double) const {
+    return v;
+  }
+  /**
+   * \brief L = ln((v + δ2*b)(v0 + δ1*b) / ((v + δ1*b)(v0 + δ2*b)))
+   *   / ((δ1 - δ2) * b)
+   * */
+  template <class T>
+  T isotherm_log(const T& v0, const T& v) const {
+    using std::log;
+    const double b = B();
+    return log((v + delta2 * b) * (v0 + delta1 * b)
+               / ((v + delta1 * b) * (v0 + delta2 * b)))
+           / ((delta1 - delta2) * b);
+  }
+
+ private:
+  double R_ = 0.0;
+  Mixing mixing_;
+};
+
+#endif  // !_CORE__MODELS__MODEL_CUBIC_EOS_H_
@@ -18,6 +18,8 @@
 #include "models_math.h"
 
 #include <algorithm>
+#include <cmath>
+#include <limits>
 #ifdef _DEBUG
 #include <iostream>
 #endif  // _DEBUG
@@ -70,9 +72,7 @@ double modelGeneral::vapor_part(int32_t index) {
 }
 
 int32_t modelGeneral::set_state_phasesub(double p) {
-  return (bp_->p.end()
-          - std::find_if(bp_->p.begin() + 1, bp_->p.end(),
-                         [p](const auto v) { return v < p; }));
+  return bp_->p.size() - bp_->PressureIndex(p);
 }
 
 state_phase modelGeneral::set_state_phase(double v, double p, double t) {
@@ -93,34 +93,32 @@ state_phase modelGeneral::set_state_phase(double v, double p, double t) {
   /* calculate p)path in percents */
   const double p_path =
       (p - bp_->p[iter + 1]) / (bp_->p[iter] - bp_->p[iter + 1]);
+  // линейная интерполяция между точками iter + 1(p_path = 0) и iter
+  //   (p_path = 1)
   // left branch of binodal
   if (v < parameters_->cgetV_K()) {
-    const double vapprox =
-        bp_->vLeft[iter] - (bp_->vLeft[iter + 1] - bp_->vLeft[iter]) * p_path;
+    const double vapprox = bp_->vLeft[iter + 1]
+                           + (bp_->vLeft[iter] - bp_->vLeft[iter + 1]) * p_path;
     return ((v < vapprox) ? state_phase::LIQUID : state_phase::LIQ_STEAM);
   }
   // rigth branch of binodal
-  const double vapprox =
-      bp_->vRigth[iter] + (bp_->vRigth[iter + 1] - bp_->vRigth[iter]) * p_path;
+  const double vapprox = bp_->vRigth[iter + 1]
+                         + (bp_->vRigth[iter] - bp_->vRigth[iter + 1]) * p_path;
   return ((v > vapprox) ? state_phase::GAS : state_phase::LIQ_STEAM);
 }
 
 void modelGeneral::set_enthalpy() {
   if (bp_ == nullptr)
     return;
-  if (!bp_->hLeft.empty())
-    bp_->hLeft.clear();
+  bp_->hLeft.resize(bp_->vLeft.size());
   for (size_t i = 0; i < bp_->vLeft.size(); ++i) {
     SetPressure(bp_->vLeft[i], bp_->t[i]);
-    bp_->hLeft.push_back(parameters_->cgetIntEnergy()
-                         + bp_->p[i] * bp_->vLeft[i]);
+    bp_->hLeft[i] = parameters_->cgetIntEnergy() + bp_->p[i] * bp_->vLeft[i];
   }
-  if (!bp_->hRigth.empty())
-    bp_->hRigth.clear();
+  bp_->hRigth.resize(bp_->vRigth.size());
   for (size_t i = 0; i < bp_->vRigth.size(); ++i) {
     SetPressure(bp_->vRigth[i], bp_->t[i]);
-    bp_->hRigth.push_back(parameters_->cgetIntEnergy()
-                          + bp_->p[i] * bp_->vRigth[i]);
+    bp_->hRigth[i] = parameters_->cgetIntEnergy() + bp_->p[i] * bp_->vRigth[i];
   }
 }
 
@@ -129,6 +127,23 @@ const GasParameters* modelGeneral::get_gasparameters() const {
   return parameters_.get();
 }
 
+/**
+ * \brief Изобарная теплоёмкость газа по исходным данным, для смеси -
+ *   среднее по массовым долям компонентов
+ * */
+static double initial_heat_cap_pres(const gas_params_input& gpi,
+                                    bool is_mix) {
+  if (!is_mix)
+    return (gpi.const_dyn.cdp.dgp) ? gpi.const_dyn.cdp.dgp->heat_cap_pres
+                                   : 0.0;
+  double mcp = 0.0, mass = 0.0;
+  for (const auto& x : *gpi.const_dyn.components) {
+    mcp += x.first * x.second.first.mp.mass * x.second.second.heat_cap_pres;
+    mass += x.first * x.second.first.mp.mass;
+  }
+  return (is_above0(mass)) ? mcp / mass : 0.0;
+}
+
 void modelGeneral::set_gasparameters(const gas_params_input& gpi,
                                      modelGeneral* mg) {
   if (HasGostModelMark(gm_)) {
@@ -146,7 +161,153 @@ void modelGeneral::set_gasparameters(const gas_params_input& gpi,
   if (parameters_ == nullptr) {
     error_.SetError(ERROR_INIT_T, "error occurred while init gost model");
     status_ = STATUS_HAVE_ERROR;
+  } else if (!HasGostModelMark(gm_)) {
+    ideal_cp_ = initial_heat_cap_pres(gpi, HasGasMixMark(gm_));
+  }
+}
+
+void modelGeneral::add_ideal_caloric(double p,
+                                     double t,
+                                     caloric_point* cal) const {
+  const double t0 = 273.15, p0 = 101325.0, R = parameters_->cgetR();
+  cal->enthalpy += ideal_cp_ * (t - t0) + datum_enthalpy_;
+  cal->entropy +=
+      ideal_cp_ * std::log(t / t0) - R * std::log(p / p0) + datum_entropy_;
+  cal->heat_cap_pres += ideal_cp_;
+}
+
+void modelGeneral::set_caloric_datum() {
+  datum_enthalpy_ = 0.0;
+  datum_entropy_ = 0.0;
+  const parameters pm = parameters_->cgetParameters();
+  caloric_point cal = {0.0, 0.0, 0.0, 0.0};
+  if (GetCaloric(pm.pressure, pm.temperature, &cal))
+    return;
+  const dyn_parameters& dp = parameters_->cgetDynParameters();
+  datum_enthalpy_ =
+      dp.internal_energy + pm.pressure * cal.volume - cal.enthalpy;
+  datum_entropy_ = dp.entropy - cal.entropy;
+}
+
+merror_t modelGeneral::GetCaloric(double p, double t, caloric_point* cal) {
+  (void)p;
+  (void)t;
+  (void)cal;
+  error_.SetError(ERROR_CALC_MODEL_ST,
+                  "модель не поддерживает расчёт энтальпии и энтропии");
+  return ERROR_CALC_MODEL_ST;
+}
+
+merror_t modelGeneral::SolvePH(double p, double h, double t_init, double* t) {
+  return solve_caloric(p, h, false, t_init, t);
+}
+
+merror_t modelGeneral::SolvePS(double p, double s, double t_init, double* t) {
+  return solve_caloric(p, s, true, t_init, t);
+}
+
+merror_t modelGeneral::SolvePHBatch(const double* p,
+                                    const double* h,
+                                    size_t count,
+                                    double* t) {
+  return solve_caloric_batch(p, h, false, count, t);
+}
+
+merror_t modelGeneral::SolvePSBatch(const double* p,
+                                    const double* s,
+                                    size_t count,
+                                    double* t) {
+  return solve_caloric_batch(p, s, true, count, t);
+}
+
+merror_t modelGeneral::solve_caloric(double p,
+                                     double val,
+                                     bool is_entropy,
+                                     double t_init,
+                                     double* t) {
+  const int max_iter = 100;
+  const double tol = 1e-10;
+  if (t == nullptr)
+    return ERROR_INIT_NULLP_ST;
+  if (!is_above0(p)) {
+    error_.SetError(ERROR_PAIR_DEFAULT(ERROR_CALC_MODEL_ST));
+    return ERROR_CALC_MODEL_ST;
+  }
+  double tk = is_above0(t_init) ? t_init : parameters_->cgetTemperature();
+  /* h и s возрастают по T, корень лежит в (t_lo, t_hi),
+   *   t_lo = 0.0, t_hi = 0.0 - граница ещё не найдена */
+  double t_lo = 0.0, t_hi = 0.0, t_good = 0.0,
+         dt_prev = std::numeric_limits<double>::infinity();
+  caloric_point cal = {0.0, 0.0, 0.0, 0.0};
+  for (int i = 0; i < max_iter; ++i) {
+    merror_t error = GetCaloric(p, tk, &cal);
+    if (error) {
+      /* пробная точка вне области определения модели(например,
+       *   диапазона температур ISO 20765) - шаг сокращается вдвое */
+      if (!is_above0(t_good) || std::abs(tk - t_good) < tol * t_good)
+        return error;
+      tk = 0.5 * (tk + t_good);
+      continue;
+    }
+    t_good = tk;
+    const double f = ((is_entropy) ? cal.entropy : cal.enthalpy) - val,
+                 df = (is_entropy) ? cal.heat_cap_pres / tk
+                                   : cal.heat_cap_pres;
+    if (f > 0.0)
+      t_hi = tk;
+    else
+      t_lo = tk;
+    double tn = tk - f / df;
+    if (df > 0.0 && std::abs(tn - tk) < tol * tk) {
+      *t = tn;
+      return ERROR_SUCCESS_T;
+    }
+    /* интервал стянулся, а невязка нет - значение внутри скачка
+     *   h(T) или s(T) при смене фазы, см. SolvePH */
+    if (t_hi > 0.0 && t_hi - t_lo < tol * t_hi) {
+      *t = 0.5 * (t_lo + t_hi);
+      return ERROR_SUCCESS_T;
+    }
+    /* шаг Ньютона принимается, если он не выходит из интервала(без
+     *   найденной границы - не изменяет T более чем вдвое) и, когда
+     *   найдены обе границы, вдвое короче предыдущего шага */
+    const bool has_lo = t_lo > 0.0, has_hi = t_hi > 0.0;
+    const bool newton = df > 0.0 && tn > (has_lo ? t_lo : 0.5 * tk)
+                        && tn < (has_hi ? t_hi : 2.0 * tk)
+                        && (!(has_lo && has_hi)
+                            || std::abs(tn - tk) < 0.5 * dt_prev);
+    if (!newton) {
+      if (has_lo && has_hi)
+        tn = 0.5 * (t_lo + t_hi);
+      else
+        tn = has_hi ? 0.5 * tk : 2.0 * tk;
+    }
+    dt_prev = std::abs(tn - tk);
+    tk = tn;
+  }
+  error_.SetError(ERROR_PAIR_DEFAULT(ERROR_CALC_MODEL_ST));
+  return ERROR_CALC_MODEL_ST;
+}
+
+merror_t modelGeneral::solve_caloric_batch(const double* p,
+                                           const double* val,
+                                           bool is_entropy,
+                                           size_t count,
+                                           double* t) {
+  if (p == nullptr || val == nullptr || t == nullptr)
+    return ERROR_INIT_NULLP_ST;
+  merror_t error = ERROR_SUCCESS_T;
+  double t_prev = 0.0;
+  for (size_t i = 0; i < count; ++i) {
+    merror_t e = solve_caloric(p[i], val[i], is_entropy, t_prev, &t[i]);
+    if (e) {
+      error = e;
+      t[i] = 0.0;
+    } else {
+      t_prev = t[i];
+    }
   }
+  return error;
 }
 
 model_str modelGeneral::GetModelShortInfo(const rg_model_id model_type) {
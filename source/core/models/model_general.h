@@ -73,6 +73,21 @@ struct model_input {
               model_str ms);
 };
 
+/**
+ * \brief Калорические параметры газа в точке (p, T), используемые
+ *   в обратных расчётах по энтальпии и энтропии
+ * */
+struct caloric_point {
+  /// удельный объём
+  double volume;
+  /// удельная энтальпия
+  double enthalpy;
+  /// удельная энтропия
+  double entropy;
+  /// удельная изобарная теплоёмкость, (dh/dT)_p
+  double heat_cap_pres;
+};
+
 /** \brief Базовый абстрактный класс имплементации
  *   уравнения состояния реаьного газа(модели) */
 class modelGeneral {
@@ -127,6 +142,75 @@ class modelGeneral {
   virtual void SetPressure(double v, double t) = 0;
   virtual double GetVolume(double p, double t) = 0;
   virtual double GetPressure(double v, double t) = 0;
+  /**
+   * \brief Рассчитать удельный объём, энтальпию, энтропию и изобарную
+   *   теплоёмкость в точке (p, t) не изменяя состояние модели
+   * \param cal[in, out] На входе cal->volume - начальное приближение
+   *   удельного объёма для итерационных моделей(если не больше 0 -
+   *   не используется), на выходе - результат расчёта
+   *
+   * \return ERROR_SUCCESS_T или код ошибки. Базовая реализация
+   *   возвращает ERROR_CALC_MODEL_ST - модель не поддерживает расчёт
+   * \note Отсчёт энтальпии и энтропии моделей идеального газа,
+   *   Пенга-Робинсона, Редлиха-Квонга и Соаве-Редлиха-Квонга - начальное
+   *   состояние модели, см. set_caloric_datum, поэтому SolvePH(p0,
+   *   u0 + p0 * v0) возвращает его температуру T0. У ISO 20765 отсчёт
+   *   стандарта, тот же, что у энтальпии состояния модели
+   * */
+  virtual merror_t GetCaloric(double p, double t, caloric_point* cal);
+  /**
+   * \brief Рассчитать температуру по давлению и энтальпии
+   * \param t_init Начальное приближение температуры, если не больше 0,
+   *   то используется температура текущего состояния модели
+   * \param t[out] Температура
+   *
+   * \return ERROR_SUCCESS_T, ERROR_INIT_NULLP_ST, ошибку GetCaloric или
+   *   ERROR_CALC_MODEL_ST, если итерационная процедура не сошлась
+   * \note Метод Ньютона по (dh/dT)_p = cp с сохранением интервала,
+   *   содержащего корень: шаг за его границы или, когда найдены обе
+   *   границы, не сокращающий предыдущий шаг вдвое заменяется делением
+   *   интервала пополам. Пока одна из границ не найдена, шаг изменяет
+   *   T не более чем вдвое.
+   *   Расчёт завершается, когда шаг Ньютона или ширина интервала
+   *   становятся меньше 1e-10 * T. Если GetCaloric не рассчитан в
+   *   пробной точке, шаг к ней сокращается вдвое, ошибка возвращается
+   *   только для начального приближения. Состояние модели не изменяется
+   * \note При давлении ниже критического h(T) скачком возрастает
+   *   на теплоту испарения при смене корня уравнения состояния,
+   *   см. CubicEOS::Departure. Для h внутри скачка(двухфазная
+   *   область) интервал стягивается к температуре скачка, она и
+   *   возвращается с ERROR_SUCCESS_T: для чистого вещества это
+   *   температура насыщения при давлении p, для смеси - оценка
+   *   в однофазном приближении, доля пара не рассчитывается
+   * */
+  merror_t SolvePH(double p, double h, double t_init, double* t);
+  /**
+   * \brief Рассчитать температуру по давлению и энтропии,
+   *   (ds/dT)_p = cp / T, см. SolvePH
+   * */
+  merror_t SolvePS(double p, double s, double t_init, double* t);
+  /**
+   * \brief Рассчитать температуры для точек (p[i], h[i]), i < count
+   * \param t[out] Массив на count элементов, для точек, в которых
+   *   температура не рассчитана, записывается 0.0
+   *
+   * \return ERROR_SUCCESS_T или код ошибки последней точки, для которой
+   *   расчёт не удался
+   * \note Каждая точка использует результат предыдущей как начальное
+   *   приближение, поэтому соседние точки выгодно располагать рядом
+   * */
+  merror_t SolvePHBatch(const double* p,
+                        const double* h,
+                        size_t count,
+                        double* t);
+  /**
+   * \brief Рассчитать температуры для точек (p[i], s[i]), i < count,
+   *   см. SolvePHBatch
+   * */
+  merror_t SolvePSBatch(const double* p,
+                        const double* s,
+                        size_t count,
+                        double* t);
 
   void SetCalculationSetup(calculation_info* calculation);
 
@@ -194,6 +278,23 @@ class modelGeneral {
   int32_t set_state_phasesub(double p);
   void set_parameters(double v, double p, double t);
   void set_enthalpy();
+  /**
+   * \brief Добавить к отклонениям от идеального газа cal значения
+   *   идеального газа с постоянной теплоёмкостью ideal_cp_ и отсчёт
+   *   модели datum_enthalpy_, datum_entropy_
+   * */
+  void add_ideal_caloric(double p, double t, caloric_point* cal) const;
+  /**
+   * \brief Привязать отсчёт GetCaloric к начальному состоянию модели:
+   *   h(p0, T0) = u0 + p0 * v(p0, T0), s(p0, T0) = s0, где u0, s0 -
+   *   внутренняя энергия и энтропия динамических параметров
+   *   состояния(энтропия 0.0, если не задана)
+   * \note Вызывается в конструкторе модели после установки начального
+   *   состояния. Для модели Пенга-Робинсона внутренняя энергия
+   *   состояния и далее согласована с GetCaloric при изменении объёма
+   *   без изменения температуры, см. update_dyn_params
+   * */
+  void set_caloric_datum();
   /** \brief Инициализировать структуру параметров газа parameters_ */
   void set_gasparameters(const gas_params_input& gpi, modelGeneral* mg);
   const GasParameters* get_gasparameters() const;
@@ -218,6 +319,33 @@ class modelGeneral {
 
   std::unique_ptr<GasParameters> parameters_ = nullptr;
   std::unique_ptr<binodalpoints> bp_ = nullptr;
+  /**
+   * \brief Изобарная теплоёмкость газа в идеальном состоянии,
+   *   принимается равной исходной теплоёмкости газа(для смеси -
+   *   средней по массовым долям компонентов)
+   * */
+  double ideal_cp_ = 0.0;
+  /**
+   * \brief Слагаемые, приводящие энтальпию и энтропию GetCaloric
+   *   к отсчёту модели, см. set_caloric_datum
+   * */
+  double datum_enthalpy_ = 0.0;
+  double datum_entropy_ = 0.0;
+
+ private:
+  /**
+   * \brief Решить h(p, T) = val или s(p, T) = val относительно T
+   * */
+  merror_t solve_caloric(double p,
+                         double val,
+                         bool is_entropy,
+                         double t_init,
+                         double* t);
+  merror_t solve_caloric_batch(const double* p,
+                               const double* val,
+                               bool is_entropy,
+                               size_t count,
+                               double* t);
 };
 
 #endif  // !_CORE__MODELS__MODEL_GENERAL_H_
@@ -29,8 +29,10 @@ static model_priority ideal_gas_priority(DEF_PRIOR_IDEAL_GAS);
 Ideal_Gas::Ideal_Gas(const model_input& mi)
     : modelGeneral(mi.ms, mi.gm, mi.bp) {
   set_gasparameters(mi.gpi, this);
-  if (!error_.GetErrorCode())
+  if (!error_.GetErrorCode()) {
     set_enthalpy();
+    set_caloric_datum();
+  }
   if (mi.mpri.IsSpecified()) {
     priority_ = mi.mpri;
   } else {
@@ -110,3 +112,15 @@ double Ideal_Gas::GetPressure(double v, double t) {
   }
   return t * parameters_->cgetR() / v;
 }
+
+merror_t Ideal_Gas::GetCaloric(double p, double t, caloric_point* cal) {
+  if (cal == nullptr)
+    return ERROR_INIT_NULLP_ST;
+  if (!is_above0(p, t)) {
+    error_.SetError(ERROR_PAIR_DEFAULT(ERROR_CALC_MODEL_ST));
+    return ERROR_CALC_MODEL_ST;
+  }
+  *cal = {t * parameters_->cgetR() / p, 0.0, 0.0, 0.0};
+  add_ideal_caloric(p, t, cal);
+  return ERROR_SUCCESS_T;
+}
@@ -35,6 +35,7 @@ public:
   void SetPressure(double v, double t) override;
   double GetVolume(double p, double t) override;
   double GetPressure(double v, double t) override;
+  merror_t GetCaloric(double p, double t, caloric_point *cal) override;
 };
 
 #endif  // !_CORE__MODELS__MODEL_IDEAL_GAS_H_
@@ -14,6 +14,7 @@
 #include "gas_description_dynamic.h"
 #include "models_math.h"
 
+#include <cmath>
 #include <map>
 #include <utility>
 
@@ -139,6 +140,32 @@ double NG_Gost::GetPressure(double v, double t) {
   return 0.0;
 }
 
+merror_t NG_Gost::GetCaloric(double p, double t, caloric_point* cal) {
+#if defined(ISO_20765)
+  if (cal == nullptr)
+    return ERROR_INIT_NULLP_ST;
+  std::shared_ptr<const Gost30319Kernel> kernel =
+      static_cast<const GasParametersGost30319Dyn*>(parameters_.get())
+          ->GetKernel();
+  if (kernel && kernel->IsIso20765()) {
+    double sigma_init = 0.0;
+    if (is_above0(cal->volume))
+      sigma_init = std::pow(kernel->GetCoefs().kx, 3.0)
+                   / (kernel->GetMolarParameters().mass * cal->volume);
+    ng_gost30319_state st;
+    merror_t error = kernel->Evaluate(p, t, sigma_init, &st);
+    if (error) {
+      error_.SetError(error, "ISO 20765: ошибка расчёта калорических "
+                             "параметров смеси");
+      return error;
+    }
+    *cal = {st.volume, st.params.h, st.params.s, st.params.cp};
+    return ERROR_SUCCESS_T;
+  }
+#endif  // ISO_20765
+  return modelGeneral::GetCaloric(p, t, cal);
+}
+
 /*
 void DynamicflowAccept(class DerivateFunctor &df);
 bool IsValid() const override;
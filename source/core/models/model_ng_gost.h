@@ -41,6 +41,11 @@ class NG_Gost final : public modelGeneral {
   void SetPressure(double v, double t) override;
   double GetVolume(double p, double t) override;
   double GetPressure(double v, double t) override;
+  /**
+   * \brief Калорические параметры по ISO 20765, для ГОСТ 30319
+   *   расчёт энтальпии и энтропии не поддерживается
+   * */
+  merror_t GetCaloric(double p, double t, caloric_point* cal) override;
 
  private:
   /** \brief ссылка на параметры газа(GasParameters)
@@ -18,12 +18,11 @@
 #include <iostream>
 #endif  // _DEBUG
 #include <map>
+#include <utility>
 #include <vector>
 
 #include <assert.h>
 
-static double sq2 = 1.41421356237;  // std::sqrt(2.0);
-
 /** \brief варианты model_info для моделей Пенга-Робинсона
  *   расчитанный по псевдопараметрам. Для модели Пенга-Робинсона
  *   свой метод расчёта - по бинодальным коэффициетам
@@ -88,61 +87,71 @@ static double get_binary_associate_coef_PR(gas_t i, gas_t j) {
   return 0.0;
 }
 
-void Peng_Robinson::set_model_coef() {
-  model_coef_a_ = 0.45724 * std::pow(parameters_->cgetR(), 2.0)
-                  * std::pow(parameters_->cgetT_K(), 2.0)
-                  / parameters_->cgetP_K();
-  model_coef_b_ = 0.0778 * parameters_->cgetR() * parameters_->cgetT_K()
-                  / parameters_->cgetP_K();
-  model_coef_k_ = 0.37464 + 1.54226 * parameters_->cgetAcentricFactor()
-                  - 0.26992 * std::pow(parameters_->cgetAcentricFactor(), 2.0);
+static double calculate_ac(const const_parameters& cp) {
+  return 0.45724 * std::pow(cp.mp.Rm, 2.0)
+         * std::pow(cp.critical.temperature, 2.0) / cp.critical.pressure;
+}
+
+static double calculate_b(const const_parameters& cp) {
+  return 0.0778 * cp.mp.Rm * cp.critical.temperature / cp.critical.pressure;
 }
 
-void Peng_Robinson::set_model_coef(const const_parameters& cp) {
-  model_coef_a_ = 0.45724 * std::pow(cp.mp.Rm, 2.0)
-                  * std::pow(cp.critical.temperature, 2.0)
-                  / cp.critical.pressure;
-  model_coef_b_ =
-      0.0778 * cp.mp.Rm * cp.critical.temperature / cp.critical.pressure;
-  model_coef_k_ = 0.37464 + 1.54226 * cp.acentricfactor
-                  - 0.26992 * std::pow(cp.acentricfactor, 2.0);
+static double calculate_k(double w) {
+  return 0.37464 + 1.54226 * w - 0.26992 * w * w;
 }
 
-void Peng_Robinson::coefs_by_binary(const model_input& mi) {
+Peng_Robinson::mixing_t Peng_Robinson::set_model_coef(
+    const const_parameters& cp) {
+  model_coef_a_ = calculate_ac(cp);
+  model_coef_b_ = calculate_b(cp);
+  model_coef_k_ = calculate_k(cp.acentricfactor);
+  mixing_t mixing;
+  mixing.AddComponent(1.0, model_coef_a_, model_coef_b_,
+                      {model_coef_k_, cp.critical.temperature}, cp.mp.mass);
+  return mixing;
+}
+
+Peng_Robinson::mixing_t Peng_Robinson::coefs_by_binary(
+    const model_input& mi) {
   // available only for GAS_MIX
-  //   сделаю как в статье из университета Келдыша
-  //   (ссылку в студию)
-  if (mi.gpi.const_dyn.components->size() == 1)
-    return;
   const parameters_mix* pm_p = mi.gpi.const_dyn.components;
-  double part_x = 0.0, part_y = 0.0;
-  double k_coef = 0.0;
-  double result_a_coef = 0.0, result_b_coef = 0.0;
-  double tmp_ax_coef = 0.0;
+  mixing_t mixing;
+  std::vector<double> xsqrt_ac;
+  xsqrt_ac.reserve(pm_p->size());
   for (const auto& x : *pm_p) {
-    set_model_coef(x.second.first);
-    tmp_ax_coef = model_coef_a_;
-    result_b_coef += part_x * model_coef_b_;
-    part_x = x.first;
-    for (const auto& y : *pm_p) {
-      set_model_coef(y.second.first);
-      part_y = y.first;
-      k_coef = get_binary_associate_coef_PR(x.second.first.gas_name,
-                                            y.second.first.gas_name);
-      result_a_coef +=
-          part_x * part_y * (1.0 - k_coef) * sqrt(tmp_ax_coef * model_coef_a_);
+    const const_parameters& cp = x.second.first;
+    const double ac = calculate_ac(cp);
+    mixing.AddComponent(
+        x.first, ac, calculate_b(cp),
+        {calculate_k(cp.acentricfactor), cp.critical.temperature},
+        cp.mp.mass);
+    xsqrt_ac.push_back(x.first * std::sqrt(ac));
+  }
+  model_coef_a_ = 0.0;
+  size_t i = 0;
+  for (auto x = pm_p->begin(); x != pm_p->end(); ++x, ++i) {
+    size_t j = i;
+    for (auto y = x; y != pm_p->end(); ++y, ++j) {
+      const double k = get_binary_associate_coef_PR(x->second.first.gas_name,
+                                                    y->second.first.gas_name);
+      mixing.SetBinaryCoef(i, j, k);
+      model_coef_a_ +=
+          ((i == j) ? 1.0 : 2.0) * (1.0 - k) * xsqrt_ac[i] * xsqrt_ac[j];
     }
   }
-  model_coef_a_ = result_a_coef;
-  model_coef_b_ = result_b_coef;
-  // assert(0 && "how about model_coef_k_");
+  model_coef_b_ = mixing.B();
+  model_coef_k_ = 0.0;
+  return mixing;
 }
 
 Peng_Robinson::Peng_Robinson(const model_input& mi)
-    : modelGeneral(mi.ms, mi.gm, mi.bp) {
-  // assert(0);  // che tvorit'sya?
-  if (model_config_.model_type.subtype == MODEL_PR_SUBTYPE_BINASSOC)
-    coefs_by_binary(mi);
+    : modelCubic(mi.ms, mi.gm, mi.bp) {
+  const bool by_binary =
+      (model_config_.model_type.subtype == MODEL_PR_SUBTYPE_BINASSOC)
+      && HasGasMixMark(gm_);
+  mixing_t mixing;
+  if (by_binary)
+    mixing = coefs_by_binary(mi);
   set_gasparameters(mi.gpi, this);
   if (!error_.GetErrorCode()) {
     if (mi.mpri.IsSpecified()) {
@@ -153,12 +162,14 @@ Peng_Robinson::Peng_Robinson(const model_input& mi)
               ? pr_bin_priority
               : pr_priority;
     }
-    // assert(0);
-    set_model_coef();
+    if (!by_binary)
+      mixing = set_model_coef(parameters_->cgetConstparameters());
+    eos_ = eos_t(parameters_->cgetR(), std::move(mixing));
     // todo: incapsulate dynamicsetup
     if (parameters_->cgetDynSetup() & DYNAMIC_ENTALPHY)
       set_enthalpy();
     SetVolume(mi.gpi.p, mi.gpi.t);
+    set_caloric_datum();
   }
 }
 
@@ -178,6 +189,10 @@ Peng_Robinson* Peng_Robinson::Init(const model_input& mi) {
   return pr;
 }
 
+double Peng_Robinson::GetBinaryCoef(gas_t i, gas_t j) {
+  return get_binary_associate_coef_PR(i, j);
+}
+
 model_str Peng_Robinson::GetModelShortInfo(const rg_model_id& model_type) {
   return (model_type.subtype == MODEL_PR_SUBTYPE_BINASSOC)
              ? peng_robinson_binary_mi
@@ -188,131 +203,54 @@ model_str Peng_Robinson::GetModelShortInfo() const {
   return Peng_Robinson::GetModelShortInfo(model_config_.model_type);
 }
 
-//  расчёт смотри в ежедневнике
-double Peng_Robinson::log_pr(double v, bool is_posit) {
-  return (is_posit) ? (1.0 + sq2) * model_coef_b_ + v
-                    : (1.0 - sq2) * model_coef_b_ + v;
-}
-
-double Peng_Robinson::internal_energy_integral(const parameters new_state,
-                                               const parameters old_state,
-                                               const double Tk) {
-  double t = new_state.temperature, Tr = new_state.temperature / Tk,
-         vf = new_state.volume, v0 = old_state.volume, a = model_coef_a_,
-         b = model_coef_b_, k = model_coef_k_;
-  double ans = sq2 * 0.25 * a * k * t * t
-               * (-k * sqrt(Tr) + k - sqrt(Tr) + 2.0 + 1.0 / k)
-               * log(log_pr(vf, false) * log_pr(v0, true) / log_pr(vf, true)
-                     / log_pr(v0, false))
-               / (b * t * t);
-  return ans;
-}
-
-// return cv - cv0
-double Peng_Robinson::heat_capac_vol_integral(const parameters new_state,
-                                              const parameters prev_state,
-                                              const double Tk) {
-  double t = new_state.temperature, Tr = new_state.temperature / Tk,
-         vf = new_state.volume, v0 = prev_state.volume, a = model_coef_a_,
-         b = model_coef_b_, k = model_coef_k_;
-  double ans = sq2 * Tk * a * k * t * t * sqrt(Tr) * (-1.0 - k)
-               * log(log_pr(vf, false) * log_pr(v0, true) / log_pr(vf, true)
-                     / log_pr(v0, false))
-               / (8.0 * Tk * b * t * t * t);
-  return ans;
-}
-
-// return cp - cv
-double Peng_Robinson::heat_capac_dif_prs_vol(const parameters new_state,
-                                             const double Tk,
-                                             double R) {
-  double t = new_state.temperature, Tr = new_state.temperature / Tk,
-         v = new_state.volume, a = model_coef_a_, b = model_coef_b_,
-         k = model_coef_k_;
-  return t
-         * pow((R / (-b + v)
-                + a * k * sqrt(Tr) * (k * (-sqrt(Tr) + 1.0) + 1.0)
-                      / (t * (-b * b + 2.0 * b * v + v * v))),
-               2.0)
-         / (R * t / pow((-b + v), 2.0)
-            - a * (-2.0 * b - 2.0 * v) * pow((k * (-sqrt(Tr) + 1.0) + 1.0), 2.0)
-                  / pow((-b * b + 2.0 * b * v + v * v), 2.0));
-}
-
 double Peng_Robinson::get_volume(double p,
                                  double t,
                                  const const_parameters& cp) {
-  double alf =
-      std::pow(1.0 + model_coef_k_ * (1.0 - t / cp.critical.temperature), 2.0);
-  std::vector<double> coef{
-      1.0,
-      model_coef_b_ - cp.mp.Rm * t / p,
-      (model_coef_a_ * alf - 2.0 * model_coef_b_ * cp.mp.Rm * t) / p
-          - 3.0 * model_coef_b_ * model_coef_b_,
-      std::pow(model_coef_b_, 3.0f)
-          + (cp.mp.Rm * t * model_coef_b_ * model_coef_b_
-             - model_coef_a_ * alf * model_coef_b_)
-                / p,
-      0.0,
-      0.0,
-      0.0};
-  int roots_count;
-  CardanoMethod_roots_count(&coef[0], &coef[4], &roots_count);
+  const double v = make_pure_eos(cp).Volume(p, t);
 #ifdef _DEBUG
-  if (!is_above0(coef[4])) {
+  if (!is_above0(v)) {
     error_.SetError(ERROR_PAIR_DEFAULT(ERROR_CALC_MODEL_ST));
     error_.LogIt(io_loglvl::debug_logs);
     return 0.0;
   }
 #endif
-  return coef[4];
+  return v;
 }
 
 double Peng_Robinson::get_pressure(double v,
                                    double t,
                                    const const_parameters& cp) {
-  const double a = std::pow(
-      1.0
-          + model_coef_k_
-                * std::pow(1.0 - std::sqrt(t / cp.critical.temperature), 2.0),
-      2.0);
-  const double temp =
-      cp.mp.Rm * t / (v - model_coef_b_)
-      - a * model_coef_a_
-            / (v * v + 2.0 * model_coef_b_ * v - model_coef_b_ * model_coef_b_);
-  return temp;
+  return make_pure_eos(cp).Pressure(v, t);
 }
 
-void Peng_Robinson::update_dyn_params(dyn_parameters& prev_state,
-                                      const parameters new_state) {
-  double du = internal_energy_integral(new_state, prev_state.parm,
-                                       parameters_->cgetT_K());
-  double dcv = heat_capac_vol_integral(new_state, prev_state.parm,
-                                       parameters_->cgetT_K());
-  double dif_c = heat_capac_dif_prs_vol(new_state, parameters_->cgetT_K(),
-                                        parameters_->cgetR());
-  prev_state.internal_energy += du;
-  prev_state.heat_cap_vol += dcv;
-  prev_state.heat_cap_pres = prev_state.heat_cap_vol + dif_c;
+template <class Eos>
+void Peng_Robinson::update_dyn_params_eos(dyn_parameters& prev_state,
+                                          const parameters new_state,
+                                          const Eos& eos) {
+  const double t = new_state.temperature, v = new_state.volume,
+               v0 = prev_state.parm.volume;
+  double a_t, a_tt;
+  const double a = eos.A(t, &a_t, &a_tt);
+  const cubic_eos_derivatives d = eos.Derivatives(v, t, a, a_t, a_tt);
+  prev_state.internal_energy += eos.InternalEnergyIntegral(v0, v, t, a, a_t);
+  prev_state.heat_cap_vol += eos.HeatCapVolIntegral(v0, v, t, a_tt);
+  // cp - cv = -T * (dP/dT)^2 / (dP/dv)
+  prev_state.heat_cap_pres =
+      prev_state.heat_cap_vol - t * d.dp_dt * d.dp_dt / d.dp_dv;
   prev_state.parm = new_state;
   prev_state.Update();
 }
 
+void Peng_Robinson::update_dyn_params(dyn_parameters& prev_state,
+                                      const parameters new_state) {
+  update_dyn_params_eos(prev_state, new_state, eos_);
+}
+
 // функция вызывается из класса GasParameters_dyn
 void Peng_Robinson::update_dyn_params(dyn_parameters& prev_state,
                                       const parameters new_state,
                                       const const_parameters& cp) {
-  double du = internal_energy_integral(new_state, prev_state.parm,
-                                       cp.critical.temperature);
-  double dcv = heat_capac_vol_integral(new_state, prev_state.parm,
-                                       cp.critical.temperature);
-  double dif_c =
-      heat_capac_dif_prs_vol(new_state, cp.critical.temperature, cp.mp.Rm);
-  prev_state.internal_energy += du;
-  prev_state.heat_cap_vol += dcv;
-  prev_state.heat_cap_pres = prev_state.heat_cap_vol + dif_c;
-  prev_state.parm = new_state;
-  prev_state.Update();
+  update_dyn_params_eos(prev_state, new_state, make_pure_eos(cp));
 }
 
 void Peng_Robinson::DynamicflowAccept(DerivateFunctor& df) {
@@ -355,30 +293,15 @@ double Peng_Robinson::GetVolume(double p, double t) {
     error_.SetError(ERROR_PAIR_DEFAULT(ERROR_CALC_MODEL_ST));
     return 0.0;
   }
-  double alf =
-      std::pow(1.0 + model_coef_k_ * (1.0 - t / parameters_->cgetT_K()), 2.0);
-  std::vector<double> coef{
-      1.0,
-      model_coef_b_ - parameters_->cgetR() * t / p,
-      (model_coef_a_ * alf - 2.0 * model_coef_b_ * parameters_->cgetR() * t) / p
-          - 3.0 * model_coef_b_ * model_coef_b_,
-      std::pow(model_coef_b_, 3.0)
-          + (parameters_->cgetR() * t * model_coef_b_ * model_coef_b_
-             - model_coef_a_ * alf * model_coef_b_)
-                / p,
-      0.0,
-      0.0,
-      0.0};
-  int roots_count;
-  CardanoMethod_roots_count(&coef[0], &coef[4], &roots_count);
+  const double v = eos_.Volume(p, t);
 #ifdef _DEBUG
-  if (!is_above0(coef[4])) {
+  if (!is_above0(v)) {
     error_.SetError(ERROR_PAIR_DEFAULT(ERROR_CALC_MODEL_ST));
     error_.LogIt();
     return 0.0;
   }
 #endif
-  return coef[4];
+  return v;
 }
 
 double Peng_Robinson::GetPressure(double v, double t) {
@@ -386,18 +309,15 @@ double Peng_Robinson::GetPressure(double v, double t) {
     error_.SetError(ERROR_PAIR_DEFAULT(ERROR_CALC_MODEL_ST));
     return 0.0;
   }
-  const double a = std::pow(
-                   1.0
-                       + model_coef_k_
-                             * std::pow(
-                                 1.0 - std::sqrt(t / parameters_->cgetT_K()),
-                                 2.0),
-                   2.0),
-               temp = parameters_->cgetR() * t / (v - model_coef_b_)
-                      - a * model_coef_a_
-                            / (v * v + 2.0 * model_coef_b_ * v
-                               - model_coef_b_ * model_coef_b_);
-  return temp;
+  return eos_.Pressure(v, t);
+}
+
+Peng_Robinson::pure_eos_t Peng_Robinson::make_pure_eos(
+    const const_parameters& cp) {
+  return pure_eos_t(cp.mp.Rm,
+                    {calculate_ac(cp), calculate_b(cp),
+                     {calculate_k(cp.acentricfactor),
+                      cp.critical.temperature}});
 }
 
 double Peng_Robinson::GetCoefficient_a() const {
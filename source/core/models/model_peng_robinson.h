@@ -12,14 +12,21 @@
 
 #include "atherm_common.h"
 #include "gas_description_mix.h"
-#include "model_general.h"
+#include "model_cubic.h"
 
 #include <memory>
 
-class Peng_Robinson final: public modelGeneral {
+class Peng_Robinson final: public modelCubic<CubicEOS<peng_robinson_traits,
+                                                     mixing_vdw<alpha_soave>>> {
+public:
+  typedef mixing_vdw<alpha_soave> mixing_t;
+
 public:
   static Peng_Robinson *Init(const model_input &mi);
   static model_str GetModelShortInfo(const rg_model_id &model_type);
+  /** \brief Коэффициент бинарного взаимодействия k_ij компонентов
+    *   i и j, 0.0 если для пары коэффициент не задан */
+  static double GetBinaryCoef(gas_t i, gas_t j);
 
   model_str GetModelShortInfo() const override;
 
@@ -38,16 +45,17 @@ public:
 private:
   Peng_Robinson(const model_input &mi);
 
-  /** \brief Установить коэфициенты модели model_coef_a_, model_coef_b_ и
-    *   model_coef_k_ по параметрам газа parameters_ */
-  void set_model_coef();
-  /** \brief Установить коэфициенты модели model_coef_a_, model_coef_b_ и
-    *   model_coef_k_ по переданным параметрам cp  */
-  void set_model_coef(const const_parameters &cp);
-  /** \brief Установить коэфициенты модели model_coef_a_, model_coef_b_ и
-    *   model_coef_k_ для газовой смеси используя коэффициенты бинарного
-    *   взаимодействия компонентов */
-  void coefs_by_binary(const model_input &mi);
+  /** \brief Установить коэфициенты модели model_coef_a_, model_coef_b_,
+    *   model_coef_k_ по переданным параметрам cp(для смеси -
+    *   по псевдокритическим параметрам)
+    * \return правило смешения с одним компонентом для eos_ */
+  mixing_t set_model_coef(const const_parameters &cp);
+  /** \brief Правило смешения для газовой смеси используя коэффициенты
+    *   бинарного взаимодействия компонентов: матрица k_ij и параметры
+    *   компонентов (a_c, b, k) рассчитываются один раз, зависимость
+    *   от температуры учитывается для каждого компонента отдельно.
+    *   model_coef_a_ - значение a при alpha_i(T) = 1, model_coef_k_ = 0 */
+  mixing_t coefs_by_binary(const model_input &mi);
 
 
   void update_dyn_params(dyn_parameters &prev_state,
@@ -55,13 +63,15 @@ private:
   void update_dyn_params(dyn_parameters &prev_state,
       const parameters new_state, const const_parameters &cp) override;
 
-  double log_pr(double v, bool is_posit);
-  double internal_energy_integral(const parameters new_state,
-      const parameters prev_state, const double Tk);
-  double heat_capac_vol_integral(const parameters new_state,
-      const parameters prev_state, const double Tk);
-  double heat_capac_dif_prs_vol(const parameters new_state,
-      const double Tk, double R);
+  /** \brief Обновить динамические параметры по изотермическим
+    *   интегралам ядра eos(eos_ или make_pure_eos) в точке new_state */
+  template <class Eos>
+  void update_dyn_params_eos(dyn_parameters &prev_state,
+      const parameters new_state, const Eos &eos);
+  typedef CubicEOS<peng_robinson_traits, mixing_pure<alpha_soave>>
+      pure_eos_t;
+  /** \brief Ядро расчёта для чистого газа с параметрами cp */
+  static pure_eos_t make_pure_eos(const const_parameters &cp);
 // sub functions to update parameters
   double get_volume(double p, double t, const const_parameters &cp);
   double get_pressure(double v, double t, const const_parameters &cp);
@@ -70,6 +80,5 @@ private:
   double model_coef_a_,
          model_coef_b_,
          model_coef_k_;
-
 };
 #endif  // !_CORE__MODELS__MODEL_PENG_ROBINSON_H_
@@ -57,7 +57,7 @@ void Redlich_Kwong2::gasmix_model_coefs(const model_input& mi) {
 }
 
 Redlich_Kwong2::Redlich_Kwong2(const model_input& mi)
-    : modelGeneral(mi.ms, mi.gm, mi.bp) {
+    : modelCubic(mi.ms, mi.gm, mi.bp) {
   if (HasGasMixMark(gm_)) {
     /* газовая смесь: */
     /* установить коэфициенты модели для смеси */
@@ -79,9 +79,11 @@ Redlich_Kwong2::Redlich_Kwong2(const model_input& mi)
     } else {
       priority_ = rk_priority;
     }
+    eos_ = make_eos(parameters_->cgetR());
     if (parameters_->cgetDynSetup() & DYNAMIC_ENTALPHY)
       set_enthalpy();
     SetVolume(mi.gpi.p, mi.gpi.t);
+    set_caloric_datum();
   }
 }
 
@@ -151,38 +153,25 @@ double Redlich_Kwong2::get_volume(double p,
                                   double t,
                                   const const_parameters& cp) {
   set_model_coef(cp);
-  std::vector<double> coef{1.0,
-                           -cp.mp.Rm * t / p,
-                           model_coef_a_ / (p * std::sqrt(t))
-                               - cp.mp.Rm * t * model_coef_b_ / p
-                               - model_coef_b_ * model_coef_b_,
-                           -model_coef_a_ * model_coef_b_ / (p * std::sqrt(t)),
-                           0.0,
-                           0.0,
-                           0.0};
   // Следующая функция заведомо получает валидные
   //   данные,  соответственно должна что-то вернуть
   //   Не будем перегружать код лишними проверками
-  int roots_count;
-  CardanoMethod_roots_count(&coef[0], &coef[4], &roots_count);
+  const double v = make_eos(cp.mp.Rm).Volume(p, t);
 #ifdef _DEBUG
-  if (!is_above0(coef[4])) {
+  if (!is_above0(v)) {
     error_.SetError(ERROR_PAIR_DEFAULT(ERROR_CALC_MODEL_ST));
     error_.LogIt();
     return 0.0;
   }
 #endif  // _DEBUG
-  return coef[4];
+  return v;
 }
 
 double Redlich_Kwong2::get_pressure(double v,
                                     double t,
                                     const const_parameters& cp) {
   set_model_coef(cp);
-  const double temp =
-      cp.mp.Rm * t / (v - model_coef_b_)
-      - model_coef_a_ / (std::sqrt(t) * v * (v + model_coef_b_));
-  return temp;
+  return make_eos(cp.mp.Rm).Pressure(v, t);
 }
 
 void Redlich_Kwong2::update_dyn_params(dyn_parameters& prev_state,
@@ -253,28 +242,18 @@ double Redlich_Kwong2::GetVolume(double p, double t) {
     error_.SetError(ERROR_PAIR_DEFAULT(ERROR_CALC_MODEL_ST));
     return 0.0;
   }
-  std::vector<double> coef{1.0,
-                           -parameters_->cgetR() * t / p,
-                           model_coef_a_ / (p * std::sqrt(t))
-                               - parameters_->cgetR() * t * model_coef_b_ / p
-                               - model_coef_b_ * model_coef_b_,
-                           -model_coef_a_ * model_coef_b_ / (p * std::sqrt(t)),
-                           0.0,
-                           0.0,
-                           0.0};
   // Следующая функция заведомо получает валидные
   //   данные,  соответственно должна что-то вернуть
   //   Не будем перегружать код лишними проверками
-  int roots_count;
-  CardanoMethod_roots_count(&coef[0], &coef[4], &roots_count);
+  const double v = eos_.Volume(p, t);
 #ifdef _DEBUG
-  if (!is_above0(coef[4])) {
+  if (!is_above0(v)) {
     error_.SetError(ERROR_PAIR_DEFAULT(ERROR_CALC_MODEL_ST));
     error_.LogIt();
     return 0.0;
   }
 #endif  // _DEBUG
-  return coef[4];
+  return v;
 }
 
 double Redlich_Kwong2::GetPressure(double v, double t) {
@@ -282,10 +261,11 @@ double Redlich_Kwong2::GetPressure(double v, double t) {
     error_.SetError(ERROR_PAIR_DEFAULT(ERROR_CALC_MODEL_ST));
     return 0.0;
   }
-  const double temp =
-      parameters_->cgetR() * t / (v - model_coef_b_)
-      - model_coef_a_ / (std::sqrt(t) * v * (v + model_coef_b_));
-  return temp;
+  return eos_.Pressure(v, t);
+}
+
+Redlich_Kwong2::eos_t Redlich_Kwong2::make_eos(double R) const {
+  return eos_t(R, {model_coef_a_, model_coef_b_, alpha_rk()});
 }
 
 double Redlich_Kwong2::GetCoefficient_a() const {
@@ -12,13 +12,14 @@
 
 #include "atherm_common.h"
 #include "gas_description_mix.h"
-#include "model_general.h"
+#include "model_cubic.h"
 
 #include <memory>
 
 /** \brief Классическая интерпретация уравнения состояния
   *   Редлиха-Квонга(с sqrt(T) в знаменателе) */
-class Redlich_Kwong2 final: public modelGeneral {
+class Redlich_Kwong2 final: public modelCubic<CubicEOS<redlich_kwong_traits,
+                                                      mixing_pure<alpha_rk>>> {
 public:
   static Redlich_Kwong2 *Init(const model_input &mi);
   static model_str GetModelShortInfo(const rg_model_id &model_type);
@@ -63,6 +64,9 @@ private:
   double heat_capac_vol_integral(const parameters new_state,
       const parameters prev_state);
   double heat_capac_dif_prs_vol(const parameters new_state, double R);
+  /** \brief Ядро расчёта по текущим коэффициентам модели
+    * \param R удельная газовая постоянная */
+  eos_t make_eos(double R) const;
 // sub functions to update parameters
   double get_volume(double p, double t, const const_parameters &cp);
   double get_pressure(double v, double t, const const_parameters &cp);
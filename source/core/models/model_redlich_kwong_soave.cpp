@@ -14,6 +14,7 @@
 #include "models_math.h"
 
 #include <numeric>
+#include <utility>
 
 #include <assert.h>
 
@@ -143,69 +144,42 @@ double Redlich_Kwong_Soave::calculate_F(double t,
 #endif  // RPS_FUNCTIONS
 
 void Redlich_Kwong_Soave::update_coef_a(double t) {
-  if (HasGasMixMark(gm_)) {
-    update_gasmix_coef_a(t);
-  } else {
-    model_coef_a_ =
-        coef_ac_ * const_rks_vals_[0].calculate_a(t / parameters_->cgetT_K());
-  }
+  model_coef_a_ = eos_.A(t);
 }
 
-void Redlich_Kwong_Soave::update_gasmix_coef_a(double t) {
-  /* todo: redo this ಥʖ̯ಥ(sadness cry)
-   *   indexes and iterators */
-  GasParameters_mix_dyn* gp =
-      dynamic_cast<GasParameters_mix_dyn*>(parameters_.get());
-  if (!gp) {
-    error_.SetError(ERROR_CALC_MIX_ST, "dyn_cast");
-    error_.LogIt(io_loglvl::debug_logs);
-    status_ = STATUS_HAVE_ERROR;
-    return;
-  }
-  const parameters_mix& prs = gp->GetComponents();
-  std::vector<double> a(prs.size(), 0.0);
-  int i = 0, j = 0;
-  auto prs_it = prs.begin();
-  model_coef_a_ = 0.0;
-  for (const auto& x : const_rks_vals_) {
-    a[i++] = x.calculate_a(t / prs_it->second.first.critical.temperature);
-    prs_it++;
-  }
-  i = 0;
-  for (const auto& x : prs) {
-    j = 0;
-    for (const auto& y : prs) {
-      model_coef_a_ += (1.0
-                        - get_binary_associate_coef_SRK(
-                            x.second.first.gas_name, y.second.first.gas_name))
-                       * x.first * y.first * sqrt(a[i] * a[j]);
-      ++j;
-    }
-    ++i;
-  }
+Redlich_Kwong_Soave::mixing_t Redlich_Kwong_Soave::set_pure_gas_vals(
+    const const_parameters& cp) {
+  mixing_t mixing;
+  mixing.AddComponent(
+      1.0, calculate_ac(cp), calculate_b(cp),
+      {calculate_fw(cp.acentricfactor), cp.critical.temperature},
+      cp.mp.mass);
+  model_coef_b_ = mixing.B();
+  return mixing;
 }
 
-void Redlich_Kwong_Soave::set_pure_gas_vals(const const_parameters& cp) {
-  coef_ac_ = 0.42747 * std::pow(cp.mp.Rm, 2.0)
-             * std::pow(cp.critical.temperature, 2.0) / cp.critical.pressure;
-  model_coef_b_ =
-      0.08664 * cp.mp.Rm * cp.critical.temperature / cp.critical.pressure;
-  const_rks_vals_ = std::vector<const_rks_val>();
-  const_rks_vals_.push_back(
-      const_rks_val(calculate_ac(cp), calculate_fw(cp.acentricfactor)));
-}
-
-void Redlich_Kwong_Soave::set_rks_const_vals(const parameters_mix* components) {
+Redlich_Kwong_Soave::mixing_t Redlich_Kwong_Soave::set_rks_const_vals(
+    const parameters_mix* components) {
   /* расчитать константные части функций коэффициентов */
   //   const_rks_vals_rps_.set_vals(components);
-  const_rks_vals_ = std::vector<const_rks_val>();
-  std::transform(
-      components->begin(), components->end(),
-      std::back_insert_iterator<std::vector<const_rks_val>>(const_rks_vals_),
-      [](const std::pair<const double, const_dyn_parameters>& p) {
-        return const_rks_val(calculate_ac(p.second.first),
-                             calculate_fw(p.second.first.acentricfactor));
-      });
+  mixing_t mixing;
+  for (const auto& x : *components) {
+    const const_parameters& cp = x.second.first;
+    mixing.AddComponent(
+        x.first, calculate_ac(cp), calculate_b(cp),
+        {calculate_fw(cp.acentricfactor), cp.critical.temperature},
+        cp.mp.mass);
+  }
+  size_t i = 0;
+  for (auto x = components->begin(); x != components->end(); ++x, ++i) {
+    size_t j = i;
+    for (auto y = x; y != components->end(); ++y, ++j)
+      mixing.SetBinaryCoef(
+          i, j,
+          get_binary_associate_coef_SRK(x->second.first.gas_name,
+                                        y->second.first.gas_name));
+  }
+  return mixing;
 }
 
 void Redlich_Kwong_Soave::set_gasmix_model_coefs(const model_input& mi) {
@@ -251,10 +225,11 @@ void Redlich_Kwong_Soave::gasmix_model_coefs_rps(const model_input& mi) {
 #endif  // RPS_FUNCTIONS
 
 Redlich_Kwong_Soave::Redlich_Kwong_Soave(const model_input& mi)
-    : modelGeneral(mi.ms, mi.gm, mi.bp) {
+    : modelCubic(mi.ms, mi.gm, mi.bp) {
+  mixing_t mixing;
   if (HasGasMixMark(gm_)) {
     /* газовая смесь: */
-    set_rks_const_vals(mi.gpi.const_dyn.components);
+    mixing = set_rks_const_vals(mi.gpi.const_dyn.components);
     // const_rks_vals_rps_.set_vals(mi.gpi.const_dyn.components);
     /* установить коэфициенты модели для смеси */
     set_gasmix_model_coefs(mi);
@@ -265,7 +240,7 @@ Redlich_Kwong_Soave::Redlich_Kwong_Soave(const model_input& mi)
     set_gasparameters(mi.gpi, this);
   } else {
     /* установить коэфициенты модели для смеси */
-    set_pure_gas_vals(*mi.gpi.const_dyn.cdp.cgp);
+    mixing = set_pure_gas_vals(*mi.gpi.const_dyn.cdp.cgp);
     /* чистый газ: */
     /* задать параметры газа, инициализровать
      *   начальные параметры смеси - v, cp, cv, u...*/
@@ -277,10 +252,12 @@ Redlich_Kwong_Soave::Redlich_Kwong_Soave(const model_input& mi)
     } else {
       priority_ = rks_priority;
     }
-    update_gasmix_coef_a(mi.gpi.t);
+    eos_ = eos_t(parameters_->cgetR(), std::move(mixing));
+    update_coef_a(mi.gpi.t);
     if (parameters_->cgetDynSetup() & DYNAMIC_ENTALPHY)
       set_enthalpy();
     SetVolume(mi.gpi.p, mi.gpi.t);
+    set_caloric_datum();
     status_ = STATUS_OK;
   }
 }
@@ -301,6 +278,10 @@ Redlich_Kwong_Soave* Redlich_Kwong_Soave::Init(const model_input& mi) {
   return rk;
 }
 
+double Redlich_Kwong_Soave::GetBinaryCoef(gas_t i, gas_t j) {
+  return get_binary_associate_coef_SRK(i, j);
+}
+
 model_str Redlich_Kwong_Soave::GetModelShortInfo(const rg_model_id&) {
   return redlich_kwong_soave_mi;
 }
@@ -371,28 +352,18 @@ double Redlich_Kwong_Soave::GetVolume(double p, double t) {
     error_.SetError(ERROR_PAIR_DEFAULT(ERROR_CALC_MODEL_ST));
     return 0.0;
   }
-  std::vector<double> coef{1.0,
-                           -parameters_->cgetR() * t / p,
-                           model_coef_a_ / p
-                               - parameters_->cgetR() * t * model_coef_b_ / p
-                               - model_coef_b_ * model_coef_b_,
-                           -model_coef_a_ * model_coef_b_ / p,
-                           0.0,
-                           0.0,
-                           0.0};
   // Следующая функция заведомо получает валидные
   //   данные,  соответственно должна что-то вернуть
   //   Не будем перегружать код лишними проверками
-  int roots_count;
-  CardanoMethod_roots_count(&coef[0], &coef[4], &roots_count);
+  const double v = eos_.Volume(p, t, model_coef_a_);
 #ifdef _DEBUG
-  if (!is_above0(coef[4])) {
+  if (!is_above0(v)) {
     error_.SetError(ERROR_PAIR_DEFAULT(ERROR_CALC_MODEL_ST));
     error_.LogIt();
     return 0.0;
   }
 #endif  // _DEBUG
-  return coef[4];
+  return v;
 }
 
 double Redlich_Kwong_Soave::GetPressure(double v, double t) {
@@ -402,16 +373,7 @@ double Redlich_Kwong_Soave::GetPressure(double v, double t) {
     status_ = STATUS_HAVE_ERROR;
     return 0.0;
   }
-  const double temp = parameters_->cgetR() * t / (v - model_coef_b_)
-                      - model_coef_a_ / (v * (v + model_coef_b_));
-  return temp;
-}
-
-Redlich_Kwong_Soave::const_rks_val::const_rks_val(double ac, double fw)
-    : ac(ac), fw(fw) {}
-
-double Redlich_Kwong_Soave::const_rks_val::calculate_a(double tr) const {
-  return ac * pow(1.0 + fw * (1.0 - sqrt(tr)), 2.0);
+  return eos_.Pressure(v, t, model_coef_a_);
 }
 
 #ifdef RPS_FUNCTIONS
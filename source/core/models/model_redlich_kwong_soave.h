@@ -12,21 +12,31 @@
 
 #include "atherm_common.h"
 #include "gas_description_mix.h"
-#include "model_general.h"
+#include "model_cubic.h"
 
 #include <array>
 #include <memory>
 
 #ifdef RKS_UNITTEST
-class Redlich_Kwong_Soave: public modelGeneral {
+class Redlich_Kwong_Soave
+    : public modelCubic<CubicEOS<redlich_kwong_traits,
+                                 mixing_vdw<alpha_soave>>> {
 #else
 /** \brief Модификация Соаве уравнения состояния
   *   Редлиха-Квонга */
-class Redlich_Kwong_Soave final: public modelGeneral {
+class Redlich_Kwong_Soave final
+    : public modelCubic<CubicEOS<redlich_kwong_traits,
+                                 mixing_vdw<alpha_soave>>> {
 #endif  // RKS_UNITTEST
+public:
+  typedef mixing_vdw<alpha_soave> mixing_t;
+
 public:
   static Redlich_Kwong_Soave *Init(const model_input &mi);
   static model_str GetModelShortInfo(const rg_model_id &);
+  /** \brief Коэффициент бинарного взаимодействия k_ij компонентов
+    *   i и j, см. Peng_Robinson::GetBinaryCoef */
+  static double GetBinaryCoef(gas_t i, gas_t j);
 
   model_str GetModelShortInfo() const override;
 
@@ -61,14 +71,13 @@ protected:
   /** \brief Пересчитать коэффициент model_coef_a_ для новых
     *   параметров t / p */
   void update_coef_a(double t);
-  /** \brief Пересчитать коэффициент model_coef_a_ для новых
-    *   параметров t / p для смесей */
-  void update_gasmix_coef_a(double t);
-  /** \brief Установить коэфициенты модели model_coef_a_ и model_coef_b_
-    *   по переданным параметрам cp  */
-  void set_pure_gas_vals(const const_parameters &cp);
-  /** \brief Инициализироавть const_rks_vals_ */
-  void set_rks_const_vals(const parameters_mix *components);
+  /** \brief Установить коэфициент модели model_coef_b_
+    *   по переданным параметрам cp
+    * \return правило смешения с одним компонентом для eos_ */
+  mixing_t set_pure_gas_vals(const const_parameters &cp);
+  /** \brief Правило смешения для газовой смеси с коэффициентами
+    *   бинарного взаимодействия k_ij */
+  mixing_t set_rks_const_vals(const parameters_mix *components);
   /* классический подход из книг Бруссиловского, алсо см. Публикации Соаве */
   /** \brief Установить коэфициенты модели model_coef_a_ и model_coef_b_
     *   для газовой смеси по методу Соаве-Редлиха-Квонга */
@@ -99,23 +108,7 @@ protected:
   } const_rks_vals_rps_;
 #  endif  // UNDEFINED_DEFINE
 
-  struct const_rks_val {
-    /// SRK: 0.42747 R^2 * Tc^2 / Pc
-    double ac;
-    /// SRK: 0.480 + 1.574w - 0.176w^2
-    double fw;
-
-    const_rks_val() = delete;
-    const_rks_val(double ac, double fw);
-    /** \brief рассчитать коэффициент а(tr) модели Соаве-Редлиха-Квонга
-      *   tr = t / T_k*/
-    double calculate_a(double tr) const;
-  };
-  std::vector<const_rks_val> const_rks_vals_;
-
-  /// SRK: ac - const для чистого газа
-  double coef_ac_;
-  /// SRK: model_coef_a_ = ac * a(T, w)
+  /// SRK: model_coef_a_ = a(T)
   double model_coef_a_;
   double model_coef_b_;
 };
@@ -0,0 +1,220 @@
+/**
+ * asp_therm - implementation of real gas equations of state
+ *
+ *
+ * Copyright (c) 2020-2021 Mishutinski Yurii
+ *
+ * This library is distributed under the MIT License.
+ * See LICENSE file in the project root for full license information.
+ */
+#include "binodal_table.h"
+
+#include "asp_utils/Logging.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <limits>
+
+#include <string.h>
+
+#define BINODAL_TABLE_MAGIC "ATHBINOD"
+#define BINODAL_TABLE_VERSION 1
+#define BINODAL_TABLE_BYTE_ORDER 0x01020304
+
+static_assert(sizeof(binodal_table_header) % sizeof(double) == 0,
+              "binodal table: arrays after the header must be aligned");
+
+BinodalTable::BinodalTable(rg_model_id mn,
+                           const std::vector<double>& t_grid,
+                           double w_min,
+                           double w_step,
+                           size_t w_count)
+    : mn_(mn),
+      t_(t_grid),
+      w_min_(w_min),
+      w_step_(w_step),
+      w_count_(w_count),
+      data_(3 * t_grid.size() * w_count,
+            std::numeric_limits<double>::quiet_NaN()) {}
+
+/** \brief Проверить сетку таблицы: приведённые температуры в (0, 1),
+ *   шаг по фактору ацентричности положителен */
+static bool is_valid_grid(const std::vector<double>& t_grid,
+                          double w_min,
+                          double w_step,
+                          size_t w_count) {
+  return !t_grid.empty() && w_count > 0 && std::isfinite(w_min)
+         && std::isfinite(w_step) && (w_count == 1 || w_step > 0.0)
+         && std::all_of(t_grid.begin(), t_grid.end(),
+                        [](double t) { return t > 0.0 && t < 1.0; });
+}
+
+/** \brief Размер файла таблицы с t_count температурами и w_count
+ *   факторами ацентричности в байтах
+ * \return 0 если размер не представим в uint64_t */
+static uint64_t binodal_table_file_size(uint32_t t_count, uint32_t w_count) {
+  // t[t_count] и 3 массива по t_count * w_count значений
+  const uint64_t row = 1 + 3 * uint64_t(w_count),
+                 max_values = (std::numeric_limits<uint64_t>::max()
+                               - sizeof(binodal_table_header))
+                              / sizeof(double);
+  if (t_count == 0 || row > max_values / t_count)
+    return 0;
+  return sizeof(binodal_table_header) + sizeof(double) * t_count * row;
+}
+
+BinodalTable* BinodalTable::Init(rg_model_id mn,
+                                 const std::vector<double>& t_grid,
+                                 double w_min,
+                                 double w_step,
+                                 size_t w_count) {
+  if (!PhaseDiagram::IsValidModel(mn)
+      || !is_valid_grid(t_grid, w_min, w_step, w_count)) {
+    Logging::Append(ERROR_INIT_T,
+                    "binodal table: model must be supported by phase diagram, "
+                    "temperatures must lie in (0, 1)");
+    return nullptr;
+  }
+  BinodalTable* table = new BinodalTable(mn, t_grid, w_min, w_step, w_count);
+  const PhaseDiagram& pd = PhaseDiagram::GetCalculated();
+  const size_t size = t_grid.size() * w_count;
+  maxwell_point pt;
+  for (size_t i = 0; i < t_grid.size(); ++i) {
+    for (size_t j = 0; j < w_count; ++j) {
+      if (pd.CalculateBinodalPoint(mn, t_grid[i], w_min + j * w_step, &pt))
+        continue;
+      table->data_[i * w_count + j] = pt.p;
+      table->data_[size + i * w_count + j] = pt.vLeft;
+      table->data_[2 * size + i * w_count + j] = pt.vRigth;
+    }
+  }
+  return table;
+}
+
+BinodalTable* BinodalTable::Init(const std::string& path) {
+  std::ifstream file(path, std::ios::binary | std::ios::ate);
+  if (!file) {
+    Logging::Append(ERROR_FILE_EXISTS_ST,
+                    "binodal table: cannot open file " + path);
+    return nullptr;
+  }
+  const std::streamoff file_size = file.tellg();
+  file.seekg(0);
+  binodal_table_header h;
+  file.read(reinterpret_cast<char*>(&h), sizeof(h));
+  const rg_model_id mn(rg_model_t(h.model_type),
+                       rg_model_subtype(h.model_subtype));
+  const bool valid_header =
+      file && memcmp(h.magic, BINODAL_TABLE_MAGIC, sizeof(h.magic)) == 0
+      && h.version == BINODAL_TABLE_VERSION
+      && h.byte_order == BINODAL_TABLE_BYTE_ORDER
+      && PhaseDiagram::IsValidModel(mn);
+  if (!valid_header) {
+    Logging::Append(ERROR_FILE_IN_ST,
+                    "binodal table: wrong header of file " + path);
+    return nullptr;
+  }
+  // размеры массивов из заголовка сверяются с размером файла до
+  //   выделения памяти под них
+  const uint64_t expected_size =
+      binodal_table_file_size(h.t_count, h.w_count);
+  if (expected_size == 0 || file_size < 0
+      || uint64_t(file_size) != expected_size
+      || expected_size > std::numeric_limits<size_t>::max()) {
+    Logging::Append(ERROR_FILE_IN_ST,
+                    "binodal table: wrong size of file " + path);
+    return nullptr;
+  }
+  std::vector<double> t_grid(h.t_count);
+  file.read(reinterpret_cast<char*>(t_grid.data()),
+            t_grid.size() * sizeof(double));
+  if (!file || !is_valid_grid(t_grid, h.w_min, h.w_step, h.w_count)) {
+    Logging::Append(ERROR_FILE_IN_ST,
+                    "binodal table: wrong grid in file " + path);
+    return nullptr;
+  }
+  BinodalTable* table =
+      new BinodalTable(mn, t_grid, h.w_min, h.w_step, h.w_count);
+  file.read(reinterpret_cast<char*>(table->data_.data()),
+            table->data_.size() * sizeof(double));
+  if (!file) {
+    Logging::Append(ERROR_FILE_IN_ST,
+                    "binodal table: cannot read file " + path);
+    delete table;
+    return nullptr;
+  }
+  return table;
+}
+
+merror_t BinodalTable::Save(const std::string& path) const {
+  binodal_table_header h;
+  memcpy(h.magic, BINODAL_TABLE_MAGIC, sizeof(h.magic));
+  h.version = BINODAL_TABLE_VERSION;
+  h.byte_order = BINODAL_TABLE_BYTE_ORDER;
+  h.model_type = int32_t(mn_.type);
+  h.model_subtype = int32_t(mn_.subtype);
+  h.t_count = uint32_t(t_.size());
+  h.w_count = uint32_t(w_count_);
+  h.w_min = w_min_;
+  h.w_step = w_step_;
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  file.write(reinterpret_cast<const char*>(&h), sizeof(h));
+  file.write(reinterpret_cast<const char*>(t_.data()),
+             t_.size() * sizeof(double));
+  file.write(reinterpret_cast<const char*>(data_.data()),
+             data_.size() * sizeof(double));
+  if (!file) {
+    Logging::Append(ERROR_FILE_EXISTS_ST,
+                    "binodal table: cannot write file " + path);
+    return ERROR_FILE_EXISTS_ST;
+  }
+  return ERROR_SUCCESS_T;
+}
+
+rg_model_id BinodalTable::GetModel() const {
+  return mn_;
+}
+
+const std::vector<double>& BinodalTable::GetTemperatures() const {
+  return t_;
+}
+
+bool BinodalTable::Covers(double acentric) const {
+  if (w_count_ == 1)
+    return acentric == w_min_;
+  return acentric >= w_min_ && acentric <= w_min_ + (w_count_ - 1) * w_step_;
+}
+
+merror_t BinodalTable::Interpolate(size_t t_index,
+                                   double acentric,
+                                   maxwell_point* res) const {
+  if (res == nullptr)
+    return ERROR_INIT_NULLP_ST;
+  if (t_index >= t_.size() || !Covers(acentric))
+    return ERROR_INIT_T;
+  // 4 соседних узла, у краёв сетки - крайние узлы
+  const size_t n = std::min<size_t>(w_count_, 4),
+               size = t_.size() * w_count_;
+  const double s = (w_count_ == 1) ? 0.0 : (acentric - w_min_) / w_step_;
+  const size_t j0 = size_t(std::min<double>(
+      std::max(std::floor(s) - 1.0, 0.0), double(w_count_ - n)));
+  double lnp = 0.0, vl = 0.0, lnvr = 0.0;
+  for (size_t k = 0; k < n; ++k) {
+    double l = 1.0;
+    for (size_t m = 0; m < n; ++m)
+      if (m != k)
+        l *= (s - double(j0 + m)) / double(int(k) - int(m));
+    const size_t idx = t_index * w_count_ + j0 + k;
+    lnp += l * std::log(data_[idx]);
+    vl += l * data_[size + idx];
+    lnvr += l * std::log(data_[2 * size + idx]);
+  }
+  if (!std::isfinite(lnp) || !std::isfinite(vl) || !std::isfinite(lnvr))
+    return ERROR_CALC_PHASE_ST;
+  res->p = std::exp(lnp);
+  res->vLeft = vl;
+  res->vRigth = std::exp(lnvr);
+  res->iterations = 0;
+  return ERROR_SUCCESS_T;
+}
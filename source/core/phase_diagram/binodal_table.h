@@ -0,0 +1,124 @@
+/**
+ * asp_therm - implementation of real gas equations of state
+ *
+ *
+ * Copyright (c) 2020-2021 Mishutinski Yurii
+ *
+ * This library is distributed under the MIT License.
+ * See LICENSE file in the project root for full license information.
+ */
+#ifndef _CORE__PHASE_DIAGRAM__BINODAL_TABLE_H_
+#define _CORE__PHASE_DIAGRAM__BINODAL_TABLE_H_
+
+#include "atherm_common.h"
+#include "phase_diagram.h"
+
+#include <string>
+#include <vector>
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Таблица приведённых бинодалей по закону соответственных состояний.
+ *   Приведённая бинодаль моделей RK2 и PR зависит только от фактора
+ *   ацентричности w(см. initializePR/lineIntegratePR), поэтому её
+ *   можно один раз рассчитать на сетке (t_i, w_j) и для нового газа
+ *   получать интерполяцией по w вместо решения уравнения равенства
+ *   площадей.
+ *
+ * Формат файла - заголовок binodal_table_header(48 байт) и подряд
+ *   массивы double, поэтому файл можно отобразить в память как есть:
+ *   t[t_count], p[t_count * w_count], vLeft[...], vRigth[...],
+ *   значения для температуры t_i и w_j = w_min + j * w_step лежат по
+ *   индексу i * w_count + j, нерассчитанные точки - NaN. Порядок байт
+ *   платформы, файл с другим порядком байт отвергается
+ */
+
+/** \brief Заголовок файла таблицы бинодалей */
+struct binodal_table_header {
+  /// "ATHBINOD"
+  char magic[8];
+  /// версия формата
+  uint32_t version;
+  /// 0x01020304 в порядке байт платформы, записавшей файл
+  uint32_t byte_order;
+  /// rg_model_id модели
+  int32_t model_type;
+  int32_t model_subtype;
+  /// число температур и факторов ацентричности
+  uint32_t t_count;
+  uint32_t w_count;
+  /// сетка факторов ацентричности
+  double w_min;
+  double w_step;
+};
+
+/** \brief Таблица приведённых точек бинодали модели по приведённой
+ *   температуре и фактору ацентричности
+ *
+ * По температуре значения берутся в узлах таблицы, по фактору
+ *   ацентричности - интерполяция многочленом Лагранжа по 4 соседним
+ *   узлам для ln(p), vLeft и ln(vRigth)
+ * */
+class BinodalTable {
+ public:
+  /** \brief Сетка факторов ацентричности по умолчанию */
+  static constexpr double default_w_min = -0.4;
+  static constexpr double default_w_step = 0.02;
+  static constexpr size_t default_w_count = 101;
+
+ public:
+  /**
+   * \brief Рассчитать таблицу для модели mn
+   * \param t_grid Приведённые температуры в (0, 1), порядок сохраняется
+   * \return nullptr если модель не поддерживается PhaseDiagram или
+   *   сетка пуста
+   * */
+  static BinodalTable* Init(rg_model_id mn,
+                            const std::vector<double>& t_grid,
+                            double w_min = default_w_min,
+                            double w_step = default_w_step,
+                            size_t w_count = default_w_count);
+  /**
+   * \brief Загрузить таблицу из файла, записанного Save
+   * \return nullptr если файл не открывается, размер файла не
+   *   соответствует заголовку, сетка или модель заголовка не допустимы
+   * */
+  static BinodalTable* Init(const std::string& path);
+
+  /** \brief Записать таблицу в файл */
+  merror_t Save(const std::string& path) const;
+
+  rg_model_id GetModel() const;
+  /** \brief Приведённые температуры таблицы */
+  const std::vector<double>& GetTemperatures() const;
+  /** \brief Лежит ли w внутри сетки факторов ацентричности */
+  bool Covers(double acentric) const;
+  /**
+   * \brief Точка бинодали для температуры GetTemperatures()[t_index]
+   *   и фактора ацентричности acentric
+   * \return ERROR_SUCCESS_T, ERROR_INIT_T если индекс или acentric вне
+   *   таблицы, ERROR_CALC_PHASE_ST если соседние узлы не рассчитаны
+   * */
+  merror_t Interpolate(size_t t_index,
+                       double acentric,
+                       maxwell_point* res) const;
+
+ private:
+  BinodalTable(rg_model_id mn,
+               const std::vector<double>& t_grid,
+               double w_min,
+               double w_step,
+               size_t w_count);
+
+ private:
+  rg_model_id mn_;
+  std::vector<double> t_;
+  double w_min_, w_step_;
+  size_t w_count_;
+  /// p, vLeft, vRigth подряд, по t_count * w_count значений
+  std::vector<double> data_;
+};
+
+#endif  // !_CORE__PHASE_DIAGRAM__BINODAL_TABLE_H_
@@ -10,11 +10,18 @@
 #include "phase_diagram.h"
 
 #include "asp_utils/Logging.h"
+#include "binodal_table.h"
 #include "gas_description.h"
 #include "models_configurations.h"
 #include "models_math.h"
 
 #include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <future>
+#include <limits>
+#include <numeric>
+#include <thread>
 #include <tuple>
 #include <utility>
 #ifdef _DEBUG
@@ -22,10 +29,39 @@
 #endif
 
 #define FUNCTIONS_INDEX_OUT 0xFF
+/* число точек бинодали на один поток, на меньших участках запуск
+ *   потока дороже расчёта */
+#define BINODAL_TASK_POINTS 64
 
 PhaseDiagram ::uniqueMark::uniqueMark(rg_model_id mn, gas_t gt)
     : mn(mn), gt(gt) {}
 
+/* Корни изотермы P(v, t) = p: уравнение tempvec[0..3], корни v[0] >=
+ *   v[1] >= v[2]. Вблизи давления насыщения при t << 1 коэффициенты
+ *   различаются на много порядков, признак трёх корней по
+ *   дискриминанту ненадёжен и два малых корня могут слиться, поэтому
+ *   по одному найденному корню степень понижается до квадратной */
+static merror_t isotherm_volumes(const std::vector<double>& c,
+                                 double* v,
+                                 int* roots_count) {
+  merror_t error = CubicRealRoots(&c[0], v, roots_count);
+  if (error)
+    return error;
+  // v^2 - s * v + q = 0, s = v1 + v2, q = v1 * v2
+  const double r = v[0], s = -c[1] / c[0] - r, q = -c[3] / (c[0] * r),
+               disc = s * s - 4.0 * q;
+  if (disc < 0.0 || !std::isfinite(q)) {
+    v[2] = v[1] = v[0];
+    *roots_count = 1;
+    return ERROR_SUCCESS_T;
+  }
+  v[1] = 0.5 * (s + std::copysign(std::sqrt(disc), s));
+  v[2] = (v[1] != 0.0) ? q / v[1] : 0.0;
+  std::sort(v, v + 3, std::greater<double>());
+  *roots_count = 3;
+  return ERROR_SUCCESS_T;
+}
+
 size_t PhaseDiagram::set_functions_index(rg_model_id mn) {
   switch (mn.type) {
     case rg_model_t::REDLICH_KWONG:
@@ -40,162 +76,179 @@ size_t PhaseDiagram::set_functions_index(rg_model_id mn) {
 void PhaseDiagram::calculateBinodal(std::shared_ptr<binodalpoints>& bdp,
                                     rg_model_id mn,
                                     double acentric) {
-  const uint32_t nPoints = bdp->t.size();
-  // Суть правила Максвелла: Расчитанные значения va и vb лежат на
-  //   бинодали если
-  //   площадь под кривой изотермы состояния(p=p(v,t)) от va до vb
-  //   равна площади прямоугольника(p=const) от va до vb
-  // См. картинку Vanderwaals2.jpg в этой папке
-  double pi,
-      dpi,          // current pressure and pressure correction
-      spline_area,  // area under function t(p,v) from v0 to v2;
-      rectan_area;  // area under pi=const, from v0 to v2;
-                    // Maxwell construction requirement splineAR==rectanAR;
   size_t functions_index = set_functions_index(mn);
   if (functions_index == FUNCTIONS_INDEX_OUT) {
+    std::unique_lock<std::shared_mutex> lock(mtx_);
     error_.SetError(ERROR_INIT_T, "error in programmer DNA");
     return;
   }
-  auto integrateFun = line_integrate_f_.at(functions_index);
-  auto inializeFun = initialize_f_.at(functions_index);
-  merror_t error = ERROR_SUCCESS_T;
-  // get pressure by volume and temperature
-  for (size_t t_iter = 0; t_iter < nPoints; ++t_iter) {
-    std::vector<double> tempvec = {1.0,
-                                   -9.0 / (4.0 * bdp->t[t_iter]),
-                                   6.0 / (4.0 * bdp->t[t_iter]),
-                                   -1.0 / (4.0 * bdp->t[t_iter]),
-                                   0.0,
-                                   0.0,
-                                   0.0};
-    // calculate derivate(dpressure/dtemperature)=0
-    int roots_count = 0;
-    error = CardanoMethod_roots_count(&tempvec[0], &tempvec[4], &roots_count);
-    bool has_uniq_root = (roots_count == 1) ? true : false;
+  const maxwell_solver_options opts = GetSolverOptions();
+  const size_t size = bdp->t.size(),
+               hw = std::max<size_t>(std::thread::hardware_concurrency(), 1),
+               tasks = std::min(hw, size / BINODAL_TASK_POINTS);
+  if (tasks < 2) {
+    calculateBinodalRange(bdp.get(), functions_index, acentric, opts, 0,
+                          size);
+    return;
+  }
+  // участки пишут в непересекающиеся элементы bdp
+  std::vector<std::future<void>> future_ranges;
+  for (size_t i = 0; i < tasks; ++i)
+    future_ranges.push_back(std::async(
+        std::launch::async, &PhaseDiagram::calculateBinodalRange, this,
+        bdp.get(), functions_index, acentric, opts, size * i / tasks,
+        size * (i + 1) / tasks));
+  for (auto& fr : future_ranges)
+    fr.get();
+}
+
+void PhaseDiagram::calculateBinodalRange(binodalpoints* bdp,
+                                         size_t functions_index,
+                                         double acentric,
+                                         const maxwell_solver_options& opts,
+                                         size_t first,
+                                         size_t last) const {
+  maxwell_point pt;
+  // две последние рассчитанные точки, (1 / t, ln(p))
+  double x1 = 0.0, y1 = 0.0, x2 = 0.0, y2 = 0.0;
+  int known = 0;
+  for (size_t t_iter = first; t_iter < last; ++t_iter) {
+    const double x = 1.0 / bdp->t[t_iter];
+    // ln(p) почти линейна по 1 / t(уравнение Клапейрона-Клаузиуса),
+    //   для одной точки наклон - по оценке Эдмистера
+    double p_guess = 0.0;
+    if (known == 2)
+      p_guess = std::exp(y2 + (y2 - y1) / (x2 - x1) * (x - x2));
+    else if (known == 1)
+      p_guess = std::exp(y2 - 7.0 / 3.0 * std::log(10.0) * (1.0 + acentric)
+                                  * (x - x2));
+    merror_t error = solveMaxwell(functions_index, bdp->t[t_iter], acentric,
+                                  opts, p_guess, &pt);
     if (error) {
       Logging::Append(io_loglvl::debug_logs,
                       "For temperature index: " + std::to_string(t_iter)
-                          + "\nCardano method error(phase_diagram)");
-      bdp->t[t_iter] = -1.0;
-      continue;
-    }
-    if (has_uniq_root) {
+                          + "\nMaxwell construction error(phase_diagram)");
       bdp->t[t_iter] = -1.0;
       continue;
     }
-    std::sort(tempvec.begin() + 4, tempvec.end());
-    assert((tempvec[4] >= 0.0) && (tempvec[5] >= 0.0) && (tempvec[6] >= 0.0));
-    pi = bdp->t[t_iter] * bdp->t[t_iter] * bdp->t[t_iter];
-    if (pi <= 0.0)
-      pi = 0.01;
-    dpi = -pi * 0.002;
-    uint32_t trycount = 0;
-    // DEVELOP
-    //   HORRIBLE
-    // Вот здесь метод не очень. Суть его плохости:
-    //   В не гибком выборе приращения dpi
-    // Method of calculating is horrible:
-    //   choosing of dpi is not flexible
-    // Shame on me
-    while (true) {
-      // Чтобы цикл не сваливался в бесконечный
-      //   если решение не сходится
-      if (trycount > 3000) {
-        bdp->t[t_iter] = -1.0;
-        break;
-      }
-      ++trycount;
-      // Особенность вычислений: вблизи критической точки
-      //   сходимость хуже
-      // descrease dpi for field located nearby to critical point
-      if (t_iter < 4)
-        dpi *= 0.1;
-      pi += dpi;
-      // calculate volume
-      inializeFun(tempvec, pi, bdp->t[t_iter], acentric);
-      int roots_count = 0;
-      error = CardanoMethod_roots_count(&tempvec[0], &tempvec[4], &roots_count);
-      bool has_uniq_root = (roots_count == 1) ? true : false;
-      if (error) {
-        bdp->t[t_iter] = -1.0;
-        break;
-      }
-      if (has_uniq_root) {
-        dpi = 0.002 * pi;
-        pi = (tempvec[4] <= 1.0) ? (pi - 2.0 * dpi) : (pi + 2.0 * dpi);
-        continue;
-      }
-      assert((tempvec[4] >= 0.0) && (tempvec[5] >= 0.0) && (tempvec[6] >= 0.0));
-      std::sort(tempvec.begin() + 4, tempvec.end());
-      if (is_equal(tempvec[4], tempvec[6], 0.0001)) {
-        bdp->t[t_iter] = -1.0;
-        break;
-      }
-      bdp->vLeft[t_iter] = tempvec[4];
-      bdp->vRigth[t_iter] = tempvec[6];
-      // Вычислить площадь и безразмерную разницу
-      rectan_area = (tempvec[6] - tempvec[4]) * pi;
-      spline_area = integrateFun(bdp->t[t_iter], bdp->vLeft[t_iter],
-                                 bdp->vRigth[t_iter], acentric);
-      double ARdiffer = (rectan_area - spline_area) / rectan_area;
-      // Если разница между площадями меньше 0.5%
-      //   считаем ответ верным
-      if (std::abs(ARdiffer) < 0.005) {
-        bdp->p[t_iter] = pi;
-        break;
-        // Если разница больше 0.5% пересчитаем давление
-      } else if (ARdiffer > 0.0) {
-        // DEVELOP
-        //   Может реализовать вычисление производной и через неё пересчитать
-        pi -= 2.0 * dpi;
-      } else {
-        pi += 3.0 * dpi;
-      }
-      dpi = 0.002 * pi;
-    }
+    bdp->p[t_iter] = pt.p;
+    bdp->vLeft[t_iter] = pt.vLeft;
+    bdp->vRigth[t_iter] = pt.vRigth;
+    x1 = x2, y1 = y2;
+    x2 = x, y2 = std::log(pt.p);
+    known = std::min(known + 1, 2);
   }
 }
 
-// erase not calculated points
-void PhaseDiagram::checkResult(std::shared_ptr<binodalpoints>& bdp) {
-  size_t sizebdp = bdp->t.size();
-  for (size_t i = 0; i < sizebdp; ++i) {
-    if (bdp->t[i] < -0.5) {
-      eraseElements(bdp, i);
-      --i;
-      --sizebdp;
+merror_t PhaseDiagram::solveMaxwell(size_t functions_index,
+                                    double t,
+                                    double acentric,
+                                    const maxwell_solver_options& opts,
+                                    double p_guess,
+                                    maxwell_point* res) const {
+  // Суть правила Максвелла: Расчитанные значения va и vb лежат на
+  //   бинодали если
+  //   площадь под кривой изотермы состояния(p=p(v,t)) от va до vb
+  //   равна площади прямоугольника(p=const) от va до vb
+  // См. картинку Vanderwaals2.jpg в этой папке
+  res->iterations = 0;
+  if (!(t > 0.0 && t < 1.0))
+    return ERROR_CALC_PHASE_ST;
+  const integ_func_t& integrateFun = line_integrate_f_[functions_index];
+  const init_func_t& inializeFun = initialize_f_[functions_index];
+  // Решение лежит в интервале (p_lo, p_hi): при p_lo изотерма
+  //   пересекается в одной точке справа от критического объёма
+  //   или площадь под кривой больше площади прямоугольника,
+  //   при p_hi - наоборот. Пока p_hi не найдено, оно бесконечно
+  double p_lo = 0.0, p_hi = std::numeric_limits<double>::infinity(),
+         step_prev = std::numeric_limits<double>::infinity();
+  // оценка Эдмистера: lg(p) = 7/3 * (1 + w) * (1 - 1 / t)
+  double pi = p_guess;
+  if (!(pi > 0.0))
+    pi = std::pow(10.0, 7.0 / 3.0 * (1.0 + acentric) * (1.0 - 1.0 / t));
+  std::vector<double> tempvec(4);
+  double v[3];
+  while (res->iterations < opts.max_iterations) {
+    ++res->iterations;
+    inializeFun(tempvec, pi, t, acentric);
+    int roots_count = 0;
+    if (isotherm_volumes(tempvec, v, &roots_count))
+      return ERROR_CALC_PHASE_ST;
+    double p_next;
+    if (roots_count == 1) {
+      // давление вне петли Ван-дер-Ваальса: над ней остаётся только
+      //   корень жидкости, под ней - корень пара
+      if (v[0] <= 1.0)
+        p_hi = pi;
+      else
+        p_lo = pi;
+      p_next = -1.0;
+    } else {
+      if (is_equal(v[0], v[2], 0.0001))
+        return ERROR_CALC_PHASE_ST;
+      // Вычислить площадь и безразмерную разницу
+      const double width = v[0] - v[2],
+                   spline_area = integrateFun(t, v[2], v[0], acentric),
+                   rectan_area = width * pi,
+                   ARdiffer = (rectan_area - spline_area) / rectan_area;
+      if (ARdiffer > 0.0)
+        p_hi = pi;
+      else
+        p_lo = pi;
+      // вблизи критической точки разность площадей мала по сравнению
+      //   с погрешностью интегрирования, там критерий - ширина интервала
+      if (std::abs(ARdiffer) < opts.tolerance
+          || p_hi - p_lo < opts.tolerance * pi) {
+        res->p = pi;
+        res->vLeft = v[2];
+        res->vRigth = v[0];
+        return ERROR_SUCCESS_T;
+      }
+      // шаг Ньютона: dF/dp = -(vRigth - vLeft)
+      p_next = spline_area / width;
     }
+    // вблизи критической точки погрешность разности площадей
+    //   сравнима с ней самой и шаги Ньютона колеблются у границ
+    //   интервала, не уменьшаясь: тогда интервал делится пополам
+    if (!(p_next > p_lo && p_next < p_hi)
+        || std::abs(p_next - pi) > 0.5 * step_prev)
+      p_next = std::isfinite(p_hi) ? 0.5 * (p_lo + p_hi) : 2.0 * pi;
+    step_prev = std::abs(p_next - pi);
+    pi = p_next;
   }
-  // testing on negative values in vectors
-  searchNegative(bdp, bdp->p);
-  searchNegative(bdp, bdp->vLeft);
-  searchNegative(bdp, bdp->vRigth);
-}
-
-void PhaseDiagram::eraseElements(std::shared_ptr<binodalpoints>& bdp,
-                                 const size_t i) {
-  bdp->t.erase(bdp->t.begin() + i);
-  bdp->p.erase(bdp->p.begin() + i);
-  bdp->vLeft.erase(bdp->vLeft.begin() + i);
-  bdp->vRigth.erase(bdp->vRigth.begin() + i);
+  return ERROR_CALC_PHASE_ST;
 }
 
-void PhaseDiagram::searchNegative(std::shared_ptr<binodalpoints>& bdp,
-                                  std::deque<double>& v) {
-  auto hasnegative = [](std::deque<double>& vec) {
-    return vec.end() - std::find_if(vec.begin(), vec.end(), [](const auto v) {
-             return v < DOUBLE_ACCURACY;
-           });
-  };
-  int hasneg = 1;
-  int vecsize = v.size();
-  while (true) {
-    if ((hasneg = hasnegative(v))) {
-      eraseElements(bdp, vecsize - hasneg);
-      --vecsize;
+void PhaseDiagram::checkResult(binodalpoints* bdp) {
+  // сдвиг оставшихся точек к началу массивов вместо удаления по одной
+  size_t size = 0;
+  for (size_t i = 0; i < bdp->t.size(); ++i) {
+    if (bdp->t[i] < -0.5 || bdp->p[i] < DOUBLE_ACCURACY
+        || bdp->vLeft[i] < DOUBLE_ACCURACY || bdp->vRigth[i] < DOUBLE_ACCURACY)
       continue;
-    }
-    break;
+    bdp->t[size] = bdp->t[i];
+    bdp->p[size] = bdp->p[i];
+    bdp->vLeft[size] = bdp->vLeft[i];
+    bdp->vRigth[size] = bdp->vRigth[i];
+    ++size;
+  }
+  bdp->t.resize(size);
+  bdp->p.resize(size);
+  bdp->vLeft.resize(size);
+  bdp->vRigth.resize(size);
+  // сетки температур PhaseDiagram упорядочены по убыванию, сетка
+  //   таблицы бинодалей - в порядке, заданном при её расчёте
+  if (std::is_sorted(bdp->p.begin(), bdp->p.end(), std::greater<double>()))
+    return;
+  std::vector<size_t> order(size);
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(),
+            [bdp](size_t l, size_t r) { return bdp->p[l] > bdp->p[r]; });
+  for (auto* vec : {&bdp->t, &bdp->p, &bdp->vLeft, &bdp->vRigth}) {
+    std::vector<double> sorted(size);
+    for (size_t i = 0; i < size; ++i)
+      sorted[i] = (*vec)[order[i]];
+    vec->swap(sorted);
   }
 }
 
@@ -210,37 +263,111 @@ PhaseDiagram& PhaseDiagram::GetCalculated() {
   return phd;
 }
 
+std::shared_ptr<binodalpoints> PhaseDiagram::reducedBinodal(
+    std::shared_ptr<binodalpoints> bdp,
+    double acentric,
+    const BinodalTable* table) {
+  if (table) {
+    maxwell_point pt;
+    for (size_t i = 0; i < bdp->t.size(); ++i) {
+      if (table->Interpolate(i, acentric, &pt)) {
+        bdp->t[i] = -1.0;
+        continue;
+      }
+      bdp->p[i] = pt.p;
+      bdp->vLeft[i] = pt.vLeft;
+      bdp->vRigth[i] = pt.vRigth;
+    }
+  } else {
+    calculateBinodal(bdp, bdp->mn, acentric);
+  }
+  checkResult(bdp.get());
+  for (auto* vec : {&bdp->t, &bdp->p, &bdp->vLeft, &bdp->vRigth})
+    vec->insert(vec->begin(), 1.0);
+  return bdp;
+}
+
+binodalpoints* PhaseDiagram::scaledBinodal(const binodalpoints& reduced,
+                                           const const_parameters& cp) {
+  auto f = [](std::vector<double>& vec, double K) {
+    std::transform(vec.begin(), vec.end(), vec.begin(),
+                   [K](const auto e) { return K * e; });
+  };
+  binodalpoints* bp = new binodalpoints(reduced);
+  f(bp->vLeft, cp.critical.volume);
+  f(bp->vRigth, cp.critical.volume);
+  f(bp->p, cp.critical.pressure);
+  f(bp->t, cp.critical.temperature);
+  return bp;
+}
+
 binodalpoints* PhaseDiagram::GetBinodalPoints(const const_parameters& cp,
                                               const rg_model_id& id) {
   binodalpoints* bp = nullptr;
   if (!cp.IsGasmix() && PhaseDiagram::IsValidModel(id)) {
-    auto f = [](std::deque<double>& vec, double K) {
-      std::transform(vec.begin(), vec.end(), vec.begin(),
-                     [K](const auto e) { return K * e; });
-    };
     uniqueMark um(id, cp.gas_name);
-    // если для таких параметров(модель и фактор ацентричности)
-    //   бинодаль ещё не рассчитана -- рассчитать и сохранить
-    std::shared_ptr<binodalpoints> bdp(new binodalpoints(id));
-    calculateBinodal(bdp, id, cp.acentricfactor);
-    checkResult(bdp);
-    bdp->p.push_front(1.0);
-    bdp->t.push_front(1.0);
-    bdp->vLeft.push_front(1.0);
-    bdp->vRigth.push_front(1.0);
-    if (!cp.IsAbstractGas())
-      if (calculated_.find(um) == calculated_.end())
-        calculated_.emplace(um, bdp);
-    bp = new binodalpoints(*bdp);
-    f(bp->vLeft, cp.critical.volume);
-    f(bp->vRigth, cp.critical.volume);
-    f(bp->p, cp.critical.pressure);
-    f(bp->t, cp.critical.temperature);
+    std::shared_ptr<binodalpoints> bdp;
+    std::shared_ptr<const BinodalTable> table;
+    uint64_t generation = 0;
+    {
+      std::shared_lock<std::shared_mutex> lock(mtx_);
+      generation = generation_;
+      auto it = calculated_.find(um);
+      if (!cp.IsAbstractGas() && it != calculated_.end())
+        bdp = it->second;
+      for (const auto& tb : tables_)
+        if (tb->GetModel() == id && tb->Covers(cp.acentricfactor))
+          table = tb;
+    }
+    if (bdp) {
+      ++cache_hits_;
+    } else {
+      // если для таких параметров(модель и газ) бинодаль ещё
+      //   не рассчитана -- рассчитать и сохранить. Если другой поток
+      //   успел сохранить ту же бинодаль, emplace оставит её. Если
+      //   за время расчёта кэш очищен(новые options_ или tables_),
+      //   результат возвращается, но не сохраняется
+      ++cache_misses_;
+      // по таблице соответственных состояний, если она задана
+      bdp.reset(table ? new binodalpoints(id, table->GetTemperatures())
+                      : new binodalpoints(id));
+      bdp = reducedBinodal(bdp, cp.acentricfactor, table.get());
+      if (!cp.IsAbstractGas()) {
+        std::unique_lock<std::shared_mutex> lock(mtx_);
+        if (generation == generation_)
+          calculated_.emplace(um, bdp);
+      }
+    }
+    bp = scaledBinodal(*bdp, cp);
     bp->mn = um.mn;
   }
   return bp;
 }
 
+binodalpoints* PhaseDiagram::GetBinodalPoints(const const_parameters& cp,
+                                              const rg_model_id& id,
+                                              std::vector<double> t_grid) {
+  if (cp.IsGasmix() || !PhaseDiagram::IsValidModel(id))
+    return nullptr;
+  t_grid.erase(std::remove_if(t_grid.begin(), t_grid.end(),
+                              [](double t) { return !(t > 0.0 && t < 1.0); }),
+               t_grid.end());
+  std::sort(t_grid.begin(), t_grid.end(), std::greater<double>());
+  t_grid.erase(std::unique(t_grid.begin(), t_grid.end()), t_grid.end());
+  std::shared_ptr<binodalpoints> bdp(new binodalpoints(id, t_grid));
+  return scaledBinodal(*reducedBinodal(bdp, cp.acentricfactor), cp);
+}
+
+std::vector<double> PhaseDiagram::ClusteredTemperatureGrid(size_t count,
+                                                           double t_min) {
+  std::vector<double> t_grid(count);
+  for (size_t i = 0; i < count; ++i) {
+    const double s = double(i + 1) / count;
+    t_grid[i] = 1.0 - (1.0 - t_min) * s * s;
+  }
+  return t_grid;
+}
+
 binodalpoints* PhaseDiagram::GetBinodalPoints(parameters_mix& components,
                                               const rg_model_id& id) {
   // 25.01.2019
@@ -254,7 +381,98 @@ binodalpoints* PhaseDiagram::GetBinodalPoints(parameters_mix& components,
   return PhaseDiagram::GetBinodalPoints(max_el->second.first, id);
 }
 
+merror_t PhaseDiagram::CalculateBinodalPoint(rg_model_id mn,
+                                             double t,
+                                             double acentric,
+                                             maxwell_point* res) const {
+  if (res == nullptr)
+    return ERROR_INIT_NULLP_ST;
+  size_t functions_index = set_functions_index(mn);
+  if (functions_index == FUNCTIONS_INDEX_OUT)
+    return ERROR_INIT_T;
+  return solveMaxwell(functions_index, t, acentric, GetSolverOptions(), 0.0,
+                      res);
+}
+
+maxwell_solver_options PhaseDiagram::GetSolverOptions() const {
+  std::shared_lock<std::shared_mutex> lock(mtx_);
+  return options_;
+}
+
+void PhaseDiagram::SetSolverOptions(const maxwell_solver_options& opts) {
+  std::unique_lock<std::shared_mutex> lock(mtx_);
+  options_ = opts;
+  calculated_.clear();
+  ++generation_;
+}
+
+void PhaseDiagram::SetBinodalTable(std::shared_ptr<const BinodalTable> table) {
+  if (!table)
+    return;
+  std::unique_lock<std::shared_mutex> lock(mtx_);
+  auto it = std::find_if(tables_.begin(), tables_.end(), [&table](
+      const auto& tb) { return tb->GetModel() == table->GetModel(); });
+  if (it != tables_.end())
+    *it = table;
+  else
+    tables_.push_back(table);
+  calculated_.clear();
+  ++generation_;
+}
+
+void PhaseDiagram::ClearBinodalTables() {
+  std::unique_lock<std::shared_mutex> lock(mtx_);
+  tables_.clear();
+  calculated_.clear();
+  ++generation_;
+}
+
+merror_t PhaseDiagram::UseBinodalTable(rg_model_id mn,
+                                       const std::string& path) {
+  if (!IsValidModel(mn))
+    return ERROR_INIT_T;
+  std::shared_ptr<const BinodalTable> table;
+  if (std::ifstream(path).good()) {
+    // файл пользователя не перезаписывается
+    table.reset(BinodalTable::Init(path));
+    if (!table)
+      return ERROR_FILE_IN_ST;
+    if (!(table->GetModel() == mn)) {
+      Logging::Append(ERROR_INIT_T,
+                      "binodal table: file " + path
+                          + " contains table of other model");
+      return ERROR_INIT_T;
+    }
+  } else {
+    // таблицы нет: рассчитать на сетке температур по умолчанию и
+    //   сохранить
+    const binodalpoints defaults(mn);
+    table.reset(BinodalTable::Init(mn, defaults.t));
+    if (!table)
+      return ERROR_INIT_T;
+    merror_t error = table->Save(path);
+    if (error)
+      return error;
+  }
+  SetBinodalTable(table);
+  return ERROR_SUCCESS_T;
+}
+
+binodal_cache_stats PhaseDiagram::GetCacheStats() const {
+  std::shared_lock<std::shared_mutex> lock(mtx_);
+  return {cache_hits_.load(), cache_misses_.load(), calculated_.size()};
+}
+
+void PhaseDiagram::ClearCache() {
+  std::unique_lock<std::shared_mutex> lock(mtx_);
+  calculated_.clear();
+  ++generation_;
+  cache_hits_ = 0;
+  cache_misses_ = 0;
+}
+
 merror_t PhaseDiagram::GetError() const {
+  std::shared_lock<std::shared_mutex> lock(mtx_);
   return error_.GetErrorCode();
 }
 
@@ -266,3 +484,19 @@ bool operator<(const PhaseDiagram::uniqueMark& lum,
 
 binodalpoints::binodalpoints(rg_model_id mn)
     : mn(mn), vLeft(t.size(), 0.0), vRigth(t.size(), 0.0), p(t.size(), 0.0) {}
+
+binodalpoints::binodalpoints(rg_model_id mn, const std::vector<double>& t_grid)
+    : mn(mn),
+      t(t_grid),
+      vLeft(t.size(), 0.0),
+      vRigth(t.size(), 0.0),
+      p(t.size(), 0.0) {}
+
+size_t binodalpoints::PressureIndex(double p) const {
+  if (this->p.empty())
+    return 0;
+  // давление убывает: первый элемент, для которого p > p[k]
+  return std::upper_bound(this->p.begin() + 1, this->p.end(), p,
+                          std::greater<double>())
+         - this->p.begin();
+}
@@ -15,13 +15,15 @@
 #include "gas_description_mix.h"
 #include "phase_diagram_models.h"
 
+#include <atomic>
 #include <cassert>
-#include <deque>
 #include <exception>
 #include <functional>
 #include <map>
 #include <memory>
 #include <mutex>
+#include <shared_mutex>
+#include <string>
 #include <vector>
 
 #include <stdint.h>
@@ -31,25 +33,78 @@
  *   За физическое обоснование принято правило Максвелла
  *   (см. ссылку на wiki ниже).
  *
- * DEVELOP Метод расчёта параметров очень ленивый и уродский.
- *   Возможно стоит того же Ньютона намотатьвместо этого ужаса
- *   (комментарий HORRIBLE)
+ * Давление насыщения p изотермы находится из равенства площадей
+ *   F(p) = ∫ P(v, t) dv - p * (vRigth - vLeft) = 0, vLeft, vRigth -
+ *   крайние корни кубического уравнения P(v, t) = p. Так как
+ *   P(vLeft) = P(vRigth) = p, dF/dp = -(vRigth - vLeft) и шаг Ньютона
+ *   p = ∫ P(v, t) dv / (vRigth - vLeft) - среднее давление изотермы
+ *   на отрезке. Шаг ограничен интервалом, в котором лежит решение,
+ *   при выходе из него интервал делится пополам
  */
 
+class BinodalTable;
 class PhaseDiagram;
+/** \brief Точки бинодали
+ *
+ * Значения хранятся отдельными непрерывными массивами одной длины,
+ *   упорядоченными по убыванию давления(и температуры), первая точка -
+ *   критическая. Поэтому точку по давлению можно найти двоичным
+ *   поиском, см. PressureIndex
+ * */
 class binodalpoints {
   friend class PhaseDiagram;
   binodalpoints(rg_model_id mn);
+  binodalpoints(rg_model_id mn, const std::vector<double>& t_grid);
+
+ public:
+  /**
+   * \brief Индекс k >= 1 первой точки с давлением меньше p:
+   *   p[k - 1] >= p > p[k], или p.size(), если такой точки нет.
+   *   Двоичный поиск, O(log n)
+   * */
+  size_t PressureIndex(double p) const;
 
  public:
   rg_model_id mn;
   // вектор значений безразмерной температуры по которым будут вычисляться
   //   параметры объёма и давления
   //   BASIC STRUCT
-  std::deque<double> t = std::deque<double>{0.97, 0.95, 0.92, 0.9, 0.87, 0.85,
-                                            0.8,  0.75, 0.7,  0.6, 0.5},
-                     vLeft, vRigth, p;
-  std::deque<double> hLeft, hRigth;
+  std::vector<double> t = std::vector<double>{0.97, 0.95, 0.92, 0.9, 0.87,
+                                              0.85, 0.8,  0.75, 0.7,  0.6,
+                                              0.5},
+                      vLeft, vRigth, p;
+  std::vector<double> hLeft, hRigth;
+};
+
+/** \brief Параметры расчёта точек бинодали по правилу Максвелла */
+struct maxwell_solver_options {
+  /// допустимая относительная разница площадей
+  ///   |p * (vRigth - vLeft) - ∫ P dv| / (p * (vRigth - vLeft))
+  double tolerance = 1.0e-9;
+  /// максимальное число решений кубического уравнения на точку
+  uint32_t max_iterations = 100;
+};
+
+/** \brief Точка бинодали в приведённых параметрах */
+struct maxwell_point {
+  /// давление насыщения
+  double p = 0.0;
+  /// объём жидкости
+  double vLeft = 0.0;
+  /// объём пара
+  double vRigth = 0.0;
+  /// число решений кубического уравнения
+  uint32_t iterations = 0;
+};
+
+/** \brief Счётчики обращений к кэшу рассчитанных бинодалей */
+struct binodal_cache_stats {
+  /// число запросов, для которых бинодаль взята из кэша
+  uint64_t hits;
+  /// число запросов, для которых бинодаль рассчитана
+  uint64_t misses;
+  /// число бинодалей в кэше
+  size_t size;
 };
 
 /** \brief Класс вычисляющий параметры(координаты) точек бинодали
@@ -89,13 +144,24 @@ class PhaseDiagram {
   typedef std::function<void(std::vector<double>&, double, double, double)>
       init_func_t;
 
-  // Мьютекс здесь не нужен, ввиду отсутствия каких либо потоков(нитей),
-  //   для многопоточности придётся вводить как минимум ООП исключения
-  // std::mutex mtx;
+  // Модели создаются из нескольких потоков(CalculationSetup), поэтому
+  //   calculated_ и error_ защищены блокировкой чтения-записи: поиск
+  //   в кэше - разделяемая блокировка, добавление - исключительная.
+  //   Сам расчёт бинодали выполняется без блокировки
+  mutable std::shared_mutex mtx_;
   ErrorWrap error_;
 
-  /* calculated points storage */
+  /* calculated points storage, безразмерные(приведённые) значения */
   std::map<uniqueMark, std::shared_ptr<binodalpoints>> calculated_;
+  std::atomic<uint64_t> cache_hits_{0};
+  std::atomic<uint64_t> cache_misses_{0};
+  /* номер поколения calculated_, увеличивается при каждой очистке
+   *   кэша; бинодаль, рассчитанная по устаревшим options_ или tables_,
+   *   в кэш не добавляется */
+  uint64_t generation_ = 0;
+  maxwell_solver_options options_;
+  /* таблицы бинодалей по закону соответственных состояний */
+  std::vector<std::shared_ptr<const BinodalTable>> tables_;
 
   /* storage of function pointers() */
   std::vector<rg_model_id> functions_indexes_ = std::vector<rg_model_id>{
@@ -115,13 +181,42 @@ class PhaseDiagram {
 
   static size_t set_functions_index(rg_model_id mn);
 
+  /** \brief Рассчитать точки бинодали, независимые температуры
+   *   считаются параллельно участками по BINODAL_TASK_POINTS точек */
   void calculateBinodal(std::shared_ptr<binodalpoints>& bdp,
                         rg_model_id mn,
                         double acentric);
-  void checkResult(std::shared_ptr<binodalpoints>& bdp);
-  void eraseElements(std::shared_ptr<binodalpoints>& bdp, const size_t i);
-  void searchNegative(std::shared_ptr<binodalpoints>& bdp,
-                      std::deque<double>& v);
+  /** \brief Рассчитать точки [first, last) последовательно, начальное
+   *   приближение давления - экстраполяция по предыдущим точкам */
+  void calculateBinodalRange(binodalpoints* bdp,
+                             size_t functions_index,
+                             double acentric,
+                             const maxwell_solver_options& opts,
+                             size_t first,
+                             size_t last) const;
+  /** \brief Рассчитать приведённую бинодаль(или интерполировать по
+   *   таблице table, если она задана) и добавить критическую точку */
+  std::shared_ptr<binodalpoints> reducedBinodal(
+      std::shared_ptr<binodalpoints> bdp,
+      double acentric,
+      const BinodalTable* table = nullptr);
+  /** \brief Копия приведённой бинодали в размерных параметрах cp */
+  static binodalpoints* scaledBinodal(const binodalpoints& reduced,
+                                      const const_parameters& cp);
+  /** \brief Решить уравнение равенства площадей для приведённой
+   *   температуры t < 1
+   * \param p_guess Начальное приближение давления, 0 - оценка по
+   *   уравнению Эдмистера */
+  merror_t solveMaxwell(size_t functions_index,
+                        double t,
+                        double acentric,
+                        const maxwell_solver_options& opts,
+                        double p_guess,
+                        maxwell_point* res) const;
+  /** \brief Удалить нерассчитанные точки(t < 0) и точки с
+   *   неположительными значениями за один проход и упорядочить
+   *   оставшиеся по убыванию давления */
+  static void checkResult(binodalpoints* bdp);
 
  public:
   static bool IsValidModel(rg_model_id mn);
@@ -133,7 +228,65 @@ class PhaseDiagram {
    *   не связана с вычислением бинодали */
   binodalpoints* GetBinodalPoints(const const_parameters& cp,
                                   const rg_model_id& id);
+  /**
+   * \brief Рассчитать точки бинодали на сетке приведённых температур
+   *   t_grid, значения вне интервала (0, 1) отбрасываются.
+   *   Результат не кэшируется
+   * \return Точки в порядке убывания температуры, первая -
+   *   критическая, или nullptr для неподдерживаемой модели или смеси
+   * */
+  binodalpoints* GetBinodalPoints(const const_parameters& cp,
+                                  const rg_model_id& id,
+                                  std::vector<double> t_grid);
+  /**
+   * \brief Сетка из count приведённых температур от t_min до
+   *   критической точки(не включая её), сгущающаяся к критической
+   *   точке: t_i = 1 - (1 - t_min) * ((i + 1) / count)^2
+   * */
+  static std::vector<double> ClusteredTemperatureGrid(size_t count,
+                                                      double t_min);
+  /**
+   * \brief Рассчитать точку бинодали для приведённой температуры t
+   * \param acentric Фактор ацентричности(используется моделью PR)
+   * \return ERROR_SUCCESS_T, ERROR_INIT_T для неподдерживаемой модели
+   *   или ERROR_CALC_PHASE_ST если изотерма не имеет петли
+   *   Ван-дер-Ваальса или точность не достигнута за
+   *   max_iterations итераций
+   * */
+  merror_t CalculateBinodalPoint(rg_model_id mn,
+                                 double t,
+                                 double acentric,
+                                 maxwell_point* res) const;
+  /** \brief Параметры расчёта точек бинодали */
+  maxwell_solver_options GetSolverOptions() const;
+  /** \brief Установить параметры расчёта точек бинодали,
+   *   кэш бинодалей очищается */
+  void SetSolverOptions(const maxwell_solver_options& opts);
+  /**
+   * \brief Использовать таблицу бинодалей для модели table->GetModel():
+   *   при промахе кэша бинодаль газа с фактором ацентричности внутри
+   *   таблицы интерполируется по ней на температурах таблицы.
+   *   Кэш бинодалей очищается
+   * */
+  void SetBinodalTable(std::shared_ptr<const BinodalTable> table);
+  /** \brief Не использовать таблицы бинодалей, кэш очищается */
+  void ClearBinodalTables();
+  /**
+   * \brief Загрузить таблицу бинодалей модели mn из файла path, если
+   *   файла нет - рассчитать её на сетке температур по умолчанию и
+   *   сохранить, см. SetBinodalTable
+   * \return ERROR_FILE_IN_ST если файл повреждён, ERROR_INIT_T если
+   *   таблица файла рассчитана для другой модели, существующий файл
+   *   не перезаписывается
+   * */
+  merror_t UseBinodalTable(rg_model_id mn, const std::string& path);
+  /** \brief Счётчики обращений к кэшу бинодалей */
+  binodal_cache_stats GetCacheStats() const;
+  /** \brief Очистить кэш бинодалей и обнулить счётчики */
+  void ClearCache();
   // for gas_mix
+  //   берётся бинодаль преобладающего(> 0.95) компонента, расчёт
+  //   фазового равновесия смеси - см. PhaseEquilibrium
   binodalpoints* GetBinodalPoints(parameters_mix& components,
                                   const rg_model_id& id);
 
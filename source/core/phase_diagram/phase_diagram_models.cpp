@@ -33,20 +33,22 @@ void initializeRK2::operator() (std::vector<double> &tempvec,
 
 double lineIntegratePR::operator() (
     double t, double vLeft, double vRigth, double ac) {
+  // b = 0.25307, b * (1 + sqrt(2)) = 0.61097, b * (sqrt(2) - 1) = 0.10483
   const double J = 3.253,
       alf = std::pow((1.0 + (0.37464 + 1.54226 * ac - 0.26992 * ac * ac) *
           (1.0 - std::sqrt(t))), 2.0);
-  return t*J*(std::log(std::abs(vRigth-0.25))-std::log(std::abs(vLeft-0.25))) +
-      6.8448*alf*(std::log(std::abs((vRigth+0.60355)/(vRigth-0.10355))) -
-      std::log(std::abs((vLeft+0.60355)/(vLeft-0.10355))));
+  return t*J*(std::log(std::abs(vRigth-0.25307)) -
+      std::log(std::abs(vLeft-0.25307))) +
+      6.75961*alf*(std::log(std::abs((vRigth+0.61097)/(vRigth-0.10483))) -
+      std::log(std::abs((vLeft+0.61097)/(vLeft-0.10483))));
 }
 
 void initializePR::operator() (std::vector<double> &tempvec,
     double pi, double t, double ac) {
   const double alf = std::pow((1.0 + (0.37464 + 1.54226 * ac -
-      0.26992 * ac * ac) * (1.0 - t)), 2.0);
+      0.26992 * ac * ac) * (1.0 - std::sqrt(t))), 2.0);
   tempvec[0] = 1.0;
   tempvec[1] = 0.25307 - 3.253 * t / pi;
   tempvec[2] = -0.192112 -1.646476 * t / pi + 4.838465 * alf / pi;
-  tempvec[3] = -0.01625 + 0.20833 * t / pi - 1.224472 * alf / pi;
+  tempvec[3] = 0.016208 + 0.20833 * t / pi - 1.224472 * alf / pi;
 }
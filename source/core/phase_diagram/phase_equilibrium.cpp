@@ -0,0 +1,483 @@
+/**
+ * asp_therm - implementation of real gas equations of state
+ *
+ *
+ * Copyright (c) 2020-2021 Mishutinski Yurii
+ *
+ * This library is distributed under the MIT License.
+ * See LICENSE file in the project root for full license information.
+ */
+#include "phase_equilibrium.h"
+
+#include "asp_utils/Logging.h"
+#include "model_peng_robinson.h"
+#include "model_redlich_kwong_soave.h"
+#include "models_math.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+/* сумма квадратов невязок ln(f_L / f_V) при сходимости расчёта
+ *   равновесия */
+#define FLASH_TOLERANCE 1.0e-20
+/* то же для проверки устойчивости */
+#define STABILITY_TOLERANCE 1.0e-12
+/* сумма квадратов ln(K_i), при которой решение считается тривиальным */
+#define TRIVIAL_TOLERANCE 1.0e-4
+/* фаза неустойчива при tm < -STABILITY_TM_MIN */
+#define STABILITY_TM_MIN 1.0e-8
+/* период ускорения метода последовательных подстановок */
+#define GDEM_PERIOD 5
+/* граница v / b между жидкоподобной и газоподобной фазами */
+#define LIQUID_VOLUME_RATIO 1.75
+
+/** \brief Начальное приближение констант равновесия по Уилсону */
+static double wilson_ln_k(double p, double t, double pc, double tc, double w) {
+  return std::log(pc / p) + 5.373 * (1.0 + w) * (1.0 - tc / t);
+}
+
+/** \brief Ускорение по доминирующему собственному значению λ
+ *   итерационного процесса x_k+1 = x_k + g_k:
+ *     x += g * λ / (1 - λ), λ = (g, g_prev) / (g_prev, g_prev) */
+static void gdem_step(size_t n,
+                      const double* g,
+                      const double* g_prev,
+                      double* x) {
+  double gg = 0.0, gp = 0.0;
+  for (size_t i = 0; i < n; ++i) {
+    gg += g[i] * g_prev[i];
+    gp += g_prev[i] * g_prev[i];
+  }
+  if (!(gp > 0.0))
+    return;
+  const double l = gg / gp;
+  if (l > 0.0 && l < 1.0) {
+    const double c = l / (1.0 - l);
+    for (size_t i = 0; i < n; ++i)
+      x[i] += c * g[i];
+  }
+}
+
+PhaseEquilibrium::PhaseEquilibrium(rg_model_id mn,
+                                   const parameters_mix& components) {
+  double omega_a, omega_b;
+  double (*binary_coef)(gas_t, gas_t);
+  const bool is_pr = mn.type == rg_model_t::PENG_ROBINSON;
+  if (is_pr) {
+    delta1_ = peng_robinson_traits::delta1;
+    delta2_ = peng_robinson_traits::delta2;
+    omega_a = 0.45724;
+    omega_b = 0.0778;
+    binary_coef = Peng_Robinson::GetBinaryCoef;
+  } else {
+    delta1_ = redlich_kwong_traits::delta1;
+    delta2_ = redlich_kwong_traits::delta2;
+    omega_a = 0.42747;
+    omega_b = 0.08664;
+    binary_coef = Redlich_Kwong_Soave::GetBinaryCoef;
+  }
+  double sum = 0.0;
+  std::vector<gas_t> names;
+  for (const auto& x : components) {
+    const const_parameters& cp = x.second.first;
+    const double tc = cp.critical.temperature, pc = cp.critical.pressure,
+                 w = cp.acentricfactor;
+    z_.push_back(x.first);
+    sum += x.first;
+    tc_.push_back(tc);
+    pc_.push_back(pc);
+    af_.push_back(w);
+    sqrt_ac_.push_back(std::sqrt(omega_a * tc * tc / pc));
+    bc_.push_back(omega_b * tc / pc);
+    /* m(w) как в моделях Peng_Robinson и Redlich_Kwong_Soave */
+    const double m = is_pr ? 0.37464 + 1.54226 * w - 0.26992 * w * w
+                           : 0.480 + 1.574 * w - 0.176 * w * w;
+    alpha_.push_back({m, tc});
+    names.push_back(cp.gas_name);
+  }
+  for (auto& x : z_)
+    x /= sum;
+  const size_t n = z_.size();
+  m_.assign(n * n, 1.0);
+  for (size_t i = 0; i < n; ++i) {
+    for (size_t j = i + 1; j < n; ++j) {
+      const double k = binary_coef(names[i], names[j]);
+      m_[i * n + j] = 1.0 - k;
+      m_[j * n + i] = 1.0 - k;
+    }
+  }
+  b_.assign(n, 0.0);
+  a_.assign(n * n, 0.0);
+  for (auto* v : {&psi_, &w_, &ln_phi_, &ln_phi_l_, &ln_phi_v_, &d_, &g_,
+                  &g_prev_, &ln_wv_, &ln_wl_, &ln_k_, &warm_ln_k_})
+    v->assign(n, 0.0);
+}
+
+PhaseEquilibrium* PhaseEquilibrium::Init(rg_model_id mn,
+                                         const parameters_mix& components) {
+  const bool is_cubic =
+      mn.type == rg_model_t::PENG_ROBINSON ||
+      (mn.type == rg_model_t::REDLICH_KWONG &&
+       mn.subtype == MODEL_RK_SUBTYPE_SOAVE);
+  double sum = 0.0;
+  for (const auto& x : components) {
+    if (!(x.first >= 0.0)) {
+      sum = 0.0;
+      break;
+    }
+    sum += x.first;
+  }
+  if (!is_cubic || !is_above0(sum)) {
+    Logging::Append(ERROR_INIT_T,
+                    "phase equilibrium: model must be Peng-Robinson or "
+                    "Soave-Redlich-Kwong, gas mix fractions must be "
+                    "non-negative and non-zero in total");
+    return nullptr;
+  }
+  return new PhaseEquilibrium(mn, components);
+}
+
+size_t PhaseEquilibrium::Size() const {
+  return z_.size();
+}
+
+const std::vector<double>& PhaseEquilibrium::GetComposition() const {
+  return z_;
+}
+
+merror_t PhaseEquilibrium::LnFugacityCoefs(double p,
+                                           double t,
+                                           const double* x,
+                                           double* ln_phi_out,
+                                           double* z) {
+  if (x == nullptr || ln_phi_out == nullptr)
+    return ERROR_INIT_NULLP_ST;
+  if (!is_above0(p, t)) {
+    error_.SetError(ERROR_PAIR_DEFAULT(ERROR_CALC_PHASE_ST));
+    return ERROR_CALC_PHASE_ST;
+  }
+  set_state(p, t);
+  const double zf = ln_phi(x, ln_phi_out);
+  if (z)
+    *z = zf;
+  return ERROR_SUCCESS_T;
+}
+
+merror_t PhaseEquilibrium::StabilityTest(double p,
+                                         double t,
+                                         const double* z,
+                                         bool* stable,
+                                         double* tm) {
+  if (z == nullptr || stable == nullptr)
+    return ERROR_INIT_NULLP_ST;
+  if (!is_above0(p, t)) {
+    error_.SetError(ERROR_PAIR_DEFAULT(ERROR_CALC_PHASE_ST));
+    return ERROR_CALC_PHASE_ST;
+  }
+  set_state(p, t);
+  for (size_t i = 0; i < z_.size(); ++i)
+    ln_k_[i] = wilson_ln_k(p, t, pc_[i], tc_[i], af_[i]);
+  double tm_min;
+  *stable = stability(z, ln_k_.data(), &tm_min);
+  if (tm)
+    *tm = tm_min;
+  return ERROR_SUCCESS_T;
+}
+
+merror_t PhaseEquilibrium::Flash(double p, double t, flash_result* res) {
+  return Flash(p, t, z_.data(), res);
+}
+
+merror_t PhaseEquilibrium::Flash(double p,
+                                 double t,
+                                 const double* z,
+                                 flash_result* res) {
+  if (z == nullptr || res == nullptr)
+    return ERROR_INIT_NULLP_ST;
+  if (!is_above0(p, t)) {
+    error_.SetError(ERROR_PAIR_DEFAULT(ERROR_CALC_PHASE_ST));
+    return ERROR_CALC_PHASE_ST;
+  }
+  set_state(p, t);
+  const size_t n = z_.size();
+  res->x.resize(n);
+  res->y.resize(n);
+  res->k.resize(n);
+  res->iterations = 0;
+  int phases = 0;
+  if (warm_valid_) {
+    ln_k_ = warm_ln_k_;
+    phases = successive_substitution(z, ln_k_.data(), res);
+  }
+  if (phases != 2) {
+    /* начальное приближение отсутствует или привело к однофазному
+     *   решению - проверить устойчивость исходной фазы */
+    for (size_t i = 0; i < n; ++i)
+      ln_k_[i] = wilson_ln_k(p, t, pc_[i], tc_[i], af_[i]);
+    double tm;
+    phases = stability(z, ln_k_.data(), &tm)
+                 ? 1
+                 : successive_substitution(z, ln_k_.data(), res);
+  }
+  if (phases == 2) {
+    warm_ln_k_ = ln_k_;
+    warm_valid_ = true;
+    return ERROR_SUCCESS_T;
+  }
+  warm_valid_ = false;
+  set_single_phase(z, res);
+  if (phases == 0) {
+    error_.SetError(ERROR_PAIR_DEFAULT(ERROR_CALC_PHASE_ST));
+    return ERROR_CALC_PHASE_ST;
+  }
+  return ERROR_SUCCESS_T;
+}
+
+void PhaseEquilibrium::ResetWarmStart() {
+  warm_valid_ = false;
+}
+
+merror_t PhaseEquilibrium::GetError() const {
+  return error_.GetErrorCode();
+}
+
+void PhaseEquilibrium::set_state(double p, double t) {
+  if (p == p_ && t == t_)
+    return;
+  p_ = p;
+  t_ = t;
+  const size_t n = z_.size();
+  const double sp = std::sqrt(p) / t;
+  /* w_ - sqrt(A_i) */
+  for (size_t i = 0; i < n; ++i) {
+    w_[i] = sqrt_ac_[i] * alpha_[i].Sqrt(t) * sp;
+    b_[i] = bc_[i] * p / t;
+  }
+  for (size_t i = 0; i < n; ++i)
+    for (size_t j = 0; j < n; ++j)
+      a_[i * n + j] = m_[i * n + j] * w_[i] * w_[j];
+}
+
+/*
+ * С A = sum_ij x_i * x_j * A_ij, B = sum_i x_i * B_i,
+ *   psi_i = sum_j A_ij * x_j и
+ *   L = ln((Z + δ1*B) / (Z + δ2*B)) / (δ1 - δ2):
+ *   ln(phi_i) = B_i / B * (Z - 1) - ln(Z - B)
+ *               - A / B * (2 * psi_i / A - B_i / B) * L
+ */
+double PhaseEquilibrium::ln_phi(const double* x, double* ln_phi_out) {
+  const size_t n = z_.size();
+  double A = 0.0, B = 0.0;
+  for (size_t i = 0; i < n; ++i) {
+    const double* ai = &a_[i * n];
+    double psi = 0.0;
+    for (size_t j = 0; j < n; ++j)
+      psi += ai[j] * x[j];
+    psi_[i] = psi;
+    A += x[i] * psi;
+    B += x[i] * b_[i];
+  }
+  const double u = delta1_ + delta2_, w = delta1_ * delta2_,
+               dd = delta1_ - delta2_;
+  const double coef[4] = {1.0, (u - 1.0) * B - 1.0,
+                          A + w * B * B - u * B * (B + 1.0),
+                          -(A * B + w * B * B * (B + 1.0))};
+  double roots[3];
+  int roots_count;
+  CubicRealRoots(coef, roots, &roots_count);
+  /* приведённая энергия Гиббса фазы для корня Z */
+  auto g = [A, B, dd, this](double Z) {
+    return Z - 1.0 - std::log(Z - B)
+           - A / (dd * B)
+                 * std::log((Z + delta1_ * B) / (Z + delta2_ * B));
+  };
+  double Z = roots[0];
+  if (roots_count == 3 && roots[2] > B && g(roots[2]) < g(Z))
+    Z = roots[2];
+  const double c = A / (dd * B),
+               L = std::log((Z + delta1_ * B) / (Z + delta2_ * B)),
+               lzb = std::log(Z - B);
+  for (size_t i = 0; i < n; ++i) {
+    const double bi = b_[i] / B;
+    ln_phi_out[i] = bi * (Z - 1.0) - lzb - c * (2.0 * psi_[i] / A - bi) * L;
+  }
+  return Z;
+}
+
+/*
+ * Для пробной фазы W: ln(W_i) = d_i - ln(phi_i(w)), w = W / sum(W),
+ *   d_i = ln(z_i) + ln(phi_i(z)). В неподвижной точке
+ *   tm = 1 - sum(W), фаза неустойчива если tm < 0
+ */
+bool PhaseEquilibrium::stability(const double* z, double* ln_k, double* tm) {
+  const size_t n = z_.size();
+  ln_phi(z, d_.data());
+  for (size_t i = 0; i < n; ++i)
+    d_[i] += std::log(std::max(z[i], 1.0e-300));
+  double tm_min = 0.0;
+  bool unstable[2] = {false, false};
+  for (int trial = 0; trial < 2; ++trial) {
+    /* 0 - газоподобная пробная фаза W = z * K, 1 - жидкоподобная */
+    double* lw = (trial == 0) ? ln_wv_.data() : ln_wl_.data();
+    for (size_t i = 0; i < n; ++i)
+      lw[i] = std::log(std::max(z[i], 1.0e-300))
+              + ((trial == 0) ? ln_k[i] : -ln_k[i]);
+    double tm_trial = 0.0;
+    bool trivial = false;
+    for (int it = 0; it < max_iterations; ++it) {
+      double sum_w = 0.0;
+      for (size_t i = 0; i < n; ++i) {
+        w_[i] = std::exp(lw[i]);
+        sum_w += w_[i];
+      }
+      for (size_t i = 0; i < n; ++i)
+        w_[i] /= sum_w;
+      ln_phi(w_.data(), ln_phi_.data());
+      /* tm = 1 + sum W_i * (ln W_i + ln phi_i(w) - d_i - 1) */
+      double gn = 0.0, dz = 0.0;
+      tm_trial = 1.0 - sum_w;
+      for (size_t i = 0; i < n; ++i) {
+        g_[i] = d_[i] - ln_phi_[i] - lw[i];
+        tm_trial -= sum_w * w_[i] * g_[i];
+        lw[i] += g_[i];
+        gn += g_[i] * g_[i];
+        const double dzi = std::log(std::max(w_[i], 1.0e-300))
+                           - std::log(std::max(z[i], 1.0e-300));
+        dz += dzi * dzi;
+      }
+      if (dz < TRIVIAL_TOLERANCE && tm_trial > -STABILITY_TM_MIN) {
+        trivial = true;
+        break;
+      }
+      if (gn < STABILITY_TOLERANCE)
+        break;
+      if (it % GDEM_PERIOD == GDEM_PERIOD - 1)
+        gdem_step(n, g_.data(), g_prev_.data(), lw);
+      std::swap(g_, g_prev_);
+    }
+    if (!trivial && tm_trial < -STABILITY_TM_MIN) {
+      unstable[trial] = true;
+      tm_min = std::min(tm_min, tm_trial);
+    }
+  }
+  *tm = tm_min;
+  for (size_t i = 0; i < n; ++i) {
+    const double lz = std::log(std::max(z[i], 1.0e-300));
+    if (unstable[0] && unstable[1])
+      ln_k[i] = ln_wv_[i] - ln_wl_[i];
+    else if (unstable[0])
+      ln_k[i] = ln_wv_[i] - lz;
+    else if (unstable[1])
+      ln_k[i] = lz - ln_wl_[i];
+  }
+  return !(unstable[0] || unstable[1]);
+}
+
+int PhaseEquilibrium::successive_substitution(const double* z,
+                                              double* ln_k,
+                                              flash_result* res) {
+  const size_t n = z_.size();
+  double *x = res->x.data(), *y = res->y.data(), *k = res->k.data();
+  double beta = 0.0, zl = 0.0, zv = 0.0;
+  bool converged = false;
+  for (int it = 0; it < max_iterations; ++it) {
+    for (size_t i = 0; i < n; ++i)
+      k[i] = std::exp(ln_k[i]);
+    beta = rachford_rice(z, k);
+    double sx = 0.0, sy = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+      x[i] = z[i] / (1.0 + beta * (k[i] - 1.0));
+      y[i] = k[i] * x[i];
+      sx += x[i];
+      sy += y[i];
+    }
+    for (size_t i = 0; i < n; ++i) {
+      x[i] /= sx;
+      y[i] /= sy;
+    }
+    zl = ln_phi(x, ln_phi_l_.data());
+    zv = ln_phi(y, ln_phi_v_.data());
+    double gn = 0.0, lk = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+      g_[i] = ln_phi_l_[i] - ln_phi_v_[i] - ln_k[i];
+      ln_k[i] += g_[i];
+      gn += g_[i] * g_[i];
+      lk += ln_k[i] * ln_k[i];
+    }
+    ++res->iterations;
+    if (lk < TRIVIAL_TOLERANCE)
+      return 1;
+    if (gn < FLASH_TOLERANCE) {
+      converged = true;
+      break;
+    }
+    if (it % GDEM_PERIOD == GDEM_PERIOD - 1)
+      gdem_step(n, g_.data(), g_prev_.data(), ln_k);
+    std::swap(g_, g_prev_);
+  }
+  if (!converged)
+    return 0;
+  if (!(beta > 0.0 && beta < 1.0))
+    return 1;
+  for (size_t i = 0; i < n; ++i)
+    k[i] = y[i] / x[i];
+  res->phases = 2;
+  res->vapor_fraction = beta;
+  res->z_liquid = zl;
+  res->z_vapor = zv;
+  return 2;
+}
+
+/*
+ * sum_i z_i * (K_i - 1) / (1 + β * (K_i - 1)) = 0, левая часть убывает
+ *   по β, метод Ньютона с контролем интервала
+ */
+double PhaseEquilibrium::rachford_rice(const double* z, const double* k) const {
+  const size_t n = z_.size();
+  double f0 = 0.0, f1 = 0.0;
+  for (size_t i = 0; i < n; ++i) {
+    f0 += z[i] * (k[i] - 1.0);
+    f1 += z[i] * (k[i] - 1.0) / k[i];
+  }
+  if (f0 <= 0.0)
+    return 0.0;
+  if (f1 >= 0.0)
+    return 1.0;
+  double lo = 0.0, hi = 1.0, beta = 0.5;
+  for (int it = 0; it < 100; ++it) {
+    double f = 0.0, df = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+      const double c = k[i] - 1.0, d = 1.0 / (1.0 + beta * c);
+      f += z[i] * c * d;
+      df -= z[i] * c * c * d * d;
+    }
+    if (f > 0.0)
+      lo = beta;
+    else
+      hi = beta;
+    double next = beta - f / df;
+    if (!(next > lo && next < hi))
+      next = 0.5 * (lo + hi);
+    if (std::abs(next - beta) < 1.0e-15)
+      return next;
+    beta = next;
+  }
+  return beta;
+}
+
+void PhaseEquilibrium::set_single_phase(const double* z, flash_result* res) {
+  const size_t n = z_.size();
+  double B = 0.0;
+  for (size_t i = 0; i < n; ++i) {
+    res->x[i] = z[i];
+    res->y[i] = z[i];
+    res->k[i] = 1.0;
+    B += z[i] * b_[i];
+  }
+  const double Z = ln_phi(z, ln_phi_l_.data());
+  res->phases = 1;
+  res->vapor_fraction = (Z > LIQUID_VOLUME_RATIO * B) ? 1.0 : 0.0;
+  res->z_liquid = Z;
+  res->z_vapor = Z;
+}
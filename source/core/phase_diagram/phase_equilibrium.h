@@ -0,0 +1,198 @@
+/**
+ * asp_therm - implementation of real gas equations of state
+ *
+ *
+ * Copyright (c) 2020-2021 Mishutinski Yurii
+ *
+ * This library is distributed under the MIT License.
+ * See LICENSE file in the project root for full license information.
+ */
+#ifndef _CORE__PHASE_DIAGRAM__PHASE_EQUILIBRIUM_H_
+#define _CORE__PHASE_DIAGRAM__PHASE_EQUILIBRIUM_H_
+
+#include "asp_utils/ErrorWrap.h"
+#include "atherm_common.h"
+#include "gas_description.h"
+#include "model_cubic_eos.h"
+
+#include <vector>
+
+#include <stddef.h>
+
+/*
+ * Модуль расчёта фазового равновесия жидкость-пар многокомпонентных
+ *   смесей по кубическим уравнениям состояния Пенга-Робинсона и
+ *   Соаве-Редлиха-Квонга: коэффициенты летучести компонентов,
+ *   проверка устойчивости фазы по критерию касательной плоскости
+ *   и двухфазный расчёт при заданных давлении и температуре
+ *   (PT flash). См. Michelsen M.L. The isothermal flash problem,
+ *   Fluid Phase Equilibria 9 (1982)
+ *
+ * Уравнение состояния решается в безразмерном виде
+ *   A_i = Ωa * alpha_i(T) * (p / Pc_i) / (T / Tc_i)^2,
+ *   B_i = Ωb * (p / Pc_i) / (T / Tc_i),
+ *   поэтому результат не зависит от единиц измерения коэффициентов
+ *   модели, а доли компонентов - мольные
+ */
+
+/** \brief Результат расчёта фазового равновесия в точке (p, T)
+ *
+ * Для однофазного состояния x = y = z, K_i = 1, а vapor_fraction
+ *   равна 1 для газоподобной(v / b > 1.75) и 0 для жидкоподобной фазы */
+struct flash_result {
+  /// число фаз: 1 или 2
+  int phases = 0;
+  /// мольная доля паровой фазы
+  double vapor_fraction = 0.0;
+  /// состав жидкой фазы x_i
+  std::vector<double> x;
+  /// состав паровой фазы y_i
+  std::vector<double> y;
+  /// константы фазового равновесия K_i = y_i / x_i
+  std::vector<double> k;
+  /// коэффициент сжимаемости жидкой фазы
+  double z_liquid = 0.0;
+  /// коэффициент сжимаемости паровой фазы
+  double z_vapor = 0.0;
+  /// число итераций метода последовательных подстановок
+  int iterations = 0;
+};
+
+/** \brief Фазовое равновесие смеси для моделей Пенга-Робинсона
+ *   (все подтипы) и Соаве-Редлиха-Квонга с коэффициентами бинарного
+ *   взаимодействия моделей
+ *
+ * Коэффициенты, зависящие от (p, T), пересчитываются только при смене
+ *   точки. Константы равновесия последнего двухфазного расчёта
+ *   используются как начальное приближение следующего, поэтому
+ *   точки выгодно обходить вдоль изотермы или изобары
+ *
+ * \note Объект хранит рабочие массивы и начальное приближение,
+ *   поэтому его нельзя использовать из нескольких потоков одновременно
+ * */
+class PhaseEquilibrium {
+  PhaseEquilibrium(const PhaseEquilibrium&) = delete;
+  PhaseEquilibrium& operator=(const PhaseEquilibrium&) = delete;
+
+ public:
+  /** \brief Максимальное число итераций метода последовательных
+   *   подстановок */
+  static constexpr int max_iterations = 500;
+
+ public:
+  /**
+   * \brief Создать объект расчёта для смеси components
+   * \param mn Модель: PENG_ROBINSON или REDLICH_KWONG с подтипом
+   *   MODEL_RK_SUBTYPE_SOAVE
+   * \return nullptr если модель не поддерживается или смесь пуста
+   * */
+  static PhaseEquilibrium* Init(rg_model_id mn,
+                                const parameters_mix& components);
+
+  /** \brief Число компонентов смеси */
+  size_t Size() const;
+  /** \brief Мольные доли компонентов смеси, порядок компонентов -
+   *   порядок parameters_mix */
+  const std::vector<double>& GetComposition() const;
+  /**
+   * \brief Логарифмы коэффициентов летучести компонентов ln(phi_i)
+   *   для фазы состава x[i], i < Size()
+   * \param z[out] Коэффициент сжимаемости фазы(может быть nullptr)
+   *
+   * \note Из нескольких корней уравнения состояния выбирается корень
+   *   с наименьшей энергией Гиббса
+   * */
+  merror_t LnFugacityCoefs(double p,
+                           double t,
+                           const double* x,
+                           double* ln_phi,
+                           double* z = nullptr);
+  /**
+   * \brief Проверить устойчивость фазы состава z[i], i < Size(), по
+   *   критерию касательной плоскости с газоподобной и жидкоподобной
+   *   пробными фазами
+   * \param stable[out] true если фаза устойчива
+   * \param tm[out] Минимальное значение приведённого расстояния до
+   *   касательной плоскости(может быть nullptr)
+   * */
+  merror_t StabilityTest(double p,
+                         double t,
+                         const double* z,
+                         bool* stable,
+                         double* tm = nullptr);
+  /**
+   * \brief Расчёт фазового равновесия для состава смеси GetComposition()
+   * */
+  merror_t Flash(double p, double t, flash_result* res);
+  /**
+   * \brief Расчёт фазового равновесия для состава z[i], i < Size()
+   *
+   * Метод последовательных подстановок с ускорением по доминирующему
+   *   собственному значению(GDEM) каждые 5 итераций. Начальное
+   *   приближение - константы равновесия предыдущего двухфазного
+   *   расчёта, иначе результат проверки устойчивости
+   *
+   * \return ERROR_SUCCESS_T, ERROR_INIT_NULLP_ST или
+   *   ERROR_CALC_PHASE_ST если итерации не сошлись
+   * */
+  merror_t Flash(double p, double t, const double* z, flash_result* res);
+  /** \brief Сбросить начальное приближение констант равновесия */
+  void ResetWarmStart();
+
+  merror_t GetError() const;
+
+ private:
+  PhaseEquilibrium(rg_model_id mn, const parameters_mix& components);
+
+  /** \brief Пересчитать sqrt(A_i), B_i и матрицу A_ij для (p, t) */
+  void set_state(double p, double t);
+  /** \brief ln(phi_i) для состава x в текущей точке, возвращает
+   *   коэффициент сжимаемости фазы */
+  double ln_phi(const double* x, double* ln_phi);
+  /** \brief Проверка устойчивости в текущей точке
+   * \param ln_k[in, out] Начальное приближение ln(K_i), при
+   *   неустойчивости - приближение для расчёта равновесия */
+  bool stability(const double* z, double* ln_k, double* tm);
+  /** \brief Метод последовательных подстановок в текущей точке
+   * \param ln_k[in, out] ln(K_i)
+   * \return Число фаз(1 для тривиального решения или доли пара вне
+   *   (0, 1), 2) или 0, если итерации не сошлись */
+  int successive_substitution(const double* z,
+                               double* ln_k,
+                               flash_result* res);
+  /** \brief Решение уравнения Рахфорда-Райса на [0, 1] */
+  double rachford_rice(const double* z, const double* k) const;
+  /** \brief Записать в res однофазное состояние состава z */
+  void set_single_phase(const double* z, flash_result* res);
+
+ private:
+  ErrorWrap error_;
+  /// δ1, δ2 уравнения состояния
+  double delta1_, delta2_;
+  /// мольные доли компонентов
+  std::vector<double> z_;
+  /// критические параметры и фактор ацентричности компонентов
+  std::vector<double> tc_, pc_, af_;
+  /// sqrt(Ωa * Tc_i^2 / Pc_i) и Ωb * Tc_i / Pc_i, R = 1
+  std::vector<double> sqrt_ac_, bc_;
+  std::vector<alpha_soave> alpha_;
+  /// 1 - k_ij, матрица n x n по строкам
+  std::vector<double> m_;
+
+  /* текущая точка */
+  double p_ = 0.0, t_ = 0.0;
+  /// B_i
+  std::vector<double> b_;
+  /// (1 - k_ij) * sqrt(A_i * A_j)
+  std::vector<double> a_;
+
+  /* рабочие массивы */
+  std::vector<double> psi_, w_, ln_phi_, ln_phi_l_, ln_phi_v_, d_;
+  std::vector<double> g_, g_prev_, ln_wv_, ln_wl_, ln_k_;
+
+  /// ln(K_i) последнего двухфазного расчёта
+  std::vector<double> warm_ln_k_;
+  bool warm_valid_ = false;
+};
+
+#endif  // !_CORE__PHASE_DIAGRAM__PHASE_EQUILIBRIUM_H_
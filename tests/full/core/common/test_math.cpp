@@ -1,10 +1,12 @@
 #include "models_math.h"
+#include "dual_number.h"
 
 #include "Common.h"
 
 #include "gtest/gtest.h"
 
 #include <algorithm>
+#include <vector>
 
 
 TEST(is_above0Test, Simple) {
@@ -127,3 +129,157 @@ TEST_F(CardanoMethodTest, Simple) {
       {-0.892279, 0.0}, {0.99614, -1.25912}, {0.99614, 1.25912}};
   EXPECT_EQ(eq_roots(ans, expect, 3), true);
 }
+
+/** \brief Проверить корни функции CubicRealRoots, корни
+  *   должны быть упорядочены по убыванию */
+TEST_F(CardanoMethodTest, CubicRealRoots) {
+  c[0] = 1.0; c[1] = 0.5; c[2] = -3.72; c[3] = 2.016;
+  int rk = 0;
+  double res[3] = {0.0, 0.0, 0.0};
+  EXPECT_EQ(CubicRealRoots(c, res, &rk), ERROR_SUCCESS_T);
+  EXPECT_EQ(rk, 3);
+  EXPECT_NEAR(res[0], 1.2, 1e-12);
+  EXPECT_NEAR(res[1], 0.7, 1e-12);
+  EXPECT_NEAR(res[2], -2.4, 1e-12);
+
+  c[0] = 1.0; c[1] = -1.1; c[2] = 0.8; c[3] = 2.3;
+  EXPECT_EQ(CubicRealRoots(c, res, &rk), ERROR_SUCCESS_T);
+  EXPECT_EQ(rk, 1);
+  EXPECT_NEAR(res[0], -0.892279, 1e-6);
+  EXPECT_EQ(res[0], res[2]);
+
+  c[0] = 1.0; c[1] = -19; c[2] = 0.0; c[3] = 0.0;
+  EXPECT_EQ(CubicRealRoots(c, res, &rk), ERROR_SUCCESS_T);
+  EXPECT_NEAR(res[0], 19.0, 1e-12);
+  EXPECT_NEAR(res[2], 0.0, 1e-6);
+
+  c[0] = 0.0;
+  EXPECT_EQ(CubicRealRoots(c, res, &rk), ERROR_INIT_ZERO_ST);
+}
+
+/** \brief Проверить CubicRealRoots для коэффициентов малого
+  *   масштаба(уравнение состояния в удельном объёме, м^3/кг),
+  *   корни (x - 2e-3)(x - 3e-3)(x - 0.05) и (x - 0.03)(x^2 + 1e-6) */
+TEST_F(CardanoMethodTest, CubicRealRootsScale) {
+  const double r1 = 2.0e-3, r2 = 3.0e-3, r3 = 0.05;
+  c[0] = 1.0;
+  c[1] = -(r1 + r2 + r3);
+  c[2] = r1 * r2 + r1 * r3 + r2 * r3;
+  c[3] = -r1 * r2 * r3;
+  int rk = 0;
+  double res[3] = {0.0, 0.0, 0.0};
+  EXPECT_EQ(CubicRealRoots(c, res, &rk), ERROR_SUCCESS_T);
+  EXPECT_EQ(rk, 3);
+  EXPECT_NEAR(res[0], r3, 1e-15);
+  EXPECT_NEAR(res[1], r2, 1e-15);
+  EXPECT_NEAR(res[2], r1, 1e-15);
+
+  c[1] = -0.03; c[2] = 1.0e-6; c[3] = -0.03 * 1.0e-6;
+  EXPECT_EQ(CubicRealRoots(c, res, &rk), ERROR_SUCCESS_T);
+  EXPECT_EQ(rk, 1);
+  EXPECT_NEAR(res[0], 0.03, 1e-15);
+}
+
+/** \brief CubicOuterRootsLanes и CubicMaxRootLanes совпадают с
+  *   наибольшим и наименьшим корнями CubicRealRoots для уравнений
+  *   с тремя корнями(в том числе кратными), одним корнем и разного
+  *   масштаба коэффициентов */
+TEST_F(CardanoMethodTest, CubicMaxRootLanes) {
+  const double roots3[][3] = {{1.2, 0.7, -2.4}, {2.0e-3, 3.0e-3, 0.05},
+                              {0.3, 0.3, -1.0}, {-0.5, -0.5, -0.5},
+                              {1.0e3, 2.0, 1.0}};
+  std::vector<double> b, cc, d;
+  for (const auto& r : roots3) {
+    b.push_back(-(r[0] + r[1] + r[2]));
+    cc.push_back(r[0] * r[1] + r[0] * r[2] + r[1] * r[2]);
+    d.push_back(-r[0] * r[1] * r[2]);
+  }
+  // один корень: (x - r) * (x^2 + q)
+  const double roots1[][2] = {{0.03, 1.0e-6}, {-0.892279, 2.5}, {5.0, 1.0e4}};
+  for (const auto& r : roots1) {
+    b.push_back(-r[0]);
+    cc.push_back(r[1]);
+    d.push_back(-r[0] * r[1]);
+  }
+  b.resize(2 * ATHERM_LANES, -1.0);
+  cc.resize(2 * ATHERM_LANES, 0.0);
+  d.resize(2 * ATHERM_LANES, 0.0);
+  std::vector<double> lanes(b.size()), lanes_max(b.size()),
+      lanes_min(b.size());
+  for (size_t i = 0; i < b.size(); i += ATHERM_LANES) {
+    CubicMaxRootLanes(&b[i], &cc[i], &d[i], &lanes[i]);
+    CubicOuterRootsLanes(&b[i], &cc[i], &d[i], &lanes_max[i],
+                         &lanes_min[i]);
+  }
+  for (size_t i = 0; i < b.size(); ++i) {
+    c[0] = 1.0; c[1] = b[i]; c[2] = cc[i]; c[3] = d[i];
+    int rk = 0;
+    double res[3] = {0.0, 0.0, 0.0};
+    ASSERT_EQ(CubicRealRoots(c, res, &rk), ERROR_SUCCESS_T);
+    // кратные корни определены с точностью ~ sqrt(eps)
+    EXPECT_NEAR(lanes[i], res[0], 1.0e-7 * (1.0 + std::abs(res[0]))) << i;
+    EXPECT_EQ(lanes_max[i], lanes[i]) << i;
+    EXPECT_NEAR(lanes_min[i], res[2], 1.0e-7 * (1.0 + std::abs(res[2])))
+        << i;
+  }
+  EXPECT_NEAR(lanes_min[0], -2.4, 1e-12);
+  EXPECT_NEAR(lanes_min[1], 2.0e-3, 1e-15);
+  EXPECT_NEAR(lanes_min[4], 1.0, 1e-10);
+  EXPECT_EQ(lanes_min[5], lanes_max[5]);
+  EXPECT_NEAR(lanes[0], 1.2, 1e-12);
+  EXPECT_NEAR(lanes[1], 0.05, 1e-15);
+  EXPECT_NEAR(lanes[4], 1.0e3, 1e-10);
+  EXPECT_NEAR(lanes[5], 0.03, 1e-15);
+  EXPECT_NEAR(lanes[6], -0.892279, 1e-12);
+}
+
+/** \brief Функции lane_math.h совпадают с функциями libm в
+  *   пределах заявленной погрешности */
+TEST(lane_math, ElementaryFunctions) {
+  double max_sqrt = 0.0, max_cbrt = 0.0, max_cos = 0.0, max_acos = 0.0,
+         max_exp = 0.0, max_log = 0.0;
+  for (int i = 0; i <= 2000; ++i) {
+    // x от 1e-300 до 1e300, y из [-pi/2, pi/2], z из [-1, 1]
+    const double x = std::pow(10.0, -300.0 + 0.3 * i),
+                 y = 1.5707963267948966 * (i - 1000) / 1000.0,
+                 z = (i - 1000) / 1000.0, e = 0.7 * (i - 1000);
+    max_sqrt = std::max(max_sqrt,
+                        std::abs(LaneSqrt(x) - std::sqrt(x)) / std::sqrt(x));
+    max_cbrt = std::max(max_cbrt,
+                        std::abs(LaneCbrt(x) - std::cbrt(x)) / std::cbrt(x));
+    max_cos = std::max(max_cos, std::abs(LaneCos(y) - std::cos(y)));
+    max_acos = std::max(max_acos, std::abs(LaneAcos(z) - std::acos(z)));
+    max_exp = std::max(max_exp,
+                       std::abs(LaneExp(e) - std::exp(e)) / std::exp(e));
+    max_log = std::max(max_log, std::abs(LaneLog(x) - std::log(x))
+                                    / std::max(1.0, std::abs(std::log(x))));
+  }
+  EXPECT_LT(max_sqrt, 3e-16);
+  EXPECT_LT(max_cbrt, 7e-16);
+  EXPECT_LT(max_cos, 3e-16);
+  EXPECT_LT(max_acos, 5e-16);
+  EXPECT_LT(max_exp, 3e-16);
+  EXPECT_LT(max_log, 4e-16);
+  EXPECT_EQ(LaneSqrt(0.0), 0.0);
+  EXPECT_EQ(LaneAcos(1.0), 0.0);
+  EXPECT_NEAR(LaneAcos(-1.0), 3.141592653589793, 1e-15);
+}
+
+/** \brief Производные элементарных функций от dual<2>
+  *   f(x, y) = sqrt(x) * exp(y) / log(x + y) + pow(x, 1.5) - y */
+TEST(dual, ElementaryFunctions) {
+  const double x = 2.5, y = 0.7;
+  const dual<2> dx = dual<2>::Variable(x, 0), dy = dual<2>::Variable(y, 1);
+  const dual<2> f = sqrt(dx) * exp(dy) / log(dx + dy) + pow(dx, 1.5) - dy;
+  const double l = std::log(x + y), e = std::exp(y), s = std::sqrt(x);
+  EXPECT_NEAR(value_of(f), s * e / l + std::pow(x, 1.5) - y, 1e-14);
+  EXPECT_NEAR(f.d[0],
+      0.5 * e / (s * l) - s * e / (l * l * (x + y)) + 1.5 * std::sqrt(x),
+      1e-13);
+  EXPECT_NEAR(f.d[1], s * e / l - s * e / (l * l * (x + y)) - 1.0, 1e-13);
+  /* константы не имеют производных, сравнение - по значению */
+  const dual<2> c = 3.0 * dx - dx * 3.0;
+  EXPECT_EQ(c.d[0], 0.0);
+  EXPECT_TRUE(dx > 2.0 && -dx < 0.0 && abs(-dx) == dx);
+  EXPECT_EQ(abs(-dx).d[0], 1.0);
+}
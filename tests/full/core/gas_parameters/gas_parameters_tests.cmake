@@ -11,6 +11,9 @@ add_executable(test_gasparameters
   ${THERMCORE_SOURCE_DIR}/gas_parameters/gas_description.cpp
   ${THERMCORE_SOURCE_DIR}/gas_parameters/gas_description_dynamic.cpp
   ${THERMCORE_SOURCE_DIR}/gas_parameters/gas_description_static.cpp
+  ${THERMCORE_SOURCE_DIR}/gas_parameters/gas_ng_gost30319.cpp
+  ${THERMCORE_SOURCE_DIR}/gas_parameters/gas_ng_gost30319_table.cpp
+  ${THERMCORE_SOURCE_DIR}/gas_parameters/gas_ng_gost_defines.cpp
   ${THERMCORE_SOURCE_DIR}/gas_parameters/gasmix_init.cpp
 
   ${THERMCORE_SOURCE_DIR}/subroutins/file_structs.cpp)
@@ -0,0 +1,707 @@
+#include "gas_ng_gost30319.h"
+#include "gas_ng_gost30319_table.h"
+
+#include "atherm_common.h"
+#include "dual_number.h"
+#include "gas_defines.h"
+#include "gas_description.h"
+#include "gas_ng_gost_defines.h"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+/** \brief Прокси класс доступа к закрытым методам ГОСТ модели */
+class GasParameters_NG_Gost_dynProxy {
+ public:
+  GasParameters_NG_Gost_dynProxy(GasParametersGost30319Dyn* gost)
+      : gost_(gost) {}
+
+  merror_t calculate_sigma(double p,
+                           double t,
+                           double sigma_init,
+                           double* sigma) const {
+    return gost_->kernel_->CalculateSigma(p, t, sigma_init, sigma);
+  }
+  const ng_gost30319_params& params() const { return gost_->ng_gost_params_; }
+  /** \brief Функции A0-A3 для температуры t и приведённой
+   *   плотности sigma */
+  ng_gost30319_A0_3 calculate_A0_3(double t, double sigma) const {
+    ng_gost30319_tau_terms terms;
+    gost_->kernel_->CalculateTauTerms(t, &terms);
+    return gost_->kernel_->calculate_A0_3(gost_->kernel_->GetCoefs(),
+                                          terms.a_tu.data(), sigma);
+  }
+  const ng_gost30319_coefs* coefs() const {
+    return &gost_->kernel_->GetCoefs();
+  }
+  /** \brief Рассчитать коэффициенты Bn для смеси mix */
+  std::vector<double> set_Bn(const ng_gost_mix& mix) {
+    ng_gost_mix keep = gost_->components_;
+    auto keep_terms = gost_->mix_terms_;
+    ng_gost30319_coefs coefs;
+    gost_->components_ = mix;
+    gost_->init_mix_terms();
+    gost_->calculate_coefs(coefs);
+    gost_->components_ = keep;
+    gost_->mix_terms_ = keep_terms;
+    return coefs.Bn;
+  }
+
+ private:
+  GasParametersGost30319Dyn* gost_;
+};
+
+/** \brief Расчёт коэффициентов Bn по формуле ГОСТ 30319.3 "в лоб",
+ *   по всем n и всем парам компонентов */
+std::vector<double> reference_Bn(const ng_gost_mix& mix) {
+  std::vector<double> Bn(A0_3_coefs_count, 0.0);
+  for (size_t n = 0; n < A0_3_coefs_count; ++n) {
+    const A0_3_coef& A3c = A0_3_coefs[n];
+    for (size_t i = 0; i < mix.size(); ++i) {
+      auto xi = get_characteristics(mix[i].first);
+      for (size_t j = 0; j < mix.size(); ++j) {
+        auto xj = get_characteristics(mix[j].first);
+        auto assoc = get_binary_associate_coefs(mix[i].first, mix[j].first);
+        double Gij = assoc->G * (xi->G + xj->G) / 2.0;
+        double Bnij = pow(Gij + 1.0 - A3c.g, A3c.g)
+                      * pow(xi->Q * xj->Q + 1.0 - A3c.q, A3c.q)
+                      * pow(sqrt(xi->F * xj->F) + 1.0 - A3c.f, A3c.f)
+                      * pow(xi->S * xj->S + 1.0 - A3c.s, A3c.s)
+                      * pow(xi->W * xj->W + 1.0 - A3c.w, A3c.w);
+        double Eij = assoc->E * sqrt(xi->E * xj->E);
+        Bn[n] += mix[i].second * mix[j].second * Bnij * pow(Eij, A3c.u)
+                 * pow(xi->K * xj->K, 1.5);
+      }
+    }
+  }
+  return Bn;
+}
+
+/** \brief Функции A0-A3 ГОСТ 30319.3 по отдельности, по формулам
+ *   стандарта(прежний расчёт), для сравнения с calculate_A0_3 */
+ng_gost30319_A0_3 reference_A0_3(const ng_gost30319_coefs& coefs,
+                                 double t,
+                                 double sigm) {
+  auto Dn = [&coefs](size_t n) {
+    if (n < 12)
+      return coefs.Bn[n] * pow(coefs.kx, -3.0);
+    else if (n >= 12 && n < 18)
+      return coefs.Bn[n] * pow(coefs.kx, -3.0) - coefs.Cn[n];
+    return 0.0;
+  };
+  auto Un = [&coefs](size_t n) { return (n < 12) ? 0.0 : coefs.Cn[n]; };
+  ng_gost30319_A0_3 a = {0.0, 0.0, 0.0, 0.0};
+  // масштаб температуры модели Lt = 1 К
+  const double tau = t;
+  for (size_t n = 0; n < A0_3_coefs_count; ++n) {
+    const A0_3_coef& A3c = A0_3_coefs[n];
+    const double ck = A3c.c * A3c.k * pow(sigm, A3c.k),
+                 e = exp(-A3c.c * pow(sigm, A3c.k)),
+                 st = A3c.a * pow(sigm, A3c.b) * pow(tau, -A3c.u);
+    a.A0 += st * (A3c.b * Dn(n) + (A3c.b - ck) * Un(n) * e);
+    a.A1 += st * ((A3c.b + 1.0) * A3c.b * Dn(n)
+                  + ((A3c.b - ck) * (A3c.b - ck + 1.0) - A3c.k * ck) * Un(n)
+                        * e);
+    a.A2 += st * (1.0 - A3c.u) * (A3c.b * Dn(n) + (A3c.b - ck) * Un(n) * e);
+    a.A3 += st * (1.0 - A3c.u) * A3c.u * (Dn(n) + Un(n) * e);
+  }
+  return a;
+}
+
+/** \brief Смесь из count компонентов ГОСТ(ISO) модели, при
+ *   count > 21 компоненты повторяются */
+ng_gost_mix make_mix(size_t count) {
+  const std::vector<gas_t> gases = {
+      CH(METHANE),          CH(ETHANE),          CH(PROPANE),
+      CH(NITROGEN),         CH(CARBON_DIOXIDE),  CH(N_BUTANE),
+      CH(ISO_BUTANE),       CH(N_PENTANE),       CH(ISO_PENTANE),
+      CH(HEXANE),           CH(HELIUM),          CH(HYDROGEN),
+      CH(HYDROGEN_SULFIDE), CH(OXYGEN),          CH(ARGON),
+      CH(HEPTANE),          CH(OCTANE),          CH(NONANE),
+      CH(DECANE),           CH(CARBON_MONOXIDE), CH(WATER)};
+  ng_gost_mix mix;
+  double rest = 1.0;
+  for (size_t i = 1; i < count; ++i) {
+    double part = 0.1 / count;
+    mix.push_back({gases[i % gases.size()], part});
+    rest -= part;
+  }
+  mix.insert(mix.begin(), {CH(METHANE), rest});
+  return mix;
+}
+
+/** \brief Тесты расчёта параметров природного газа по ГОСТ 30319 */
+class GostNGTest : public ::testing::Test {
+ protected:
+  GostNGTest()
+      : mix_({{CH(METHANE), 0.965},
+              {CH(ETHANE), 0.018},
+              {CH(PROPANE), 0.0045},
+              {CH(N_BUTANE), 0.001},
+              {CH(ISO_BUTANE), 0.001},
+              {CH(N_PENTANE), 0.0003},
+              {CH(ISO_PENTANE), 0.0005},
+              {CH(HEXANE), 0.0007},
+              {CH(NITROGEN), 0.003},
+              {CH(CARBON_DIOXIDE), 0.006}}) {}
+
+  void SetUp() override {
+    gas_params_input gpi;
+    gpi.p = 5000000.0;
+    gpi.t = 300.0;
+    gpi.const_dyn.ng_gost_components = &mix_;
+    gost_.reset(GasParametersGost30319Dyn::Init(gpi, false));
+    ASSERT_NE(gost_, nullptr);
+  }
+
+ protected:
+  ng_gost_mix mix_;
+  std::unique_ptr<GasParametersGost30319Dyn> gost_;
+};
+
+/** \brief Начальное приближение из соседней точки, в том числе
+ *   неудачное, не меняет результат итерационной процедуры */
+TEST_F(GostNGTest, SigmaWarmStart) {
+  GasParameters_NG_Gost_dynProxy proxy(gost_.get());
+  double cold = 0.0, warm = 0.0, bad = 0.0;
+  ASSERT_EQ(proxy.calculate_sigma(6000000.0, 300.0, 0.0, &cold),
+            ERROR_SUCCESS_T);
+  ASSERT_EQ(proxy.calculate_sigma(6000000.0, 300.0, cold * 0.98, &warm),
+            ERROR_SUCCESS_T);
+  EXPECT_NEAR(warm, cold, cold * 1.0e-5);
+  ASSERT_EQ(proxy.calculate_sigma(6000000.0, 300.0, 1.0e6, &bad),
+            ERROR_SUCCESS_T);
+  EXPECT_NEAR(bad, cold, cold * 1.0e-5);
+}
+
+/** \brief Функции A0-A3 за один проход совпадают с расчётом по
+ *   отдельности с точностью до округления: Kx^-3 и порядок
+ *   умножений отличаются, поэтому побитового совпадения нет */
+TEST_F(GostNGTest, A0_3) {
+  GasParameters_NG_Gost_dynProxy proxy(gost_.get());
+  const ng_gost30319_coefs& coefs = *proxy.coefs();
+  double max_diff = 0.0;
+  for (double t = 250.0; t < 351.0; t += 25.0) {
+    for (double sigm = 0.01; sigm < 1.5; sigm *= 1.6) {
+      const ng_gost30319_A0_3 a = proxy.calculate_A0_3(t, sigm),
+                              ref = reference_A0_3(coefs, t, sigm);
+      const double fused[] = {a.A0, a.A1, a.A2, a.A3},
+                   single[] = {ref.A0, ref.A1, ref.A2, ref.A3};
+      for (size_t i = 0; i < 4; ++i) {
+        // суммы знакопеременны, погрешность - от масштаба 1 + A
+        const double diff =
+            std::abs(fused[i] - single[i]) / (1.0 + std::abs(single[i]));
+        EXPECT_LT(diff, 1.0e-13) << "A" << i << " t=" << t << " s=" << sigm;
+        max_diff = std::max(max_diff, diff);
+      }
+    }
+  }
+  EXPECT_GT(max_diff, 0.0);
+}
+
+/** \brief Расчёт изотермы с начальным приближением из
+ *   предыдущей точки совпадает с расчётом без него */
+TEST_F(GostNGTest, Isotherm) {
+  for (double p = 1000000.0; p < 30000000.0; p += 1000000.0) {
+    gost_->csetParameters(0.0, p, 300.0, state_phase::GAS);
+    EXPECT_EQ(gost_->cGetStatus(), STATUS_OK);
+    gas_params_input gpi;
+    gpi.p = p;
+    gpi.t = 300.0;
+    gpi.const_dyn.ng_gost_components = &mix_;
+    std::unique_ptr<GasParametersGost30319Dyn> cold(
+        GasParametersGost30319Dyn::Init(gpi, false));
+    ASSERT_NE(cold, nullptr);
+    EXPECT_NEAR(gost_->cgetVolume(), cold->cgetVolume(),
+                1.0e-5 * cold->cgetVolume());
+  }
+}
+
+/** \brief Коэффициент сжимаемости смеси mix_ (газ 1 приложения C
+ *   ISO 12213-2, уравнение AGA8-92DC то же, что в ГОСТ 30319.3)
+ *   совпадает с опубликованными значениями. Без коэффициентов
+ *   бинарного взаимодействия метан-пропан, CO2-метан и других пар,
+ *   заданных в таблице в обратном порядке, z отличается на
+ *   1e-4 - 2e-3 */
+TEST_F(GostNGTest, ReferenceZ) {
+  struct reference_z {
+    double p;
+    double t;
+    double z;
+  };
+  const reference_z ref[] = {{6000000.0, 270.0, 0.84053},
+                             {12000000.0, 270.0, 0.72133},
+                             {6000000.0, 330.0, 0.93011},
+                             {12000000.0, 330.0, 0.88383}};
+  for (bool use_iso : {false, true}) {
+    gas_params_input gpi;
+    gpi.p = 5000000.0;
+    gpi.t = 300.0;
+    gpi.const_dyn.ng_gost_components = &mix_;
+    std::unique_ptr<GasParametersGost30319Dyn> gost(
+        GasParametersGost30319Dyn::Init(gpi, use_iso));
+    ASSERT_NE(gost, nullptr);
+    std::shared_ptr<const Gost30319Kernel> kernel = gost->GetKernel();
+    for (const auto& r : ref) {
+      ng_gost30319_state st;
+      ASSERT_EQ(kernel->Evaluate(r.p, r.t, 0.0, &st), ERROR_SUCCESS_T);
+      // значения опубликованы с 5 знаками
+      EXPECT_NEAR(st.params.z, r.z, 1.0e-5)
+          << "p=" << r.p << " t=" << r.t << " iso=" << use_iso;
+    }
+  }
+}
+
+/** \brief Пакетный расчёт совпадает с поточечным и не меняет
+ *   состояние объекта */
+TEST_F(GostNGTest, CalculateBatch) {
+  const std::vector<double> p = {1000000.0, 5000000.0, 12000000.0,
+                                 1000000.0, 40000000.0, 20000000.0};
+  const std::vector<double> t = {250.0, 250.0, 250.0, 340.0, 340.0, 340.0};
+  std::vector<double> z(p.size()), v(p.size()), k(p.size()), w(p.size());
+  ng_gost30319_batch res = {};
+  res.z = z.data();
+  res.volume = v.data();
+  res.k = k.data();
+  res.w = w.data();
+  const double v_keep = gost_->cgetVolume();
+  // 40МПа - за пределами применимости модели
+  EXPECT_EQ(gost_->CalculateBatch(p.data(), t.data(), p.size(), res),
+            ERROR_CALCULATE_T);
+  EXPECT_DOUBLE_EQ(gost_->cgetVolume(), v_keep);
+  EXPECT_DOUBLE_EQ(v[4], 0.0);
+  for (size_t i = 0; i < p.size(); ++i) {
+    if (i == 4)
+      continue;
+    gost_->csetParameters(0.0, p[i], t[i], state_phase::GAS);
+    GasParameters_NG_Gost_dynProxy proxy(gost_.get());
+    EXPECT_NEAR(v[i], gost_->cgetVolume(), 1.0e-5 * v[i]);
+    EXPECT_NEAR(z[i], proxy.params().z, 1.0e-5);
+    EXPECT_NEAR(k[i], proxy.params().k, 1.0e-5);
+    EXPECT_NEAR(w[i], proxy.params().w, 1.0e-3);
+  }
+}
+
+/** \brief Одно ядро расчёта используется несколькими потоками,
+ *   расчёт объёма не меняет состояние объекта */
+TEST_F(GostNGTest, KernelConcurrent) {
+  std::shared_ptr<const Gost30319Kernel> kernel = gost_->GetKernel();
+  ASSERT_NE(kernel, nullptr);
+  const std::vector<double> p = {1000000.0, 8000000.0, 15000000.0,
+                                 25000000.0};
+  const std::vector<double> t = {255.0, 280.0, 310.0, 345.0};
+  std::vector<double> expected;
+  for (double pi : p) {
+    for (double ti : t) {
+      ng_gost30319_state st;
+      ASSERT_EQ(kernel->Evaluate(pi, ti, 0.0, &st), ERROR_SUCCESS_T);
+      expected.push_back(st.volume);
+    }
+  }
+  const double v_keep = gost_->cgetVolume();
+  EXPECT_DOUBLE_EQ(gost_->cCalculateVolume(p[1], t[2]),
+                   expected[1 * t.size() + 2]);
+  EXPECT_DOUBLE_EQ(gost_->cgetVolume(), v_keep);
+
+  const size_t threads_count = 4;
+  std::vector<std::vector<double>> results(threads_count);
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < threads_count; ++i) {
+    threads.emplace_back([&kernel, &p, &t, &results, i]() {
+      std::vector<double>& result = results[i];
+      for (int loop = 0; loop < 50; ++loop) {
+        result.clear();
+        for (double pi : p) {
+          for (double ti : t) {
+            ng_gost30319_state st = ng_gost30319_state();
+            kernel->Evaluate(pi, ti, 0.0, &st);
+            result.push_back(st.volume);
+          }
+        }
+      }
+    });
+  }
+  for (auto& thread : threads)
+    thread.join();
+  for (const auto& result : results) {
+    ASSERT_EQ(result.size(), expected.size());
+    for (size_t i = 0; i < expected.size(); ++i)
+      EXPECT_DOUBLE_EQ(result[i], expected[i]);
+  }
+}
+
+/** \brief Смеси одинакового состава, в том числе с другим порядком
+ *   компонентов, разделяют один блок коэффициентов */
+TEST_F(GostNGTest, CoefsCache) {
+  ng_gost_mix reversed(mix_.rbegin(), mix_.rend());
+  ng_gost_mix other(mix_);
+  other[0].second -= 0.001;
+  other[1].second += 0.001;
+  gas_params_input gpi;
+  gpi.p = 5000000.0;
+  gpi.t = 300.0;
+  gpi.const_dyn.ng_gost_components = &reversed;
+  std::unique_ptr<GasParametersGost30319Dyn> iso(
+      GasParametersGost30319Dyn::Init(gpi, true));
+  gpi.const_dyn.ng_gost_components = &other;
+  std::unique_ptr<GasParametersGost30319Dyn> gost_other(
+      GasParametersGost30319Dyn::Init(gpi, false));
+  ASSERT_NE(iso, nullptr);
+  ASSERT_NE(gost_other, nullptr);
+  GasParameters_NG_Gost_dynProxy proxy(gost_.get());
+  EXPECT_EQ(proxy.coefs(), GasParameters_NG_Gost_dynProxy(iso.get()).coefs());
+  EXPECT_NE(proxy.coefs(),
+            GasParameters_NG_Gost_dynProxy(gost_other.get()).coefs());
+}
+
+/** \brief Обновление долей компонентов даёт тот же результат,
+ *   что и инициализация объекта с новым составом */
+TEST_F(GostNGTest, UpdateComponents) {
+  ng_gost_mix other(mix_.rbegin(), mix_.rend());
+  other.back().second -= 0.004;
+  other[0].second += 0.003;
+  other[1].second += 0.001;
+  gas_params_input gpi;
+  gpi.p = 5000000.0;
+  gpi.t = 300.0;
+  gpi.const_dyn.ng_gost_components = &other;
+  std::unique_ptr<GasParametersGost30319Dyn> fresh(
+      GasParametersGost30319Dyn::Init(gpi, false));
+  ASSERT_NE(fresh, nullptr);
+  // коэффициенты смеси mix_ могли быть взяты из кэша
+  ASSERT_EQ(gost_->UpdateComponents(other), ERROR_SUCCESS_T);
+  EXPECT_EQ(gost_->cGetStatus(), STATUS_OK);
+  GasParameters_NG_Gost_dynProxy proxy(gost_.get());
+  GasParameters_NG_Gost_dynProxy fresh_proxy(fresh.get());
+  const ng_gost30319_coefs* c = proxy.coefs();
+  const ng_gost30319_coefs* fc = fresh_proxy.coefs();
+  EXPECT_NEAR(c->kx, fc->kx, 1.0e-12 * fc->kx);
+  EXPECT_NEAR(c->V, fc->V, 1.0e-12 * fc->V);
+  EXPECT_NEAR(c->G, fc->G, 1.0e-12);
+  for (size_t n = 0; n < A0_3_coefs_count; ++n)
+    EXPECT_NEAR(c->Cn[n], fc->Cn[n], 1.0e-12 * std::abs(fc->Cn[n])) << n;
+  for (size_t n = 0; n < 18; ++n)
+    EXPECT_NEAR(c->Bn[n], fc->Bn[n], 1.0e-12 * std::abs(fc->Bn[n])) << n;
+  EXPECT_NEAR(gost_->cgetVolume(), fresh->cgetVolume(),
+              1.0e-5 * fresh->cgetVolume());
+  EXPECT_DOUBLE_EQ(gost_->cgetConstparameters().mp.mass,
+                   fresh->cgetConstparameters().mp.mass);
+  EXPECT_NEAR(gost_->GetPseudocritic().temperature,
+              fresh->cgetConstparameters().critical.temperature, 1.0e-9);
+
+  // другой набор компонентов
+  ng_gost_mix wrong(mix_);
+  wrong[1].first = CH(HELIUM);
+  const double v_keep = gost_->cgetVolume();
+  EXPECT_EQ(gost_->UpdateComponents(wrong), ERROR_INIT_T);
+  EXPECT_DOUBLE_EQ(gost_->cgetVolume(), v_keep);
+}
+
+/** \brief Удельный объём в арифметике dual: значение совпадает с
+ *   расчётом в double, производные по давлению, температуре и долям
+ *   компонентов - с центральными разностями */
+TEST_F(GostNGTest, DualVolume) {
+  std::shared_ptr<const Gost30319Kernel> kernel = gost_->GetKernel();
+  const ng_gost_mix& mix = kernel->GetComponents();
+  constexpr size_t count = 10, N = count + 2;
+  ASSERT_EQ(mix.size(), count);
+  const double p = 6000000.0, t = 290.0;
+  ng_gost30319_state ref;
+  ASSERT_EQ(kernel->Evaluate(p, t, 0.0, &ref), ERROR_SUCCESS_T);
+  basic_ng_gost30319_volume<double> st;
+  ASSERT_EQ(kernel->Evaluate(p, t, 0.0, &st), ERROR_SUCCESS_T);
+  EXPECT_EQ(st.volume, ref.volume);
+  EXPECT_EQ(st.sigma, ref.sigma);
+  EXPECT_EQ(st.z, ref.params.z);
+
+  std::vector<double> x(count);
+  std::vector<dual<N>> xd(count);
+  for (size_t i = 0; i < count; ++i) {
+    x[i] = mix[i].second;
+    xd[i] = dual<N>::Variable(x[i], i + 2);
+  }
+  basic_ng_gost30319_volume<dual<N>> vd;
+  ASSERT_EQ(kernel->Evaluate(dual<N>::Variable(p, 0), dual<N>::Variable(t, 1),
+                             xd.data(), 0.0, &vd),
+            ERROR_SUCCESS_T);
+  EXPECT_NEAR(value_of(vd.volume), ref.volume, 1.0e-12 * ref.volume);
+  // объём для давления, температуры и долей, смещённых на +-h по
+  //   переменной k
+  auto volume = [&kernel, &x, p, t](size_t k, double h) {
+    std::vector<double> xh(x);
+    if (k > 1)
+      xh[k - 2] += h;
+    basic_ng_gost30319_volume<double> s;
+    EXPECT_EQ(kernel->Evaluate(p + ((k == 0) ? h : 0.0),
+                               t + ((k == 1) ? h : 0.0), xh.data(), 0.0, &s),
+              ERROR_SUCCESS_T);
+    return s.volume;
+  };
+  const double h[] = {1.0e-4 * p, 1.0e-4 * t, 1.0e-5};
+  for (size_t k = 0; k < N; ++k) {
+    const double hk = h[std::min<size_t>(k, 2)];
+    const double fd = (volume(k, hk) - volume(k, -hk)) / (2.0 * hk);
+    EXPECT_NEAR(vd.volume.d[k], fd, 1.0e-6 * std::abs(fd)) << k;
+  }
+  // z = pv / (R_m t), R_m = 1000 R / M
+  EXPECT_NEAR(vd.z.d[0],
+              value_of(vd.z) * (1.0 / p + vd.volume.d[0] / ref.volume),
+              1.0e-9 * std::abs(vd.z.d[0]));
+  EXPECT_EQ(kernel->Evaluate(dual<N>(35000000.0), dual<N>(t), 0.0, &vd),
+            ERROR_CALCULATE_T);
+}
+
+/** \brief Расчёт по изотерме с общими для температуры слагаемыми
+ *   совпадает с расчётом отдельных точек */
+TEST_F(GostNGTest, EvaluateIsotherm) {
+  for (bool use_iso : {false, true}) {
+    gas_params_input gpi;
+    gpi.p = 5000000.0;
+    gpi.t = 300.0;
+    gpi.const_dyn.ng_gost_components = &mix_;
+    std::unique_ptr<GasParametersGost30319Dyn> gost(
+        GasParametersGost30319Dyn::Init(gpi, use_iso));
+    ASSERT_NE(gost, nullptr);
+    std::shared_ptr<const Gost30319Kernel> kernel = gost->GetKernel();
+    std::vector<double> p;
+    for (double pi = 200000.0; pi < 30000000.0; pi *= 1.5)
+      p.push_back(pi);
+    p.push_back(35000000.0);
+    std::vector<ng_gost30319_state> states(p.size());
+    EXPECT_EQ(kernel->EvaluateIsotherm(265.0, p.data(), p.size(),
+                                       states.data()),
+              ERROR_CALCULATE_T);
+    for (size_t i = 0; i + 1 < p.size(); ++i) {
+      ng_gost30319_state st;
+      ASSERT_EQ(kernel->Evaluate(p[i], 265.0, 0.0, &st), ERROR_SUCCESS_T);
+      const ng_gost30319_params& ps = states[i].params;
+      EXPECT_NEAR(states[i].volume, st.volume, 1.0e-5 * st.volume);
+      EXPECT_NEAR(ps.k, st.params.k, 1.0e-5 * st.params.k);
+      EXPECT_NEAR(ps.w, st.params.w, 1.0e-5 * st.params.w);
+      if (use_iso) {
+        EXPECT_NEAR(ps.h, st.params.h, 1.0e-5 * std::abs(st.params.h));
+        EXPECT_NEAR(ps.cp, st.params.cp, 1.0e-5 * st.params.cp);
+      }
+    }
+    EXPECT_DOUBLE_EQ(states.back().volume, 0.0);
+  }
+}
+
+/** \brief Расчёт блоками точек совпадает с поточечным с точностью
+ *   до округления, в том числе для неполного последнего блока и
+ *   точек вне границ применимости модели */
+TEST_F(GostNGTest, EvaluateBatch) {
+  for (bool use_iso : {false, true}) {
+    gas_params_input gpi;
+    gpi.p = 5000000.0;
+    gpi.t = 300.0;
+    gpi.const_dyn.ng_gost_components = &mix_;
+    std::unique_ptr<GasParametersGost30319Dyn> gost(
+        GasParametersGost30319Dyn::Init(gpi, use_iso));
+    ASSERT_NE(gost, nullptr);
+    std::shared_ptr<const Gost30319Kernel> kernel = gost->GetKernel();
+    std::vector<double> p, t;
+    for (int i = 0; i < 8 * 25 + 5; ++i) {
+      p.push_back(100000.0 * std::pow(300.0, (i % 37) / 36.0));
+      t.push_back(250.0 + 100.0 * (i % 23) / 22.0);
+    }
+    p[13] = 40000000.0;
+    t[42] = 200.0;
+    std::vector<ng_gost30319_state> states(p.size());
+    EXPECT_EQ(kernel->EvaluateBatch(p.data(), t.data(), p.size(),
+                                    states.data()),
+              ERROR_CALCULATE_T);
+    const double Rm = kernel->GetMolarParameters().Rm;
+    for (size_t i = 0; i < p.size(); ++i) {
+      ng_gost30319_state st;
+      if (kernel->Evaluate(p[i], t[i], 0.0, &st)) {
+        EXPECT_TRUE(i == 13 || i == 42) << i;
+        EXPECT_DOUBLE_EQ(states[i].volume, 0.0);
+        EXPECT_DOUBLE_EQ(states[i].params.z, 0.0);
+        continue;
+      }
+      const ng_gost30319_params& ps = states[i].params;
+      EXPECT_NEAR(states[i].sigma, st.sigma, 1.0e-10 * st.sigma) << i;
+      EXPECT_NEAR(states[i].volume, st.volume, 1.0e-10 * st.volume) << i;
+      EXPECT_NEAR(ps.z, st.params.z, 1.0e-10) << i;
+      EXPECT_NEAR(ps.k, st.params.k, 1.0e-10 * st.params.k) << i;
+      EXPECT_NEAR(ps.w, st.params.w, 1.0e-10 * st.params.w) << i;
+      EXPECT_NEAR(ps.cp0r, st.params.cp0r, 1.0e-10 * st.params.cp0r) << i;
+      if (use_iso) {
+        EXPECT_NEAR(ps.h, st.params.h, 1.0e-10 * Rm * t[i]) << i;
+        EXPECT_NEAR(ps.s, st.params.s, 1.0e-10 * Rm) << i;
+        EXPECT_NEAR(ps.cv, st.params.cv, 1.0e-10 * st.params.cv) << i;
+        EXPECT_NEAR(ps.cp, st.params.cp, 1.0e-10 * st.params.cp) << i;
+      } else {
+        EXPECT_NEAR(ps.A3, st.params.A3, 1.0e-10) << i;
+      }
+    }
+    // меньше одного блока
+    EXPECT_EQ(kernel->EvaluateBatch(p.data(), t.data(), 3, states.data()),
+              ERROR_SUCCESS_T);
+    EXPECT_EQ(kernel->EvaluateBatch(p.data(), t.data(), 0, states.data()),
+              ERROR_SUCCESS_T);
+  }
+}
+
+/** \brief Сравнение скорости расчёта блоками с поточечным,
+ *   запуск: --gtest_also_run_disabled_tests */
+TEST_F(GostNGTest, DISABLED_EvaluateBatchBenchmark) {
+  using namespace std::chrono;
+  for (bool use_iso : {false, true}) {
+    gas_params_input gpi;
+    gpi.p = 5000000.0;
+    gpi.t = 300.0;
+    gpi.const_dyn.ng_gost_components = &mix_;
+    std::unique_ptr<GasParametersGost30319Dyn> gost(
+        GasParametersGost30319Dyn::Init(gpi, use_iso));
+    ASSERT_NE(gost, nullptr);
+    std::shared_ptr<const Gost30319Kernel> kernel = gost->GetKernel();
+    const size_t count = 4096;
+    std::vector<double> p(count), t(count);
+    for (size_t i = 0; i < count; ++i) {
+      p[i] = 100000.0 + 29900000.0 * (i % 64) / 63.0;
+      t[i] = 250.0 + 100.0 * (i / 64) / 63.0;
+    }
+    std::vector<ng_gost30319_state> states(count);
+    double sum = 0.0;
+    auto start = steady_clock::now();
+    for (size_t i = 0; i < count; ++i) {
+      kernel->Evaluate(p[i], t[i], 0.0, &states[i]);
+      sum += states[i].params.z;
+    }
+    auto ref_time = duration_cast<nanoseconds>(steady_clock::now() - start);
+    start = steady_clock::now();
+    kernel->EvaluateBatch(p.data(), t.data(), count, states.data());
+    auto time = duration_cast<nanoseconds>(steady_clock::now() - start);
+    for (size_t i = 0; i < count; ++i)
+      sum -= states[i].params.z;
+    std::cout << (use_iso ? "ISO 20765" : "GOST 30319")
+              << "  Evaluate: " << ref_time.count() / count << "ns/point"
+              << "  EvaluateBatch: " << time.count() / count << "ns/point"
+              << "  speedup: " << double(ref_time.count()) / time.count()
+              << std::endl;
+    EXPECT_LT(time, ref_time);
+    EXPECT_NEAR(sum, 0.0, 1.0e-6);
+  }
+}
+
+/** \brief Интерполяция по таблице параметров смеси совпадает с
+ *   точным расчётом с заданной точностью */
+TEST_F(GostNGTest, Table) {
+  for (bool use_iso : {false, true}) {
+    gas_params_input gpi;
+    gpi.p = 5000000.0;
+    gpi.t = 300.0;
+    gpi.const_dyn.ng_gost_components = &mix_;
+    std::unique_ptr<GasParametersGost30319Dyn> gost(
+        GasParametersGost30319Dyn::Init(gpi, use_iso));
+    ASSERT_NE(gost, nullptr);
+    std::shared_ptr<const Gost30319Kernel> kernel = gost->GetKernel();
+    const double tolerance = 1.0e-4;
+    std::unique_ptr<Gost30319Table> table(
+        Gost30319Table::Init(kernel, tolerance));
+    ASSERT_NE(table, nullptr);
+    EXPECT_LE(table->GetMaxError(), tolerance);
+
+    ng_gost30319_table_value v;
+    ng_gost30319_state st;
+    const double Rm = kernel->GetMolarParameters().Rm;
+    for (int i = 0; i < 200; ++i) {
+      const double p = 100000.0 * std::pow(300.0, (i % 37) / 36.0);
+      const double t = 250.0 + 100.0 * (i % 23) / 22.0;
+      ASSERT_EQ(table->Get(p, t, &v), ERROR_SUCCESS_T);
+      ASSERT_EQ(kernel->Evaluate(p, t, 0.0, &st), ERROR_SUCCESS_T);
+      EXPECT_NEAR(v.z, st.params.z, 2.0 * tolerance * st.params.z);
+      EXPECT_NEAR(v.volume, st.volume, 1.0e-4 * st.volume);
+      EXPECT_NEAR(v.k, st.params.k, 2.0 * tolerance * st.params.k);
+      EXPECT_NEAR(v.w, st.params.w, 2.0 * tolerance * st.params.w);
+      if (use_iso) {
+        EXPECT_NEAR(v.h, st.params.h,
+                    2.0 * tolerance * std::max(std::abs(st.params.h), Rm * t));
+        EXPECT_NEAR(v.s, st.params.s,
+                    2.0 * tolerance * std::max(std::abs(st.params.s), Rm));
+      }
+    }
+    EXPECT_EQ(table->Get(40000000.0, 300.0, &v), ERROR_CALCULATE_T);
+    EXPECT_EQ(table->Get(5000000.0, 200.0, &v), ERROR_CALCULATE_T);
+  }
+}
+
+/** \brief Поиск коэффициентов компонентов и их бинарного
+ *   взаимодействия по таблицам ГОСТ 30319.3 */
+TEST(gost_ng_defines, Lookup) {
+  const component_characteristics* methane =
+      get_characteristics(CH(METHANE));
+  ASSERT_NE(methane, nullptr);
+  EXPECT_EQ(methane->gas_name, CH(METHANE));
+  EXPECT_DOUBLE_EQ(methane->M, 16.043);
+  EXPECT_EQ(get_characteristics(CH(UNDEFINED)), nullptr);
+  EXPECT_EQ(get_characteristics(CH(ALL_BUTANES)), nullptr);
+  EXPECT_EQ(get_characteristics(0x0100 | CH(N_PENTANE)), nullptr);
+  EXPECT_EQ(get_A4_coefs(CH(HYDROGEN))->gas_name, CH(HYDROGEN));
+  EXPECT_EQ(get_critical_params(CH(NITROGEN))->gas_name, CH(NITROGEN));
+
+  // коэффициенты симметричны
+  const binary_associate_coef* mp =
+      get_binary_associate_coefs(CH(METHANE), CH(PROPANE));
+  EXPECT_EQ(mp, get_binary_associate_coefs(CH(PROPANE), CH(METHANE)));
+  EXPECT_DOUBLE_EQ(mp->E, 0.994635);
+  const binary_associate_coef* mc =
+      get_binary_associate_coefs(CH(CARBON_DIOXIDE), CH(METHANE));
+  EXPECT_DOUBLE_EQ(mc->G, 0.807653);
+  // для пар без данных - единичные коэффициенты
+  const binary_associate_coef* def =
+      get_binary_associate_coefs(CH(METHANE), CH(ETHANE));
+  EXPECT_EQ(def->i, CH(UNDEFINED));
+  EXPECT_EQ(def, get_binary_associate_coefs(CH(METHANE), CH(ALL_BUTANES)));
+  EXPECT_EQ(def, get_binary_associate_coefs(CH(METHANE), CH(METHANE)));
+}
+
+/** \brief Расчёт Bn по парам компонентов совпадает с прямым расчётом */
+TEST_F(GostNGTest, SetBn) {
+  GasParameters_NG_Gost_dynProxy proxy(gost_.get());
+  for (size_t count : {1, 10, 21, 32}) {
+    ng_gost_mix mix = make_mix(count);
+    std::vector<double> ref = reference_Bn(mix);
+    std::vector<double> Bn = proxy.set_Bn(mix);
+    ASSERT_EQ(Bn.size(), ref.size());
+    // Bn для n >= 18 в расчётах не используются
+    for (size_t n = 0; n < 18; ++n)
+      EXPECT_NEAR(Bn[n], ref[n], 1.0e-12 * std::abs(ref[n])) << n;
+  }
+}
+
+/** \brief Сравнение скорости расчёта Bn с прямым расчётом,
+ *   запуск: --gtest_also_run_disabled_tests */
+TEST_F(GostNGTest, DISABLED_SetBnBenchmark) {
+  using namespace std::chrono;
+  GasParameters_NG_Gost_dynProxy proxy(gost_.get());
+  const int loops = 200;
+  for (size_t count : {10, 21, 32}) {
+    ng_gost_mix mix = make_mix(count);
+    double sum = 0.0;
+    auto start = steady_clock::now();
+    for (int i = 0; i < loops; ++i)
+      sum += reference_Bn(mix)[0];
+    auto ref_time = duration_cast<microseconds>(steady_clock::now() - start);
+    start = steady_clock::now();
+    for (int i = 0; i < loops; ++i)
+      sum -= proxy.set_Bn(mix)[0];
+    auto time = duration_cast<microseconds>(steady_clock::now() - start);
+    std::cout << "components: " << count
+              << "  reference: " << ref_time.count() / loops << "us"
+              << "  set_Bn: " << time.count() / loops << "us"
+              << "  speedup: " << double(ref_time.count()) / time.count()
+              << std::endl;
+    EXPECT_LT(time, ref_time);
+    EXPECT_NEAR(sum, 0.0, 1.0e-6);
+  }
+}
@@ -14,3 +14,47 @@ target_include_directories(test_models
 target_link_libraries(test_models asp_utils ${FULLTEST_LIBRARIES})
 
 add_test(test_models "core/test_models")
+
+include(${ASP_THERM_CMAKE_ROOT}/models_src.cmake)
+set_models_src(MODELS_CALORIC_TEST_SRC)
+add_executable(test_models_caloric
+  ${MODELS_CALORIC_TEST_SRC}
+
+  ${ASP_THERM_FULLTEST_DIR}/core/models/test_models_caloric.cpp)
+
+target_compile_definitions(test_models_caloric
+  PRIVATE -DBYCMAKE_DEBUG -DTESTING_PROJECT -DISO_20765
+  ${INCLUDE_ERRORCODES})
+target_compile_options(test_models_caloric
+  PRIVATE -fprofile-arcs -ftest-coverage)
+target_include_directories(test_models_caloric
+  PRIVATE ${TESTS_INCLUDE_DIRS}
+  PRIVATE ${MODULES_DIR}/asp_db/source)
+target_link_libraries(test_models_caloric
+  pugixml
+  asp_utils
+  asp_db
+  ${FULLTEST_LIBRARIES})
+
+add_test(test_models_caloric "core/test_models_caloric")
+
+set_models_src(MODELS_MIXTURE_TEST_SRC)
+add_executable(test_models_mixture
+  ${MODELS_MIXTURE_TEST_SRC}
+
+  ${ASP_THERM_FULLTEST_DIR}/core/models/test_models_mixture.cpp)
+
+target_compile_definitions(test_models_mixture
+  PRIVATE -DBYCMAKE_DEBUG -DTESTING_PROJECT ${INCLUDE_ERRORCODES})
+target_compile_options(test_models_mixture
+  PRIVATE -fprofile-arcs -ftest-coverage)
+target_include_directories(test_models_mixture
+  PRIVATE ${TESTS_INCLUDE_DIRS}
+  PRIVATE ${MODULES_DIR}/asp_db/source)
+target_link_libraries(test_models_mixture
+  pugixml
+  asp_utils
+  asp_db
+  ${FULLTEST_LIBRARIES})
+
+add_test(test_models_mixture "core/test_models_mixture")
@@ -1,9 +1,13 @@
 #include "calculation_info.h"
 #include "atherm_common.h"
+#include "dual_number.h"
+#include "model_cubic_eos.h"
 
 #include "gtest/gtest.h"
 
+#include <cmath>
 #include <ctime>
+#include <vector>
 
 
 TEST(calculation_info, DateTimeByString) {
@@ -80,3 +84,332 @@ int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
 }
+
+
+TEST(mixing_vdw, QuadraticFormAndCache) {
+  const double x[] = {0.85, 0.1, 0.05},
+               a[] = {0.24, 0.55, 0.9},
+               b[] = {0.0017, 0.0025, 0.003},
+               k[3][3] = {{0.0, 0.02, 0.035},
+                          {0.02, 0.0, 0.01},
+                          {0.035, 0.01, 0.0}};
+  const alpha_soave al[] = {{0.45, 190.6}, {0.6, 305.3}, {0.75, 369.8}};
+  mixing_vdw<alpha_soave> mix;
+  for (size_t i = 0; i < 3; ++i)
+    mix.AddComponent(x[i], a[i], b[i], al[i]);
+  for (size_t i = 0; i < 3; ++i)
+    for (size_t j = i + 1; j < 3; ++j)
+      mix.SetBinaryCoef(i, j, k[i][j]);
+  EXPECT_EQ(mix.Size(), 3);
+  EXPECT_NEAR(mix.B(), 0.85 * 0.0017 + 0.1 * 0.0025 + 0.05 * 0.003, 1e-15);
+
+  /* naive double sum */
+  for (double t = 200.0; t < 400.0; t += 20.0) {
+    double an = 0.0;
+    for (size_t i = 0; i < 3; ++i)
+      for (size_t j = 0; j < 3; ++j)
+        an += x[i] * x[j] * (1.0 - k[i][j]) *
+              std::sqrt(a[i] * al[i](t) * a[j] * al[j](t));
+    EXPECT_NEAR(mix.A(t), an, 1e-12 * an);
+    /* cached value */
+    EXPECT_EQ(mix.A(t), mix.A(t));
+  }
+  /* change of k_ij drops the cache */
+  const double a_prev = mix.A(300.0);
+  mix.SetBinaryCoef(0, 1, 0.0);
+  EXPECT_GT(mix.A(300.0), a_prev);
+}
+
+TEST(mixing_vdw, TemperatureDerivatives) {
+  mixing_vdw<alpha_soave> mix;
+  mix.AddComponent(0.8, 0.24, 0.0017, {0.45, 190.6});
+  mix.AddComponent(0.2, 0.55, 0.0025, {0.6, 305.3});
+  mix.SetBinaryCoef(0, 1, 0.005);
+  const double h = 1e-3;
+  for (double t = 150.0; t < 450.0; t += 50.0) {
+    double a_t, a_tt;
+    const double a = mix.A(t, &a_t, &a_tt);
+    EXPECT_NEAR(a, mix.A(t), 1e-14 * a);
+    const double ap = mix.A(t + h), am = mix.A(t - h);
+    EXPECT_NEAR(a_t, (ap - am) / (2.0 * h), 1e-6 * std::abs(a_t));
+    EXPECT_NEAR(a_tt, (ap - 2.0 * a + am) / (h * h), 1e-3 * std::abs(a_tt));
+  }
+  /* pure gas: the same alpha(T) */
+  mixing_pure<alpha_soave> pure = {0.24, 0.0017, {0.45, 190.6}};
+  mixing_vdw<alpha_soave> one;
+  one.AddComponent(1.0, 0.24, 0.0017, {0.45, 190.6});
+  double a_t1, a_tt1, a_t2, a_tt2;
+  EXPECT_NEAR(pure.A(250.0, &a_t1, &a_tt1), one.A(250.0, &a_t2, &a_tt2),
+              1e-15);
+  EXPECT_NEAR(a_t1, a_t2, 1e-15);
+  EXPECT_NEAR(a_tt1, a_tt2, 1e-15);
+}
+
+TEST(CubicEOS, VolumePressureRoundtrip) {
+  typedef CubicEOS<peng_robinson_traits, mixing_pure<alpha_soave>> pr_t;
+  /* methane: R, a = 0.45724 * R^2 * Tc^2 / Pc, b = 0.0778 * R * Tc / Pc */
+  const double R = 518.3, tc = 190.6, pc = 4.6e6,
+               w = 0.011, m = 0.37464 + 1.54226 * w - 0.26992 * w * w;
+  pr_t eos(R, {0.45724 * R * R * tc * tc / pc, 0.0778 * R * tc / pc,
+               {m, tc}});
+  const double p[] = {1.0e5, 1.0e6, 5.0e6, 1.0e7, 2.0e7},
+               t[] = {250.0, 250.0, 300.0, 300.0, 300.0};
+  double v[5];
+  EXPECT_EQ(eos.VolumeBatch(p, t, 5, v), ERROR_SUCCESS_T);
+  for (size_t i = 0; i < 5; ++i) {
+    EXPECT_NEAR(v[i], eos.Volume(p[i], t[i]), 1e-12 * v[i]);
+    EXPECT_NEAR(eos.Pressure(v[i], t[i]), p[i], 1e-9 * p[i]);
+  }
+  EXPECT_EQ(eos.VolumeBatch(nullptr, t, 5, v), ERROR_INIT_NULLP_ST);
+}
+
+/* blocks of ATHERM_LANES points with a partial last block: gas,
+ *   liquid and three-root points below Tc, and points outside the
+ *   domain of the equation, compared with the pointwise Volume */
+TEST(CubicEOS, VolumeBatchLanes) {
+  typedef CubicEOS<redlich_kwong_traits, mixing_vdw<alpha_soave>> srk_t;
+  mixing_vdw<alpha_soave> mix;
+  mix.AddComponent(0.9, 0.24, 0.0017, {0.65, 190.6});
+  mix.AddComponent(0.1, 0.55, 0.0025, {0.8, 305.3});
+  mix.SetBinaryCoef(0, 1, 0.02);
+  srk_t eos(500.0, mix);
+  std::vector<double> p, t;
+  for (double tt = 120.0; tt < 360.0; tt += 20.0)
+    for (double pp = 5.0e4; pp < 3.0e7; pp *= 2.2) {
+      p.push_back(pp);
+      t.push_back(tt);
+    }
+  p.resize(3 * ATHERM_LANES + 5, 1.0e6);
+  t.resize(p.size(), 300.0);
+  p[3] = -1.0e5;
+  t[ATHERM_LANES + 1] = 0.0;
+  std::vector<double> v(p.size(), -1.0);
+  EXPECT_EQ(eos.VolumeBatch(p.data(), t.data(), p.size(), v.data()),
+            ERROR_CALC_MODEL_ST);
+  for (size_t i = 0; i < p.size(); ++i) {
+    if (i == 3 || i == ATHERM_LANES + 1) {
+      EXPECT_EQ(v[i], 0.0);
+      continue;
+    }
+    EXPECT_NEAR(v[i], eos.Volume(p[i], t[i]), 1e-12 * v[i]) << i;
+  }
+  /* less than one block */
+  EXPECT_EQ(eos.VolumeBatch(p.data() + 4, t.data() + 4, 3, v.data()),
+            ERROR_SUCCESS_T);
+  EXPECT_NEAR(v[0], eos.Volume(p[4], t[4]), 1e-12 * v[0]);
+  EXPECT_EQ(eos.VolumeBatch(p.data(), t.data(), 0, v.data()),
+            ERROR_SUCCESS_T);
+}
+
+TEST(CubicEOS, PressureDerivatives) {
+  typedef CubicEOS<redlich_kwong_traits, mixing_vdw<alpha_soave>> srk_t;
+  mixing_vdw<alpha_soave> mix;
+  mix.AddComponent(0.9, 0.24, 0.0017, {0.65, 190.6});
+  mix.AddComponent(0.1, 0.55, 0.0025, {0.8, 305.3});
+  mix.SetBinaryCoef(0, 1, 0.02);
+  srk_t eos(500.0, mix);
+  const double v[] = {0.005, 0.02, 0.1, 0.5},
+               t[] = {250.0, 250.0, 300.0, 350.0};
+  double p[4], dp_dv[4], dp_dt[4], d2p_dt2[4];
+  EXPECT_EQ(eos.DerivativesBatch(v, t, 4, {p, dp_dv, dp_dt, d2p_dt2}),
+            ERROR_SUCCESS_T);
+  for (size_t i = 0; i < 4; ++i) {
+    const double hv = 1e-6 * v[i], ht = 1e-2;
+    cubic_eos_derivatives d = eos.Derivatives(v[i], t[i]);
+    EXPECT_EQ(d.p, p[i]);
+    EXPECT_EQ(d.dp_dv, dp_dv[i]);
+    EXPECT_EQ(d.dp_dt, dp_dt[i]);
+    EXPECT_EQ(d.d2p_dt2, d2p_dt2[i]);
+    EXPECT_NEAR(d.p, eos.Pressure(v[i], t[i]), 1e-12 * std::abs(d.p));
+    EXPECT_NEAR(d.dp_dv,
+                (eos.Pressure(v[i] + hv, t[i]) -
+                 eos.Pressure(v[i] - hv, t[i])) / (2.0 * hv),
+                1e-6 * std::abs(d.dp_dv));
+    EXPECT_NEAR(d.dp_dt,
+                (eos.Pressure(v[i], t[i] + ht) -
+                 eos.Pressure(v[i], t[i] - ht)) / (2.0 * ht),
+                1e-6 * std::abs(d.dp_dt));
+    EXPECT_NEAR(d.d2p_dt2,
+                (eos.Derivatives(v[i], t[i] + ht).dp_dt -
+                 eos.Derivatives(v[i], t[i] - ht).dp_dt) / (2.0 * ht),
+                1e-6 * std::abs(d.d2p_dt2));
+  }
+  /* v <= b */
+  const double vb[] = {0.001};
+  EXPECT_EQ(eos.DerivativesBatch(vb, t, 1, {p, nullptr, nullptr, nullptr}),
+            ERROR_CALC_MODEL_ST);
+  EXPECT_EQ(p[0], 0.0);
+}
+
+TEST(CubicEOS, DepartureFunctions) {
+  typedef CubicEOS<peng_robinson_traits, mixing_pure<alpha_soave>> pr_t;
+  const double R = 518.3, tc = 190.6, pc = 4.6e6,
+               w = 0.011, m = 0.37464 + 1.54226 * w - 0.26992 * w * w;
+  pr_t eos(R, {0.45724 * R * R * tc * tc / pc, 0.0778 * R * tc / pc,
+               {m, tc}});
+  const double ht = 1e-3;
+  for (double p = 1e6; p < 2e7; p += 4e6) {
+    for (double t = 250.0; t < 400.0; t += 50.0) {
+      const cubic_eos_departure d = eos.Departure(p, t),
+                                dp = eos.Departure(p, t + ht),
+                                dm = eos.Departure(p, t - ht);
+      EXPECT_NEAR(d.volume, eos.Volume(p, t), 1e-15);
+      /* (dh/dT)_p = cp, (ds/dT)_p = cp / T, для идеального газа тоже */
+      EXPECT_NEAR(d.heat_cap_pres, (dp.enthalpy - dm.enthalpy) / (2.0 * ht),
+                  1e-5 * R);
+      EXPECT_NEAR(d.heat_cap_pres,
+                  t * (dp.entropy - dm.entropy) / (2.0 * ht), 1e-5 * R);
+    }
+  }
+  /* разреженный газ */
+  const cubic_eos_departure d = eos.Departure(1.0, 300.0);
+  EXPECT_NEAR(d.enthalpy, 0.0, 1e-6 * R * 300.0);
+  EXPECT_NEAR(d.entropy, 0.0, 1e-6 * R);
+
+  /* below Tc the root with the lower Gibbs energy is taken: gas below
+   *   the saturation pressure, liquid above it, and g = h - T*s is
+   *   continuous where the root switches, (dg/dp)_T = v - R*T/p */
+  const double ts = 150.0, dp = 1.0e3;
+  EXPECT_EQ(eos.Departure(0.9e6, ts).volume, eos.Volume(0.9e6, ts));
+  EXPECT_EQ(eos.Departure(1.2e6, ts).volume, eos.Volume(1.2e6, ts));
+  EXPECT_LT(eos.Departure(1.2e6, ts).volume,
+            0.1 * eos.Volume(0.9e6, ts));
+  int switches = 0;
+  cubic_eos_departure prev = eos.Departure(0.9e6, ts);
+  for (double p = 0.9e6 + dp; p < 1.2e6; p += dp) {
+    const cubic_eos_departure cur = eos.Departure(p, ts);
+    if (cur.volume < 0.5 * prev.volume) {
+      ++switches;
+      const double dg = (cur.enthalpy - ts * cur.entropy)
+                        - (prev.enthalpy - ts * prev.entropy);
+      EXPECT_LT(std::abs(dg), (R * ts / p - cur.volume) * dp) << p;
+    }
+    prev = cur;
+  }
+  EXPECT_EQ(switches, 1);
+}
+
+/** \brief В области трёх корней Volume, VolumeBatch и Departure
+  *   выбирают один и тот же корень с наименьшей энергией Гиббса */
+TEST(CubicEOS, VolumeRootSelection) {
+  typedef CubicEOS<peng_robinson_traits, mixing_pure<alpha_soave>> pr_t;
+  const double R = 518.3, tc = 190.6, pc = 4.6e6,
+               w = 0.011, m = 0.37464 + 1.54226 * w - 0.26992 * w * w;
+  pr_t eos(R, {0.45724 * R * R * tc * tc / pc, 0.0778 * R * tc / pc,
+               {m, tc}});
+  /* methane isotherms below Tc: metastable vapour roots exist above the
+   *   saturation pressure, the liquid root is taken there */
+  std::vector<double> p, t;
+  for (double ti : {130.0, 150.0, 170.0}) {
+    for (double pi = 0.2e6; pi < 3.0e6; pi += 0.05e6) {
+      p.push_back(pi);
+      t.push_back(ti);
+    }
+  }
+  std::vector<double> v(p.size());
+  EXPECT_EQ(eos.VolumeBatch(p.data(), t.data(), p.size(), v.data()),
+            ERROR_SUCCESS_T);
+  int switches = 0;
+  for (size_t i = 0; i < p.size(); ++i) {
+    const double vs = eos.Volume(p[i], t[i]);
+    EXPECT_NEAR(v[i], vs, 1e-12 * vs) << p[i] << " " << t[i];
+    EXPECT_EQ(eos.Departure(p[i], t[i]).volume, vs);
+    if (i > 0 && t[i] == t[i - 1] && vs < 0.5 * eos.Volume(p[i - 1], t[i]))
+      ++switches;
+  }
+  EXPECT_EQ(switches, 3);
+  const double vl = eos.Volume(1.2e6, 150.0);
+  EXPECT_LT(vl, 0.005);
+  EXPECT_LT(eos.Volume(1.5e6, 150.0), vl);
+  EXPECT_NEAR(eos.Pressure(vl, 150.0), 1.2e6, 1e-6 * 1.2e6);
+}
+
+/** \brief Производные v(p, T) и P(v, T, x) в арифметике dual<N>
+  *   против аналитических производных и конечных разностей */
+TEST(CubicEOS, DualNumberDerivatives) {
+  typedef CubicEOS<peng_robinson_traits, mixing_vdw<alpha_soave>> pr_t;
+  mixing_vdw<alpha_soave> mix;
+  mix.AddComponent(0.9, 0.24, 0.0017, {0.45, 190.6});
+  mix.AddComponent(0.1, 0.55, 0.0025, {0.6, 305.3});
+  mix.SetBinaryCoef(0, 1, 0.02);
+  pr_t eos(500.0, mix);
+  for (double p = 1e6; p < 2e7; p += 4e6) {
+    for (double t = 250.0; t < 400.0; t += 50.0) {
+      const dual<2> v = eos.Volume(dual<2>::Variable(p, 0),
+                                   dual<2>::Variable(t, 1));
+      const double vd = eos.Volume(p, t);
+      const cubic_eos_derivatives d = eos.Derivatives(vd, t);
+      EXPECT_NEAR(value_of(v), vd, 1e-14 * vd);
+      /* (dv/dp)_T = 1 / (dP/dv)_T, (dv/dT)_p = -(dP/dT)_v / (dP/dv)_T */
+      EXPECT_NEAR(v.d[0], 1.0 / d.dp_dv, 1e-10 * std::abs(v.d[0]));
+      EXPECT_NEAR(v.d[1], -d.dp_dt / d.dp_dv, 1e-10 * std::abs(v.d[1]));
+      const dual<1> pt = eos.Pressure(dual<1>(vd), dual<1>::Variable(t, 0));
+      EXPECT_NEAR(value_of(pt), d.p, 1e-12 * d.p);
+      EXPECT_NEAR(pt.d[0], d.dp_dt, 1e-12 * std::abs(d.dp_dt));
+    }
+  }
+  /* производные по долям компонентов */
+  const double v = 0.01, t = 300.0, h = 1e-6;
+  const dual<3> x[] = {dual<3>::Variable(0.9, 0), dual<3>::Variable(0.1, 1)};
+  const dual<3> pd = eos.Pressure(dual<3>(v), dual<3>::Variable(t, 2), x);
+  EXPECT_NEAR(value_of(pd), eos.Pressure(v, t), 1e-12 * value_of(pd));
+  for (size_t i = 0; i < 2; ++i) {
+    double xp[] = {0.9, 0.1}, xm[] = {0.9, 0.1};
+    xp[i] += h;
+    xm[i] -= h;
+    const double fd = (eos.Pressure(v, t, xp) - eos.Pressure(v, t, xm))
+                      / (2.0 * h);
+    EXPECT_NEAR(pd.d[i], fd, 1e-6 * std::abs(fd));
+  }
+  const dual<3> vx = eos.Volume(dual<3>(5e6), dual<3>(t), x);
+  EXPECT_NEAR(value_of(vx), eos.Volume(5e6, t), 1e-14);
+  EXPECT_NEAR(value_of(eos.Pressure(vx, dual<3>(t), x)), 5e6, 1e-6);
+}
+
+/** \brief Derivatives, Departure и изотермические интегралы в арифметике
+  *   dual<N> против аналитических производных в double */
+TEST(CubicEOS, DualNumberCaloric) {
+  typedef CubicEOS<peng_robinson_traits, mixing_vdw<alpha_soave>> pr_t;
+  mixing_vdw<alpha_soave> mix;
+  mix.AddComponent(0.9, 0.24, 0.0017, {0.45, 190.6});
+  mix.AddComponent(0.1, 0.55, 0.0025, {0.6, 305.3});
+  mix.SetBinaryCoef(0, 1, 0.02);
+  const double R = 500.0;
+  pr_t eos(R, mix);
+  for (double p = 1e6; p < 2e7; p += 4e6) {
+    for (double t = 250.0; t < 400.0; t += 50.0) {
+      const cubic_eos_departure d = eos.Departure(p, t);
+      const basic_cubic_eos_departure<dual<2>> dd =
+          eos.Departure(dual<2>::Variable(p, 0), dual<2>::Variable(t, 1));
+      EXPECT_EQ(value_of(dd.volume), d.volume);
+      EXPECT_NEAR(value_of(dd.enthalpy), d.enthalpy, 1e-10 * R * t);
+      EXPECT_NEAR(value_of(dd.entropy), d.entropy, 1e-10 * R);
+      EXPECT_NEAR(value_of(dd.heat_cap_pres), d.heat_cap_pres, 1e-10 * R);
+      /* (dh/dT)_p = cp, (ds/dT)_p = cp / T, (dh/dp)_T = v - T*(dv/dT)_p,
+       *   the ideal gas parts cancel */
+      EXPECT_NEAR(dd.enthalpy.d[1], d.heat_cap_pres, 1e-8 * R);
+      EXPECT_NEAR(t * dd.entropy.d[1], d.heat_cap_pres, 1e-8 * R);
+      EXPECT_NEAR(dd.enthalpy.d[0], d.volume - t * dd.volume.d[1],
+                  1e-8 * d.volume);
+      const dual<2> v = eos.Volume(dual<2>::Variable(p, 0),
+                                   dual<2>::Variable(t, 1));
+      EXPECT_NEAR(dd.volume.d[0], v.d[0], 1e-10 * std::abs(v.d[0]));
+      EXPECT_NEAR(dd.volume.d[1], v.d[1], 1e-10 * std::abs(v.d[1]));
+
+      const dual<1> td = dual<1>::Variable(t, 0);
+      const cubic_eos_derivatives pd = eos.Derivatives(d.volume, t);
+      const basic_cubic_eos_derivatives<dual<1>> pdd =
+          eos.Derivatives(dual<1>(d.volume), td);
+      EXPECT_NEAR(value_of(pdd.dp_dv), pd.dp_dv, 1e-12 * std::abs(pd.dp_dv));
+      EXPECT_NEAR(pdd.p.d[0], pd.dp_dt, 1e-12 * std::abs(pd.dp_dt));
+      EXPECT_NEAR(pdd.dp_dt.d[0], pd.d2p_dt2, 1e-12 * std::abs(pd.d2p_dt2));
+      /* d(u - u0)/dT = cv - cv0 on fixed volumes */
+      dual<1> a_t, a_tt;
+      const dual<1> a = eos.A(td, &a_t, &a_tt);
+      const dual<1> v0(0.5), v1(d.volume);
+      const dual<1> du = eos.InternalEnergyIntegral(v0, v1, td, a, a_t),
+                    dcv = eos.HeatCapVolIntegral(v0, v1, td, a_tt);
+      EXPECT_NEAR(du.d[0], value_of(dcv), 1e-10 * R);
+    }
+  }
+}
@@ -0,0 +1,385 @@
+#include "model_general.h"
+
+#include "atherm_common.h"
+#include "gas_description.h"
+#include "model_ideal_gas.h"
+#include "model_ng_gost.h"
+#include "model_peng_robinson.h"
+#include "model_redlich_kwong_soave.h"
+#include "phase_diagram.h"
+
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <memory>
+#include <vector>
+
+
+/** \brief Модель, считающая вызовы GetCaloric вложенной модели */
+class CountingModel final: public modelGeneral {
+public:
+  explicit CountingModel(modelGeneral* m)
+      : modelGeneral(*m->GetModelConfig(), 0, nullptr), m_(m) {}
+
+  merror_t GetCaloric(double p, double t, caloric_point* cal) override {
+    ++calls;
+    return m_->GetCaloric(p, t, cal);
+  }
+  void update_dyn_params(dyn_parameters&, const parameters) override {}
+  void update_dyn_params(dyn_parameters&, const parameters,
+                         const const_parameters&) override {}
+  model_str GetModelShortInfo() const override {
+    return m_->GetModelShortInfo();
+  }
+  bool IsValid() const override { return true; }
+  bool IsValid(parameters) const override { return true; }
+  void DynamicflowAccept(DerivateFunctor&) override {}
+  void SetVolume(double, double) override {}
+  void SetPressure(double, double) override {}
+  double GetVolume(double p, double t) override {
+    return m_->GetVolume(p, t);
+  }
+  double GetPressure(double v, double t) override {
+    return m_->GetPressure(v, t);
+  }
+
+public:
+  int calls = 0;
+
+private:
+  modelGeneral* m_;
+};
+
+/** \brief Обратные расчёты T(p, h), T(p, s) моделей метана */
+class CaloricModelsTest: public ::testing::Test {
+protected:
+  CaloricModelsTest()
+      : gost_mix({{CH(METHANE), 0.965},
+                  {CH(ETHANE), 0.018},
+                  {CH(PROPANE), 0.0045},
+                  {CH(N_BUTANE), 0.001},
+                  {CH(ISO_BUTANE), 0.001},
+                  {CH(N_PENTANE), 0.0003},
+                  {CH(ISO_PENTANE), 0.0005},
+                  {CH(HEXANE), 0.0007},
+                  {CH(NITROGEN), 0.003},
+                  {CH(CARBON_DIOXIDE), 0.006}}) {
+    cp.reset(const_parameters::Init(GAS_TYPE_METHANE, 0.0062, 4.599e6,
+        190.56, 0.286, 16.04, 0.011));
+    dp.reset(dyn_parameters::Init(DYNAMIC_HEAT_CAP_VOL |
+        DYNAMIC_HEAT_CAP_PRES | DYNAMIC_INTERNAL_ENERGY, 1700.0, 2200.0,
+        0.0, {0.149, 1.0e6, 300.0}));
+  }
+
+  /** \brief Модель чистого газа в начальном состоянии (p, t) */
+  template <class Model>
+  std::unique_ptr<modelGeneral> init_model(rg_model_id mn,
+                                           double p,
+                                           double t) {
+    gas_marks_t gm = (uint32_t)mn.type | ((uint32_t)mn.type
+        << BINODAL_MODEL_SHIFT);
+    const_dyn_union cd;
+    cd.cdp.cgp = cp.get();
+    cd.cdp.dgp = dp.get();
+    model_input mi(gm, nullptr, {p, t, cd}, Model::GetModelShortInfo(mn));
+    return std::unique_ptr<modelGeneral>(Model::Init(mi));
+  }
+
+  /** \brief Модель ГОСТ 30319.1 или ISO 20765 для смеси gost_mix */
+  std::unique_ptr<modelGeneral> init_gost(bool is_iso, double p, double t) {
+    const rg_model_id mn(rg_model_t::NG_GOST,
+                         is_iso ? MODEL_GOST_SUBTYPE_ISO_20765
+                                : MODEL_SUBTYPE_DEFAULT);
+    gas_marks_t gm = (uint32_t)mn.type | ((uint32_t)mn.type
+        << BINODAL_MODEL_SHIFT);
+    AddGostModelMark(&gm);
+    if (is_iso)
+      AddGostISO20765Mark(&gm);
+    const_dyn_union cd;
+    cd.ng_gost_components = &gost_mix;
+    model_input mi(gm, nullptr, {p, t, cd}, NG_Gost::GetModelShortInfo(mn));
+    return std::unique_ptr<modelGeneral>(NG_Gost::Init(mi));
+  }
+  /** \brief Модели с расчётом энтальпии и энтропии */
+  std::vector<std::unique_ptr<modelGeneral>> caloric_models(double p,
+                                                            double t) {
+    std::vector<std::unique_ptr<modelGeneral>> models;
+    models.push_back(init_model<Ideal_Gas>(ig, p, t));
+    models.push_back(init_model<Peng_Robinson>(pr, p, t));
+    models.push_back(init_model<Redlich_Kwong_Soave>(srk, p, t));
+    models.push_back(init_gost(true, p, t));
+    return models;
+  }
+
+protected:
+  ng_gost_mix gost_mix;
+  std::unique_ptr<const_parameters> cp;
+  std::unique_ptr<dyn_parameters> dp;
+  const rg_model_id ig = rg_model_id(rg_model_t::IDEAL_GAS,
+                                     MODEL_SUBTYPE_DEFAULT),
+                    pr = rg_model_id(rg_model_t::PENG_ROBINSON,
+                                     MODEL_SUBTYPE_DEFAULT),
+                    srk = rg_model_id(rg_model_t::REDLICH_KWONG,
+                                      MODEL_RK_SUBTYPE_SOAVE);
+};
+
+/* h and s of GetCaloric are referenced to the initial state of the
+ *   model: h = u + p*v and s of its dynamic parameters, so the state
+ *   enthalpy solves back to the state temperature */
+TEST_F(CaloricModelsTest, StateDatum) {
+  const double p0 = 1.0e6, t0 = 300.0;
+  std::unique_ptr<modelGeneral> models[] = {
+      init_model<Ideal_Gas>(ig, p0, t0), init_model<Peng_Robinson>(pr, p0, t0),
+      init_model<Redlich_Kwong_Soave>(srk, p0, t0)};
+  for (auto& m : models) {
+    ASSERT_NE(m, nullptr);
+    const dyn_parameters st = m->GetStateLog().dyn_pars;
+    caloric_point cal;
+    ASSERT_EQ(m->GetCaloric(p0, t0, &cal), ERROR_SUCCESS_T);
+    if (is_above0(m->GetVolume())) {
+      EXPECT_NEAR(cal.volume, m->GetVolume(), 1.0e-12 * cal.volume);
+    }
+    const double h = st.internal_energy + p0 * cal.volume;
+    EXPECT_NEAR(cal.enthalpy, h, 1.0e-9 * std::abs(cal.enthalpy));
+    EXPECT_NEAR(cal.entropy, st.entropy, 1.0e-9);
+    double t = 0.0;
+    ASSERT_EQ(m->SolvePH(p0, h, 200.0, &t), ERROR_SUCCESS_T);
+    EXPECT_NEAR(t, t0, 1.0e-8 * t0);
+    ASSERT_EQ(m->SolvePS(p0, st.entropy, 400.0, &t), ERROR_SUCCESS_T);
+    EXPECT_NEAR(t, t0, 1.0e-8 * t0);
+  }
+  /* Peng-Robinson also updates the state internal energy when the
+   *   volume changes at constant temperature */
+  modelGeneral* m = models[1].get();
+  for (const double p : {2.0e5, 5.0e6, 1.5e7}) {
+    m->SetVolume(p, t0);
+    const dyn_parameters st = m->GetStateLog().dyn_pars;
+    double t = 0.0;
+    ASSERT_EQ(
+        m->SolvePH(p, st.internal_energy + p * m->GetVolume(), 0.0, &t),
+        ERROR_SUCCESS_T);
+    EXPECT_NEAR(t, t0, 1.0e-8 * t0) << p;
+  }
+}
+
+/* below the critical pressure h(T) jumps by the heat of vaporization
+ *   where the stable root changes: a target inside the jump converges
+ *   to the jump temperature, which for a pure substance is the
+ *   saturation temperature of the same equation of state */
+TEST_F(CaloricModelsTest, TwoPhaseTarget) {
+  std::unique_ptr<modelGeneral> m(init_model<Peng_Robinson>(pr, 1.0e6,
+                                                            300.0));
+  ASSERT_NE(m, nullptr);
+  const double p = 2.0e6;
+  caloric_point liq, gas;
+  ASSERT_EQ(m->GetCaloric(p, 150.0, &liq), ERROR_SUCCESS_T);
+  ASSERT_EQ(m->GetCaloric(p, 180.0, &gas), ERROR_SUCCESS_T);
+  const double h = 0.5 * (liq.enthalpy + gas.enthalpy),
+               s = 0.5 * (liq.entropy + gas.entropy);
+  double t_h = 0.0, t_s = 0.0;
+  ASSERT_EQ(m->SolvePH(p, h, 0.0, &t_h), ERROR_SUCCESS_T);
+  ASSERT_EQ(m->SolvePS(p, s, 400.0, &t_s), ERROR_SUCCESS_T);
+  EXPECT_NEAR(t_s, t_h, 1.0e-8 * t_h);
+  ASSERT_EQ(m->GetCaloric(p, t_h * (1.0 - 1.0e-8), &liq), ERROR_SUCCESS_T);
+  ASSERT_EQ(m->GetCaloric(p, t_h * (1.0 + 1.0e-8), &gas), ERROR_SUCCESS_T);
+  EXPECT_LT(5.0 * liq.volume, gas.volume);
+  EXPECT_LT(liq.enthalpy, h);
+  EXPECT_GT(gas.enthalpy, h);
+  EXPECT_LT(liq.entropy, s);
+  EXPECT_GT(gas.entropy, s);
+
+  maxwell_point pt;
+  ASSERT_EQ(PhaseDiagram::GetCalculated().CalculateBinodalPoint(
+                pr, t_h / cp->critical.temperature, cp->acentricfactor,
+                &pt),
+            ERROR_SUCCESS_T);
+  EXPECT_NEAR(pt.p * cp->critical.pressure, p, 1.0e-3 * p);
+}
+
+/* in the three-root region the volume of the state, the batch volume
+ *   and the caloric volume are the same minimum Gibbs energy root:
+ *   liquid above the saturation pressure, vapour below it */
+TEST_F(CaloricModelsTest, ThreeRootVolume) {
+  std::unique_ptr<modelGeneral> m(init_model<Peng_Robinson>(pr, 1.0e6,
+                                                            300.0));
+  ASSERT_NE(m, nullptr);
+  Peng_Robinson* prm = dynamic_cast<Peng_Robinson*>(m.get());
+  ASSERT_NE(prm, nullptr);
+  const double t = 150.0, p[] = {0.5e6, 0.9e6, 1.2e6, 1.5e6};
+  const double tt[] = {t, t, t, t};
+  double v[4];
+  ASSERT_EQ(prm->GetVolumeBatch(p, tt, 4, v), ERROR_SUCCESS_T);
+  for (size_t i = 0; i < 4; ++i) {
+    caloric_point cal;
+    ASSERT_EQ(m->GetCaloric(p[i], t, &cal), ERROR_SUCCESS_T);
+    const double vs = m->GetVolume(p[i], t);
+    EXPECT_EQ(cal.volume, vs) << p[i];
+    EXPECT_NEAR(v[i], vs, 1.0e-12 * vs) << p[i];
+  }
+  EXPECT_GT(v[1], 0.03);
+  EXPECT_LT(v[2], 0.003);
+  EXPECT_LT(v[3], v[2]);
+}
+
+/* T -> h, s -> T over the gas region of every model with caloric
+ *   functions, starting from the state temperature and from poor
+ *   initial guesses, for ISO 20765 at the edges of its temperature
+ *   range, where Newton steps leave the range; GetCaloric itself is
+ *   checked against
+ *   (dh/dT)_p = cp and T * (ds/dT)_p = cp */
+TEST_F(CaloricModelsTest, RoundTrip) {
+  const double ht = 1.0e-3;
+  for (auto& m : caloric_models(5.0e6, 300.0)) {
+    ASSERT_NE(m, nullptr);
+    const std::string name = m->GetModelConfig()->short_info;
+    /* ISO 20765 is defined for 250 K <= T <= 350 K only */
+    const bool is_iso = m->GetModelConfig()->model_type.type
+                        == rg_model_t::NG_GOST;
+    const std::vector<double> t_inits =
+        is_iso ? std::vector<double>{0.0, 250.0, 350.0}
+               : std::vector<double>{0.0, 100.0, 1000.0};
+    for (const double p : {1.0e5, 2.0e6, 8.0e6}) {
+      for (const double t : {260.0, 300.0, 340.0}) {
+        caloric_point cal, cal_p, cal_m;
+        ASSERT_EQ(m->GetCaloric(p, t, &cal), ERROR_SUCCESS_T) << name;
+        ASSERT_EQ(m->GetCaloric(p, t + ht, &cal_p), ERROR_SUCCESS_T);
+        ASSERT_EQ(m->GetCaloric(p, t - ht, &cal_m), ERROR_SUCCESS_T);
+        EXPECT_GT(cal.volume, 0.0);
+        EXPECT_NEAR((cal_p.enthalpy - cal_m.enthalpy) / (2.0 * ht),
+                    cal.heat_cap_pres, 1.0e-5 * cal.heat_cap_pres)
+            << name << " " << p << " " << t;
+        EXPECT_NEAR(t * (cal_p.entropy - cal_m.entropy) / (2.0 * ht),
+                    cal.heat_cap_pres, 1.0e-5 * cal.heat_cap_pres)
+            << name << " " << p << " " << t;
+        for (const double t_init : t_inits) {
+          double t_h = 0.0, t_s = 0.0;
+          ASSERT_EQ(m->SolvePH(p, cal.enthalpy, t_init, &t_h),
+                    ERROR_SUCCESS_T)
+              << name << " " << p << " " << t;
+          ASSERT_EQ(m->SolvePS(p, cal.entropy, t_init, &t_s),
+                    ERROR_SUCCESS_T)
+              << name << " " << p << " " << t;
+          EXPECT_NEAR(t_h, t, 1.0e-9 * t) << name << " " << p;
+          EXPECT_NEAR(t_s, t, 1.0e-9 * t) << name << " " << p;
+        }
+      }
+    }
+  }
+}
+
+/* a warm start close to the root converges in a few Newton steps from
+ *   either side of it: a first step back below the initial guess is
+ *   not mistaken for a bisection against T = 0 */
+TEST_F(CaloricModelsTest, WarmStartBothSides) {
+  const double p = 1.0e6, t = 300.0;
+  for (auto& mp : caloric_models(p, t)) {
+    ASSERT_NE(mp, nullptr);
+    const std::string name = mp->GetModelConfig()->short_info;
+    CountingModel m(mp.get());
+    caloric_point cal;
+    ASSERT_EQ(m.GetCaloric(p, t, &cal), ERROR_SUCCESS_T) << name;
+    for (const double dt : {0.1, 1.0, 10.0}) {
+      int calls[2];
+      for (const int side : {0, 1}) {
+        const double t_init = side ? t + dt : t - dt;
+        double t_h = 0.0, t_s = 0.0;
+        m.calls = 0;
+        ASSERT_EQ(m.SolvePH(p, cal.enthalpy, t_init, &t_h), ERROR_SUCCESS_T)
+            << name << " " << t_init;
+        ASSERT_EQ(m.SolvePS(p, cal.entropy, t_init, &t_s), ERROR_SUCCESS_T)
+            << name << " " << t_init;
+        EXPECT_NEAR(t_h, t, 1.0e-9 * t) << name << " " << t_init;
+        EXPECT_NEAR(t_s, t, 1.0e-9 * t) << name << " " << t_init;
+        calls[side] = m.calls;
+      }
+      /* two solves of at most 5 evaluations each */
+      EXPECT_LE(calls[0], 10) << name << " " << dt;
+      EXPECT_LE(calls[1], 10) << name << " " << dt;
+      EXPECT_LE(std::abs(calls[1] - calls[0]), 2) << name << " " << dt;
+    }
+  }
+}
+
+/* a throttling-like sweep: the batch matches the pointwise solver
+ *   started from the previous result, the first point starts from the
+ *   state temperature, a failed point is skipped by the warm start */
+TEST_F(CaloricModelsTest, BatchWarmStart) {
+  const size_t count = 40, bad = 17;
+  for (auto& m : caloric_models(5.0e6, 300.0)) {
+    ASSERT_NE(m, nullptr);
+    const std::string name = m->GetModelConfig()->short_info;
+    std::vector<double> p(count), t(count), h(count), s(count);
+    for (size_t i = 0; i < count; ++i) {
+      p[i] = 8.0e6 - 1.5e5 * i;
+      t[i] = 340.0 - 1.5 * i;
+      caloric_point cal;
+      ASSERT_EQ(m->GetCaloric(p[i], t[i], &cal), ERROR_SUCCESS_T) << name;
+      h[i] = cal.enthalpy;
+      s[i] = cal.entropy;
+    }
+    std::vector<double> th(count, -1.0), ts(count, -1.0);
+    ASSERT_EQ(m->SolvePHBatch(p.data(), h.data(), count, th.data()),
+              ERROR_SUCCESS_T) << name;
+    ASSERT_EQ(m->SolvePSBatch(p.data(), s.data(), count, ts.data()),
+              ERROR_SUCCESS_T) << name;
+    double t_prev_h = 0.0, t_prev_s = 0.0;
+    for (size_t i = 0; i < count; ++i) {
+      double t_h, t_s;
+      ASSERT_EQ(m->SolvePH(p[i], h[i], t_prev_h, &t_h), ERROR_SUCCESS_T);
+      ASSERT_EQ(m->SolvePS(p[i], s[i], t_prev_s, &t_s), ERROR_SUCCESS_T);
+      EXPECT_EQ(th[i], t_h) << name << " " << i;
+      EXPECT_EQ(ts[i], t_s) << name << " " << i;
+      EXPECT_NEAR(th[i], t[i], 1.0e-9 * t[i]) << name << " " << i;
+      EXPECT_NEAR(ts[i], t[i], 1.0e-9 * t[i]) << name << " " << i;
+      t_prev_h = t_h;
+      t_prev_s = t_s;
+    }
+
+    p[bad] = -1.0;
+    ASSERT_EQ(m->SolvePHBatch(p.data(), h.data(), count, th.data()),
+              ERROR_CALC_MODEL_ST) << name;
+    EXPECT_EQ(th[bad], 0.0);
+    double t_next;
+    ASSERT_EQ(m->SolvePH(p[bad + 1], h[bad + 1], th[bad - 1], &t_next),
+              ERROR_SUCCESS_T);
+    EXPECT_EQ(th[bad + 1], t_next) << name;
+    EXPECT_NEAR(th[count - 1], t[count - 1], 1.0e-9 * t[count - 1]);
+  }
+}
+
+TEST_F(CaloricModelsTest, ErrorPaths) {
+  const double p = 2.0e6, t = 300.0;
+  for (auto& m : caloric_models(p, t)) {
+    ASSERT_NE(m, nullptr);
+    const std::string name = m->GetModelConfig()->short_info;
+    caloric_point cal;
+    double tr = -1.0;
+    EXPECT_EQ(m->GetCaloric(p, t, nullptr), ERROR_INIT_NULLP_ST) << name;
+    EXPECT_NE(m->GetCaloric(-p, t, &cal), ERROR_SUCCESS_T) << name;
+    EXPECT_NE(m->GetCaloric(p, 0.0, &cal), ERROR_SUCCESS_T) << name;
+    ASSERT_EQ(m->GetCaloric(p, t, &cal), ERROR_SUCCESS_T) << name;
+    EXPECT_EQ(m->SolvePH(p, cal.enthalpy, 0.0, nullptr),
+              ERROR_INIT_NULLP_ST);
+    EXPECT_EQ(m->SolvePS(0.0, cal.entropy, 0.0, &tr), ERROR_CALC_MODEL_ST);
+    EXPECT_EQ(tr, -1.0);
+    /* no temperature gives so low an enthalpy */
+    EXPECT_NE(m->SolvePH(p, cal.enthalpy - 1.0e9, 0.0, &tr),
+              ERROR_SUCCESS_T) << name;
+    EXPECT_EQ(m->SolvePHBatch(nullptr, &cal.enthalpy, 1, &tr),
+              ERROR_INIT_NULLP_ST);
+    EXPECT_EQ(m->SolvePSBatch(&p, nullptr, 1, &tr), ERROR_INIT_NULLP_ST);
+    EXPECT_EQ(m->SolvePSBatch(&p, &cal.entropy, 1, nullptr),
+              ERROR_INIT_NULLP_ST);
+    EXPECT_EQ(m->SolvePHBatch(&p, &cal.enthalpy, 0, &tr), ERROR_SUCCESS_T);
+  }
+  /* GOST 30319.1 has no caloric functions */
+  std::unique_ptr<modelGeneral> gost(init_gost(false, p, t));
+  ASSERT_NE(gost, nullptr);
+  caloric_point cal;
+  double tr = -1.0;
+  EXPECT_EQ(gost->GetCaloric(p, t, &cal), ERROR_CALC_MODEL_ST);
+  EXPECT_EQ(gost->SolvePH(p, 0.0, 0.0, &tr), ERROR_CALC_MODEL_ST);
+  EXPECT_EQ(gost->SolvePSBatch(&p, &cal.entropy, 1, &tr),
+            ERROR_CALC_MODEL_ST);
+  EXPECT_EQ(tr, 0.0);
+}
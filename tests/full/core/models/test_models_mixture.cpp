@@ -0,0 +1,117 @@
+#include "model_peng_robinson.h"
+
+#include "atherm_common.h"
+#include "dual_number.h"
+#include "gas_description.h"
+#include "model_redlich_kwong_soave.h"
+
+#include "gtest/gtest.h"
+
+#include <array>
+#include <cmath>
+#include <memory>
+
+
+/** \brief Кубические модели смеси метан-этан-пропан */
+class MixtureModelsTest: public ::testing::Test {
+protected:
+  MixtureModelsTest() {
+    cp[0].reset(const_parameters::Init(GAS_TYPE_PROPANE, 0.004545, 4.248e6,
+        369.8, 0.276, 44.1, 0.152));
+    cp[1].reset(const_parameters::Init(GAS_TYPE_ETHANE, 0.00493, 4.872e6,
+        305.3, 0.279, 30.07, 0.099));
+    cp[2].reset(const_parameters::Init(GAS_TYPE_METHANE, 0.0062, 4.599e6,
+        190.56, 0.286, 16.04, 0.011));
+    const double cv[] = {1480.0, 1480.0, 1700.0},
+                 cpr[] = {1670.0, 1750.0, 2200.0},
+                 v[] = {0.05, 0.08, 0.149};
+    for (size_t i = 0; i < 3; ++i)
+      dp[i].reset(dyn_parameters::Init(DYNAMIC_HEAT_CAP_VOL |
+          DYNAMIC_HEAT_CAP_PRES | DYNAMIC_INTERNAL_ENERGY, cv[i], cpr[i],
+          0.0, {v[i], 1.0e6, 300.0}));
+  }
+
+  /**
+   * \brief Модель смеси с мольными долями x[i] компонентов cp[i]
+   * \note parameters_mix упорядочен по долям, поэтому x[0] < x[1] < x[2]
+   *   и порядок компонентов в модели совпадает с порядком cp
+   * */
+  template <class Model>
+  std::unique_ptr<Model> init_model(rg_model_id mn, const double* x) {
+    gas_marks_t gm = (uint32_t)mn.type | ((uint32_t)mn.type
+        << BINODAL_MODEL_SHIFT);
+    AddGasMixMark(&gm);
+    mix.clear();
+    for (size_t i = 0; i < 3; ++i)
+      mix.insert({x[i], const_dyn_parameters(*cp[i], *dp[i])});
+    const_dyn_union cd;
+    cd.components = &mix;
+    model_input mi(gm, nullptr, {1.0e6, 300.0, cd},
+                   Model::GetModelShortInfo(mn));
+    return std::unique_ptr<Model>(Model::Init(mi));
+  }
+
+  /* eos(x0) with composition x1 against the model built for x1; dual
+   *   derivatives by x against central differences of models x0 ± h e_i */
+  template <class Model>
+  void check_composition(rg_model_id mn) {
+    const double x0[] = {0.03, 0.07, 0.9}, x1[] = {0.08, 0.12, 0.8};
+    auto m0 = init_model<Model>(mn, x0);
+    auto m1 = init_model<Model>(mn, x1);
+    ASSERT_NE(m0, nullptr);
+    ASSERT_NE(m1, nullptr);
+    const auto& eos0 = m0->GetEOS();
+    const auto& eos1 = m1->GetEOS();
+    ASSERT_EQ(eos0.GetMixing().Size(), 3);
+    EXPECT_NEAR(eos0.R(x0), eos0.R(), 1e-12 * eos0.R());
+    EXPECT_NEAR(eos0.R(x1), eos1.R(), 1e-12 * eos1.R());
+    const double t = 300.0;
+    for (double v = 0.005; v < 0.1; v *= 2.0) {
+      const double p = eos1.Pressure(v, t);
+      EXPECT_NEAR(eos0.Pressure(v, t, x1), p, 1e-10 * p);
+      EXPECT_NEAR(m1->GetPressure(v, t), p, 1e-10 * p);
+    }
+    for (double p = 1e6; p < 1e7; p += 3e6) {
+      const double v = m1->GetVolume(p, t);
+      EXPECT_NEAR(eos0.Volume(p, t, x1), v, 1e-10 * v);
+    }
+    const double v = 0.02, p = 4e6, h = 1e-6;
+    std::array<dual<3>, 3> xd;
+    for (size_t i = 0; i < 3; ++i)
+      xd[i] = dual<3>::Variable(x0[i], i);
+    const dual<3> pd = eos0.Pressure(dual<3>(v), dual<3>(t), xd.data());
+    const dual<3> vd = eos0.Volume(dual<3>(p), dual<3>(t), xd.data());
+    for (size_t i = 0; i < 3; ++i) {
+      double xp[] = {x0[0], x0[1], x0[2]}, xm[] = {x0[0], x0[1], x0[2]};
+      xp[i] += h;
+      xm[i] -= h;
+      auto mp = init_model<Model>(mn, xp);
+      auto mm = init_model<Model>(mn, xm);
+      ASSERT_NE(mp, nullptr);
+      ASSERT_NE(mm, nullptr);
+      const double dp_dx = (mp->GetPressure(v, t) - mm->GetPressure(v, t))
+                           / (2.0 * h);
+      const double dv_dx = (mp->GetVolume(p, t) - mm->GetVolume(p, t))
+                           / (2.0 * h);
+      EXPECT_NEAR(pd.d[i], dp_dx, 1e-6 * std::abs(dp_dx));
+      EXPECT_NEAR(vd.d[i], dv_dx, 1e-6 * std::abs(dv_dx));
+    }
+  }
+
+protected:
+  std::unique_ptr<const_parameters> cp[3];
+  std::unique_ptr<dyn_parameters> dp[3];
+  parameters_mix mix;
+};
+
+/* Pressure(v, t, x) and Volume(p, t, x) of the mixture EOS with the
+ *   mass-specific gas constant R(x) */
+TEST_F(MixtureModelsTest, PengRobinsonComposition) {
+  check_composition<Peng_Robinson>(rg_model_id(rg_model_t::PENG_ROBINSON,
+                                               MODEL_PR_SUBTYPE_BINASSOC));
+}
+
+TEST_F(MixtureModelsTest, RedlichKwongSoaveComposition) {
+  check_composition<Redlich_Kwong_Soave>(rg_model_id(
+      rg_model_t::REDLICH_KWONG, MODEL_RK_SUBTYPE_SOAVE));
+}
@@ -0,0 +1,26 @@
+message(STATUS "\t\tRun phase diagram test")
+
+include(${ASP_THERM_CMAKE_ROOT}/models_src.cmake)
+set_models_src(PHASE_DIAGRAM_TEST_SRC)
+add_executable(test_phase_diagram
+  ${PHASE_DIAGRAM_TEST_SRC}
+
+  ${ASP_THERM_FULLTEST_DIR}/core/phase_diagram/test_binodal_table.cpp
+  ${ASP_THERM_FULLTEST_DIR}/core/phase_diagram/test_phase_diagram.cpp
+  ${ASP_THERM_FULLTEST_DIR}/core/phase_diagram/test_phase_equilibrium.cpp)
+
+target_compile_definitions(test_phase_diagram
+  PRIVATE -DBYCMAKE_DEBUG -DTESTING_PROJECT -DISO_20765
+  ${INCLUDE_ERRORCODES})
+target_compile_options(test_phase_diagram
+  PRIVATE -fprofile-arcs -ftest-coverage)
+target_include_directories(test_phase_diagram
+  PRIVATE ${TESTS_INCLUDE_DIRS}
+  PRIVATE ${MODULES_DIR}/asp_db/source)
+target_link_libraries(test_phase_diagram
+  pugixml
+  asp_utils
+  asp_db
+  ${FULLTEST_LIBRARIES})
+
+add_test(test_phase_diagram "core/test_phase_diagram")
@@ -0,0 +1,187 @@
+#include "binodal_table.h"
+
+#include "atherm_common.h"
+#include "gas_description.h"
+#include "phase_diagram.h"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+
+/** \brief Таблица бинодалей модели Пенга-Робинсона */
+class BinodalTableTest: public ::testing::Test {
+ protected:
+  BinodalTableTest()
+      : pr(rg_model_t::PENG_ROBINSON, MODEL_SUBTYPE_DEFAULT),
+        path(::testing::TempDir() + "binodal_table_pr.bin") {
+    table.reset(BinodalTable::Init(pr, t_grid, -0.1, 0.02, 31));
+  }
+  ~BinodalTableTest() { std::remove(path.c_str()); }
+
+ protected:
+  const rg_model_id pr;
+  const std::string path;
+  const std::vector<double> t_grid = {0.95, 0.9, 0.8, 0.7, 0.6, 0.5};
+  std::unique_ptr<BinodalTable> table;
+};
+
+TEST_F(BinodalTableTest, Interpolate) {
+  ASSERT_NE(table, nullptr);
+  EXPECT_EQ(table->GetModel(), pr);
+  EXPECT_EQ(table->GetTemperatures(), t_grid);
+  EXPECT_TRUE(table->Covers(0.5));
+  EXPECT_FALSE(table->Covers(0.51));
+  PhaseDiagram& pd = PhaseDiagram::GetCalculated();
+  maxwell_point pt, ref;
+  for (const double w : {-0.1, 0.011, 0.152, 0.2345, 0.5}) {
+    for (size_t i = 0; i < t_grid.size(); ++i) {
+      ASSERT_EQ(table->Interpolate(i, w, &pt), ERROR_SUCCESS_T);
+      ASSERT_EQ(pd.CalculateBinodalPoint(pr, t_grid[i], w, &ref),
+                ERROR_SUCCESS_T);
+      EXPECT_NEAR(pt.p, ref.p, 1.0e-6 * ref.p) << w << " " << t_grid[i];
+      EXPECT_NEAR(pt.vLeft, ref.vLeft, 1.0e-6 * ref.vLeft);
+      EXPECT_NEAR(pt.vRigth, ref.vRigth, 1.0e-6 * ref.vRigth);
+    }
+  }
+  EXPECT_EQ(table->Interpolate(t_grid.size(), 0.1, &pt), ERROR_INIT_T);
+  EXPECT_EQ(table->Interpolate(0, 0.6, &pt), ERROR_INIT_T);
+  EXPECT_EQ(table->Interpolate(0, 0.1, nullptr), ERROR_INIT_NULLP_ST);
+  EXPECT_EQ(BinodalTable::Init(pr, {0.9, 1.0}), nullptr);
+  EXPECT_EQ(BinodalTable::Init(
+                rg_model_id(rg_model_t::NG_GOST, MODEL_SUBTYPE_DEFAULT),
+                t_grid),
+            nullptr);
+}
+
+TEST_F(BinodalTableTest, SaveAndLoad) {
+  ASSERT_NE(table, nullptr);
+  ASSERT_EQ(table->Save(path), ERROR_SUCCESS_T);
+  std::unique_ptr<BinodalTable> loaded(BinodalTable::Init(path));
+  ASSERT_NE(loaded, nullptr);
+  EXPECT_EQ(loaded->GetModel(), pr);
+  EXPECT_EQ(loaded->GetTemperatures(), t_grid);
+  maxwell_point a, b;
+  for (size_t i = 0; i < t_grid.size(); ++i) {
+    ASSERT_EQ(table->Interpolate(i, 0.2345, &a), ERROR_SUCCESS_T);
+    ASSERT_EQ(loaded->Interpolate(i, 0.2345, &b), ERROR_SUCCESS_T);
+    EXPECT_EQ(a.p, b.p);
+    EXPECT_EQ(a.vRigth, b.vRigth);
+  }
+  /* заголовок и 4 массива double */
+  std::ifstream file(path, std::ios::binary | std::ios::ate);
+  EXPECT_EQ(size_t(file.tellg()), sizeof(binodal_table_header)
+                                      + sizeof(double) * t_grid.size()
+                                            * (1 + 3 * 31));
+  file.close();
+  /* повреждённый файл */
+  std::fstream(path, std::ios::binary | std::ios::in | std::ios::out)
+      .write("ATHBINOX", 8);
+  EXPECT_EQ(BinodalTable::Init(path), nullptr);
+  EXPECT_EQ(BinodalTable::Init(path + ".none"), nullptr);
+}
+
+/* заголовок сверяется с размером файла до выделения памяти */
+TEST_F(BinodalTableTest, CorruptHeader) {
+  ASSERT_NE(table, nullptr);
+  ASSERT_EQ(table->Save(path), ERROR_SUCCESS_T);
+  binodal_table_header h;
+  std::ifstream(path, std::ios::binary)
+      .read(reinterpret_cast<char*>(&h), sizeof(h));
+  const auto load_with = [this, &h](std::function<void(binodal_table_header*)>
+                                        corrupt) {
+    binodal_table_header c = h;
+    corrupt(&c);
+    std::fstream(path, std::ios::binary | std::ios::in | std::ios::out)
+        .write(reinterpret_cast<const char*>(&c), sizeof(c));
+    return std::unique_ptr<BinodalTable>(BinodalTable::Init(path));
+  };
+  EXPECT_NE(load_with([](binodal_table_header*) {}), nullptr);
+  EXPECT_EQ(load_with([](binodal_table_header* c) {
+              c->t_count = c->w_count = 0xffffffff;
+            }),
+            nullptr);
+  EXPECT_EQ(load_with([](binodal_table_header* c) { c->t_count = 0; }),
+            nullptr);
+  EXPECT_EQ(load_with([](binodal_table_header* c) { c->w_count += 1; }),
+            nullptr);
+  EXPECT_EQ(load_with([](binodal_table_header* c) { c->w_step = -0.02; }),
+            nullptr);
+  EXPECT_EQ(load_with([](binodal_table_header* c) {
+              c->model_type = int32_t(rg_model_t::NG_GOST);
+            }),
+            nullptr);
+  /* приведённая температура вне (0, 1) */
+  const double t_bad = 1.5;
+  std::fstream(path, std::ios::binary | std::ios::in | std::ios::out)
+      .seekp(sizeof(h))
+      .write(reinterpret_cast<const char*>(&t_bad), sizeof(t_bad));
+  EXPECT_EQ(load_with([](binodal_table_header*) {}), nullptr);
+  /* усечённый файл */
+  std::ofstream(path, std::ios::binary | std::ios::trunc)
+      .write(reinterpret_cast<const char*>(&h), sizeof(h));
+  EXPECT_EQ(BinodalTable::Init(path), nullptr);
+}
+
+TEST_F(BinodalTableTest, PhaseDiagramLookup) {
+  std::unique_ptr<const_parameters> cp(const_parameters::Init(
+      GAS_TYPE_PROPANE, 0.004545, 4.248e6, 369.83, 0.276, 44.1, 0.152));
+  ASSERT_NE(cp, nullptr);
+  PhaseDiagram& pd = PhaseDiagram::GetCalculated();
+  pd.ClearBinodalTables();
+  std::unique_ptr<binodalpoints> solved(pd.GetBinodalPoints(*cp, pr));
+  ASSERT_NE(solved, nullptr);
+
+  /* таблица рассчитывается при первом использовании и сохраняется */
+  std::remove(path.c_str());
+  ASSERT_EQ(pd.UseBinodalTable(pr, path), ERROR_SUCCESS_T);
+  EXPECT_TRUE(std::ifstream(path).good());
+  EXPECT_EQ(pd.GetCacheStats().size, 0);
+  std::unique_ptr<binodalpoints> interpolated(pd.GetBinodalPoints(*cp, pr));
+  ASSERT_NE(interpolated, nullptr);
+  ASSERT_EQ(interpolated->t.size(), solved->t.size());
+  for (size_t i = 0; i < solved->t.size(); ++i) {
+    EXPECT_DOUBLE_EQ(interpolated->t[i], solved->t[i]);
+    EXPECT_NEAR(interpolated->p[i], solved->p[i], 1.0e-6 * solved->p[i]);
+    EXPECT_NEAR(interpolated->vLeft[i], solved->vLeft[i],
+                1.0e-6 * solved->vLeft[i]);
+  }
+  /* повторно таблица читается из файла */
+  ASSERT_EQ(pd.UseBinodalTable(pr, path), ERROR_SUCCESS_T);
+  interpolated.reset(pd.GetBinodalPoints(*cp, pr));
+  ASSERT_NE(interpolated, nullptr);
+  EXPECT_NEAR(interpolated->p[3], solved->p[3], 1.0e-6 * solved->p[3]);
+
+  /* файл другой модели или повреждённый файл не перезаписывается */
+  const rg_model_id rk(rg_model_t::REDLICH_KWONG, MODEL_SUBTYPE_DEFAULT);
+  EXPECT_EQ(pd.UseBinodalTable(rk, path), ERROR_INIT_T);
+  std::unique_ptr<BinodalTable> kept(BinodalTable::Init(path));
+  ASSERT_NE(kept, nullptr);
+  EXPECT_EQ(kept->GetModel(), pr);
+  std::fstream(path, std::ios::binary | std::ios::in | std::ios::out)
+      .write("ATHBINOX", 8);
+  EXPECT_EQ(pd.UseBinodalTable(pr, path), ERROR_FILE_IN_ST);
+  char magic[8];
+  std::ifstream(path, std::ios::binary).read(magic, sizeof(magic));
+  EXPECT_EQ(std::string(magic, sizeof(magic)), "ATHBINOX");
+
+  /* точки бинодали упорядочиваются по давлению при любом порядке
+   *   температур таблицы */
+  pd.SetBinodalTable(std::shared_ptr<const BinodalTable>(
+      BinodalTable::Init(pr, {0.6, 0.9, 0.7}, 0.1, 0.02, 4)));
+  interpolated.reset(pd.GetBinodalPoints(*cp, pr));
+  ASSERT_NE(interpolated, nullptr);
+  ASSERT_EQ(interpolated->t.size(), 4);
+  EXPECT_EQ(interpolated->t[1], 0.9 * cp->critical.temperature);
+  EXPECT_EQ(interpolated->t[3], 0.6 * cp->critical.temperature);
+  EXPECT_TRUE(std::is_sorted(interpolated->p.begin(), interpolated->p.end(),
+                             std::greater<double>()));
+  pd.ClearBinodalTables();
+}
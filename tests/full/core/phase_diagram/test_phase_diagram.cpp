@@ -0,0 +1,277 @@
+#include "phase_diagram.h"
+
+#include "atherm_common.h"
+#include "gas_description.h"
+#include "models_math.h"
+#include "phase_diagram_models.h"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+/** \brief Прежний расчёт точки бинодали: подбор давления с шагом
+ *   0.2% до совпадения площадей с точностью 0.5%
+ * \return Давление или -1.0, если решение не найдено */
+template <class init_t, class integ_t>
+double reference_maxwell(double t,
+                         double acentric,
+                         bool near_critical,
+                         uint32_t* iterations) {
+  init_t init;
+  integ_t integrate;
+  std::vector<double> tempvec(7);
+  double pi = t * t * t, dpi = -pi * 0.002;
+  for (*iterations = 0; *iterations <= 3000; ++*iterations) {
+    if (near_critical)
+      dpi *= 0.1;
+    pi += dpi;
+    init(tempvec, pi, t, acentric);
+    int roots_count = 0;
+    if (CardanoMethod_roots_count(&tempvec[0], &tempvec[4], &roots_count))
+      return -1.0;
+    if (roots_count == 1) {
+      dpi = 0.002 * pi;
+      pi = (tempvec[4] <= 1.0) ? (pi - 2.0 * dpi) : (pi + 2.0 * dpi);
+      continue;
+    }
+    std::sort(tempvec.begin() + 4, tempvec.end());
+    const double rectan_area = (tempvec[6] - tempvec[4]) * pi,
+                 ARdiffer = (rectan_area - integrate(t, tempvec[4],
+                                                     tempvec[6], acentric))
+                            / rectan_area;
+    if (std::abs(ARdiffer) < 0.005)
+      return pi;
+    pi += (ARdiffer > 0.0) ? -2.0 * dpi : 3.0 * dpi;
+    dpi = 0.002 * pi;
+  }
+  return -1.0;
+}
+
+
+TEST(PhaseDiagram, BinodalCache) {
+  std::unique_ptr<const_parameters> cp(const_parameters::Init(
+      GAS_TYPE_METHANE, 0.0062, 4.599e6, 190.56, 0.286, 16.04, 0.011));
+  ASSERT_NE(cp, nullptr);
+  const rg_model_id pr(rg_model_t::PENG_ROBINSON, MODEL_SUBTYPE_DEFAULT),
+                    rk(rg_model_t::REDLICH_KWONG, MODEL_SUBTYPE_DEFAULT);
+  PhaseDiagram& pd = PhaseDiagram::GetCalculated();
+  pd.ClearCache();
+  std::unique_ptr<binodalpoints> first(pd.GetBinodalPoints(*cp, pr)),
+      second(pd.GetBinodalPoints(*cp, pr));
+  ASSERT_NE(first, nullptr);
+  ASSERT_NE(second, nullptr);
+  EXPECT_EQ(first->p, second->p);
+  EXPECT_EQ(first->vLeft, second->vLeft);
+  EXPECT_EQ(first->t.front(), cp->critical.temperature);
+  binodal_cache_stats stats = pd.GetCacheStats();
+  EXPECT_EQ(stats.misses, 1);
+  EXPECT_EQ(stats.hits, 1);
+  EXPECT_EQ(stats.size, 1);
+
+  /* параллельные запросы из нескольких потоков */
+  std::unique_ptr<binodalpoints> ref(pd.GetBinodalPoints(*cp, rk));
+  ASSERT_NE(ref, nullptr);
+  const int threads = 8, calls = 20;
+  std::vector<std::future<bool>> results;
+  for (int i = 0; i < threads; ++i) {
+    results.push_back(std::async(std::launch::async, [&]() {
+      bool same = true;
+      for (int j = 0; j < calls; ++j) {
+        std::unique_ptr<binodalpoints> bp(pd.GetBinodalPoints(*cp, rk));
+        same = same && bp && bp->p == ref->p && bp->vRigth == ref->vRigth;
+      }
+      return same;
+    }));
+  }
+  for (auto& r : results)
+    EXPECT_TRUE(r.get());
+  stats = pd.GetCacheStats();
+  EXPECT_EQ(stats.misses, 2);
+  EXPECT_EQ(stats.hits, 1 + threads * calls);
+  EXPECT_EQ(stats.size, 2);
+  pd.ClearCache();
+  EXPECT_EQ(pd.GetCacheStats().hits, 0);
+}
+
+TEST(PhaseDiagram, MaxwellConstruction) {
+  PhaseDiagram& pd = PhaseDiagram::GetCalculated();
+  const rg_model_id pr(rg_model_t::PENG_ROBINSON, MODEL_SUBTYPE_DEFAULT),
+                    rk(rg_model_t::REDLICH_KWONG, MODEL_SUBTYPE_DEFAULT);
+  const maxwell_solver_options opts = pd.GetSolverOptions();
+  maxwell_point pt;
+  for (const double acentric : {0.011, 0.3}) {
+    double p_prev = 0.0;
+    for (double t = 0.3; t < 0.995; t += 0.01) {
+      ASSERT_EQ(pd.CalculateBinodalPoint(pr, t, acentric, &pt),
+                ERROR_SUCCESS_T) << t;
+      EXPECT_LE(pt.iterations, opts.max_iterations);
+      EXPECT_GT(pt.p, p_prev);
+      EXPECT_LT(pt.vLeft, 1.0);
+      EXPECT_GT(pt.vRigth, 1.0);
+      /* равенство площадей */
+      const double area = pt.p * (pt.vRigth - pt.vLeft);
+      EXPECT_NEAR(lineIntegratePR()(t, pt.vLeft, pt.vRigth, acentric), area,
+                  1.0e-8 * area) << t;
+      p_prev = pt.p;
+    }
+  }
+  /* давление насыщения по равенству летучестей фаз */
+  ASSERT_EQ(pd.CalculateBinodalPoint(pr, 0.7, 0.011, &pt), ERROR_SUCCESS_T);
+  EXPECT_NEAR(pt.p, 0.098062, 1.0e-4);
+  ASSERT_EQ(pd.CalculateBinodalPoint(rk, 0.7, 0.011, &pt), ERROR_SUCCESS_T);
+  EXPECT_NEAR(pt.p, 0.087441, 1.0e-4);
+  EXPECT_NEAR(lineIntegrateRK2()(0.7, pt.vLeft, pt.vRigth),
+              pt.p * (pt.vRigth - pt.vLeft), 1.0e-9);
+
+  EXPECT_EQ(pd.CalculateBinodalPoint(pr, 1.0, 0.011, &pt),
+            ERROR_CALC_PHASE_ST);
+  EXPECT_EQ(pd.CalculateBinodalPoint(
+                rg_model_id(rg_model_t::REDLICH_KWONG, MODEL_RK_SUBTYPE_SOAVE),
+                0.7, 0.011, &pt),
+            ERROR_INIT_T);
+  EXPECT_EQ(pd.CalculateBinodalPoint(pr, 0.7, 0.011, nullptr),
+            ERROR_INIT_NULLP_ST);
+
+  /* ограничение числа итераций */
+  pd.SetSolverOptions({opts.tolerance, 1});
+  EXPECT_EQ(pd.CalculateBinodalPoint(pr, 0.7, 0.011, &pt),
+            ERROR_CALC_PHASE_ST);
+  EXPECT_EQ(pt.iterations, 1);
+  pd.SetSolverOptions(opts);
+}
+
+TEST(PhaseDiagram, TemperatureGrid) {
+  std::unique_ptr<const_parameters> cp(const_parameters::Init(
+      GAS_TYPE_METHANE, 0.0062, 4.599e6, 190.56, 0.286, 16.04, 0.011));
+  ASSERT_NE(cp, nullptr);
+  const rg_model_id pr(rg_model_t::PENG_ROBINSON, MODEL_SUBTYPE_DEFAULT);
+  PhaseDiagram& pd = PhaseDiagram::GetCalculated();
+  const std::vector<double> grid = PhaseDiagram::ClusteredTemperatureGrid(
+      400, 0.4);
+  ASSERT_EQ(grid.size(), 400);
+  EXPECT_DOUBLE_EQ(grid.back(), 0.4);
+  EXPECT_LT(grid.front(), 1.0);
+  /* сгущение к критической точке */
+  EXPECT_LT(grid[0] - grid[1], grid[398] - grid[399]);
+
+  const binodal_cache_stats stats = pd.GetCacheStats();
+  std::unique_ptr<binodalpoints> bp(pd.GetBinodalPoints(*cp, pr, grid));
+  ASSERT_NE(bp, nullptr);
+  ASSERT_EQ(bp->t.size(), grid.size() + 1);
+  EXPECT_EQ(bp->t.front(), cp->critical.temperature);
+  EXPECT_EQ(bp->p.front(), cp->critical.pressure);
+  maxwell_point pt;
+  for (size_t i = 0; i < grid.size(); ++i) {
+    EXPECT_DOUBLE_EQ(bp->t[i + 1], grid[i] * cp->critical.temperature);
+    EXPECT_LT(bp->p[i + 1], bp->p[i]);
+    ASSERT_EQ(pd.CalculateBinodalPoint(pr, grid[i], 0.011, &pt),
+              ERROR_SUCCESS_T);
+    EXPECT_NEAR(bp->p[i + 1], pt.p * cp->critical.pressure,
+                1.0e-7 * bp->p[i + 1]) << grid[i];
+  }
+  /* бинодали на заданной сетке не кэшируются */
+  EXPECT_EQ(pd.GetCacheStats().misses, stats.misses);
+  EXPECT_EQ(pd.GetCacheStats().size, stats.size);
+
+  /* значения вне (0, 1) и повторы отбрасываются */
+  bp.reset(pd.GetBinodalPoints(*cp, pr, {0.5, 1.2, 0.7, 0.5, -1.0}));
+  ASSERT_NE(bp, nullptr);
+  ASSERT_EQ(bp->t.size(), 3);
+  EXPECT_DOUBLE_EQ(bp->t[1], 0.7 * cp->critical.temperature);
+  EXPECT_DOUBLE_EQ(bp->t[2], 0.5 * cp->critical.temperature);
+  EXPECT_EQ(pd.GetBinodalPoints(
+                *cp, rg_model_id(rg_model_t::NG_GOST, MODEL_SUBTYPE_DEFAULT),
+                grid),
+            nullptr);
+}
+
+TEST(PhaseDiagram, PressureIndex) {
+  std::unique_ptr<const_parameters> cp(const_parameters::Init(
+      GAS_TYPE_PROPANE, 0.004545, 4.248e6, 369.83, 0.276, 44.1, 0.152));
+  ASSERT_NE(cp, nullptr);
+  const rg_model_id pr(rg_model_t::PENG_ROBINSON, MODEL_SUBTYPE_DEFAULT);
+  std::unique_ptr<binodalpoints> bp(
+      PhaseDiagram::GetCalculated().GetBinodalPoints(*cp, pr));
+  ASSERT_NE(bp, nullptr);
+  const std::vector<double>& p = bp->p;
+  ASSERT_GT(p.size(), 2);
+  EXPECT_TRUE(std::is_sorted(p.begin(), p.end(), std::greater<double>()));
+  EXPECT_EQ(bp->t.size(), p.size());
+  EXPECT_EQ(bp->vLeft.size(), p.size());
+  EXPECT_EQ(bp->vRigth.size(), p.size());
+  /* прежний линейный поиск */
+  auto linear = [&p](double pi) {
+    return size_t(std::find_if(p.begin() + 1, p.end(),
+                               [pi](double v) { return v < pi; })
+                  - p.begin());
+  };
+  for (size_t k = 1; k < p.size(); ++k) {
+    const double pm = 0.5 * (p[k - 1] + p[k]);
+    EXPECT_EQ(bp->PressureIndex(pm), k);
+    EXPECT_EQ(bp->PressureIndex(p[k - 1]), linear(p[k - 1]));
+    EXPECT_EQ(bp->PressureIndex(p[k]), linear(p[k]));
+  }
+  EXPECT_EQ(bp->PressureIndex(2.0 * p.front()), 1);
+  EXPECT_EQ(bp->PressureIndex(0.5 * p.back()), p.size());
+
+  /* нерассчитанные точки удаляются, порядок по давлению сохраняется */
+  bp.reset(PhaseDiagram::GetCalculated().GetBinodalPoints(
+      *cp, pr, {0.9, 0.6, 1.0e-3, 0.3}));
+  ASSERT_NE(bp, nullptr);
+  EXPECT_EQ(bp->t.size(), 4);
+  EXPECT_EQ(bp->p.size(), 4);
+  EXPECT_TRUE(std::is_sorted(bp->p.begin(), bp->p.end(),
+                             std::greater<double>()));
+  EXPECT_TRUE(std::all_of(bp->vLeft.begin(), bp->vLeft.end(),
+                          [](double v) { return v > 0.0; }));
+}
+
+/** \brief Сравнение числа итераций и времени расчёта бинодали с
+ *   прежним методом, запуск: --gtest_also_run_disabled_tests */
+TEST(PhaseDiagram, DISABLED_MaxwellBenchmark) {
+  using namespace std::chrono;
+  PhaseDiagram& pd = PhaseDiagram::GetCalculated();
+  const std::vector<double> ts = {0.97, 0.95, 0.92, 0.9, 0.87, 0.85,
+                                  0.8,  0.75, 0.7,  0.6, 0.5};
+  const int loops = 50;
+  auto run = [&](const char* name, rg_model_id mn, auto reference) {
+    uint32_t ref_iterations = 0, iterations = 0, it;
+    double sum = 0.0;
+    auto start = steady_clock::now();
+    for (int i = 0; i < loops; ++i) {
+      for (size_t j = 0; j < ts.size(); ++j) {
+        sum += reference(ts[j], 0.011, j < 4, &it);
+        ref_iterations += it;
+      }
+    }
+    auto ref_time = duration_cast<microseconds>(steady_clock::now() - start);
+    maxwell_point pt;
+    start = steady_clock::now();
+    for (int i = 0; i < loops; ++i) {
+      for (const double t : ts) {
+        pd.CalculateBinodalPoint(mn, t, 0.011, &pt);
+        sum -= pt.p;
+        iterations += pt.iterations;
+      }
+    }
+    auto time = duration_cast<microseconds>(steady_clock::now() - start);
+    std::cout << name << "  reference: " << ref_iterations / loops
+              << " iterations, " << ref_time.count() / loops << "us"
+              << "  maxwell: " << iterations / loops << " iterations, "
+              << time.count() / loops << "us"
+              << "  speedup: " << double(ref_time.count()) / time.count()
+              << std::endl;
+    EXPECT_LT(iterations, ref_iterations);
+    EXPECT_LT(time, ref_time);
+  };
+  run("RK2", rg_model_id(rg_model_t::REDLICH_KWONG, MODEL_SUBTYPE_DEFAULT),
+      reference_maxwell<initializeRK2, lineIntegrateRK2>);
+  run("PR ", rg_model_id(rg_model_t::PENG_ROBINSON, MODEL_SUBTYPE_DEFAULT),
+      reference_maxwell<initializePR, lineIntegratePR>);
+}
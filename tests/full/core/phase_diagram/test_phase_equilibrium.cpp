@@ -0,0 +1,115 @@
+#include "phase_equilibrium.h"
+
+#include "atherm_common.h"
+#include "gas_description.h"
+
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <memory>
+
+
+/** \brief Фазовое равновесие смеси метан - пропан - н-пентан */
+class PhaseEquilibriumTest: public ::testing::TestWithParam<rg_model_id> {
+protected:
+  PhaseEquilibriumTest() {
+    dp.reset(dyn_parameters::Init(DYNAMIC_HEAT_CAP_VOL |
+        DYNAMIC_HEAT_CAP_PRES | DYNAMIC_INTERNAL_ENERGY, 2200.0, 1700.0,
+        0.0, {0.0, 1.0e6, 300.0}));
+    c1.reset(const_parameters::Init(GAS_TYPE_METHANE, 0.0062, 4.599e6,
+        190.56, 0.286, 16.04, 0.011));
+    c3.reset(const_parameters::Init(GAS_TYPE_PROPANE, 0.004545, 4.248e6,
+        369.83, 0.276, 44.1, 0.152));
+    c5.reset(const_parameters::Init(GAS_TYPE_N_PENTANE, 0.0043, 3.37e6,
+        469.7, 0.27, 72.15, 0.251));
+    mix.insert({0.5, const_dyn_parameters(*c1, *dp)});
+    mix.insert({0.3, const_dyn_parameters(*c3, *dp)});
+    mix.insert({0.2, const_dyn_parameters(*c5, *dp)});
+    pe.reset(PhaseEquilibrium::Init(GetParam(), mix));
+  }
+
+protected:
+  std::unique_ptr<dyn_parameters> dp;
+  std::unique_ptr<const_parameters> c1, c3, c5;
+  parameters_mix mix;
+  std::unique_ptr<PhaseEquilibrium> pe;
+};
+
+TEST_P(PhaseEquilibriumTest, InitAndFugacity) {
+  ASSERT_NE(pe, nullptr);
+  ASSERT_EQ(pe->Size(), 3);
+  EXPECT_EQ(PhaseEquilibrium::Init(
+      rg_model_id(rg_model_t::REDLICH_KWONG, MODEL_SUBTYPE_DEFAULT), mix),
+      nullptr);
+  /* ln(phi_i) = d(n * ln(phi)) / dn_i */
+  const double p = 3.0e6, t = 300.0, h = 1.0e-6,
+               x[] = {0.25, 0.35, 0.4};
+  double ln_phi[3], z;
+  EXPECT_EQ(pe->LnFugacityCoefs(p, t, x, ln_phi, &z), ERROR_SUCCESS_T);
+  auto n_ln_phi = [&](const double* n) {
+    const double s = n[0] + n[1] + n[2],
+                 y[] = {n[0] / s, n[1] / s, n[2] / s};
+    double l[3];
+    pe->LnFugacityCoefs(p, t, y, l);
+    return n[0] * l[0] + n[1] * l[1] + n[2] * l[2];
+  };
+  for (size_t i = 0; i < 3; ++i) {
+    double np[] = {x[0], x[1], x[2]}, nm[] = {x[0], x[1], x[2]};
+    np[i] += h;
+    nm[i] -= h;
+    EXPECT_NEAR(ln_phi[i], (n_ln_phi(np) - n_ln_phi(nm)) / (2.0 * h),
+                1.0e-7);
+  }
+  EXPECT_EQ(pe->LnFugacityCoefs(p, t, nullptr, ln_phi), ERROR_INIT_NULLP_ST);
+}
+
+TEST_P(PhaseEquilibriumTest, Flash) {
+  ASSERT_NE(pe, nullptr);
+  const std::vector<double>& z = pe->GetComposition();
+  flash_result r;
+  bool stable;
+  /* двухфазная область: равенство летучестей и материальный баланс */
+  for (double p = 1.0e6; p < 1.0e7; p += 2.0e6) {
+    pe->ResetWarmStart();
+    EXPECT_EQ(pe->Flash(p, 300.0, &r), ERROR_SUCCESS_T);
+    EXPECT_EQ(r.phases, 2);
+    EXPECT_GT(r.vapor_fraction, 0.0);
+    EXPECT_LT(r.vapor_fraction, 1.0);
+    EXPECT_LT(r.z_liquid, r.z_vapor);
+    double ln_phi_l[3], ln_phi_v[3];
+    pe->LnFugacityCoefs(p, 300.0, r.x.data(), ln_phi_l);
+    pe->LnFugacityCoefs(p, 300.0, r.y.data(), ln_phi_v);
+    for (size_t i = 0; i < 3; ++i) {
+      EXPECT_NEAR(std::log(r.x[i]) + ln_phi_l[i],
+                  std::log(r.y[i]) + ln_phi_v[i], 1.0e-9);
+      EXPECT_NEAR(z[i], (1.0 - r.vapor_fraction) * r.x[i]
+                        + r.vapor_fraction * r.y[i], 1.0e-14);
+    }
+    EXPECT_EQ(pe->StabilityTest(p, 300.0, z.data(), &stable),
+              ERROR_SUCCESS_T);
+    EXPECT_FALSE(stable);
+  }
+  /* начальное приближение соседней точки сокращает число итераций */
+  pe->ResetWarmStart();
+  pe->Flash(5.0e6, 300.0, &r);
+  const int cold = r.iterations;
+  pe->Flash(5.05e6, 300.0, &r);
+  EXPECT_LT(r.iterations, cold);
+  /* однофазные состояния */
+  EXPECT_EQ(pe->Flash(1.0e6, 400.0, &r), ERROR_SUCCESS_T);
+  EXPECT_EQ(r.phases, 1);
+  EXPECT_EQ(r.vapor_fraction, 1.0);
+  EXPECT_EQ(r.x, z);
+  EXPECT_EQ(pe->Flash(1.2e7, 250.0, &r), ERROR_SUCCESS_T);
+  EXPECT_EQ(r.phases, 1);
+  EXPECT_EQ(r.vapor_fraction, 0.0);
+  EXPECT_EQ(pe->StabilityTest(1.0e6, 400.0, z.data(), &stable),
+            ERROR_SUCCESS_T);
+  EXPECT_TRUE(stable);
+  EXPECT_EQ(pe->Flash(1.0e6, 300.0, nullptr), ERROR_INIT_NULLP_ST);
+}
+
+INSTANTIATE_TEST_SUITE_P(CubicModels, PhaseEquilibriumTest,
+    ::testing::Values(
+        rg_model_id(rg_model_t::PENG_ROBINSON, MODEL_SUBTYPE_DEFAULT),
+        rg_model_id(rg_model_t::REDLICH_KWONG, MODEL_RK_SUBTYPE_SOAVE)));